@@ -46,8 +46,8 @@ EMSCRIPTEN_BINDINGS(CardSet)
         .function("addOrd", optional_override([](CardSet& cardSet, Ord ord) { cardSet += Card(ord); }));
 
     function("to_string", &pho::cards::to_string);
-    function("chooseThreeAtRandom", &pho::cards::chooseThreeAtRandom);
-    function("aCardAtRandom", &pho::cards::aCardAtRandom);
+    function("chooseThreeAtRandom", select_overload<CardSet(CardSet)>(&pho::cards::chooseThreeAtRandom));
+    function("aCardAtRandom", select_overload<Card(CardSet)>(&pho::cards::aCardAtRandom));
 
     register_vector<Card>("CardVector");
 }
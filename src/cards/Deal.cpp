@@ -23,7 +23,7 @@ using namespace std;
 
 using uint128_t = math::uint128_t;
 
-static uint128_t kPossibleDistinguishableDeals = math::possibleDistinguishableDeals();
+constexpr uint128_t kPossibleDistinguishableDeals = math::possibleDistinguishableDeals();
 
 Deal::Deal()
 : mDealIndex(randomDealIndex())
@@ -61,24 +61,16 @@ void validateDealUnknowns(CardSet unknowns, const CardHands& hands)
 }
 #endif
 
-uint128_t possibleDealsUnknownsToHands(CardSet unknowns, const CardHands& hands)
+uint128_t possibleDealsUnknownsToHands([[maybe_unused]] CardSet unknowns, const CardHands& hands)
 {
 #ifndef NDEBUG
     validateDealUnknowns(unknowns, hands);
 #endif
 
-    uint128_t result = 1;
-
-    unsigned D = unknowns.size();
+    std::array<unsigned, kNumPlayers> capacities;
     for (auto p : prim::range(kNumPlayers))
-    {
-        unsigned H = hands.availableCapacity(p);
-        assert(H <= D);
-        result *= math::combinations128(D, H);
-        D -= H;
-    }
-    assert(D == 0);
-    return result;
+        capacities[p] = hands.availableCapacity(p);
+    return math::multinomial(capacities);
 }
 
 void DealUnknownsToHands(CardSet unknowns, CardHands& hands)
@@ -112,6 +104,72 @@ void DealUnknownsToHands(CardSet unknowns, CardHands& hands, uint128_t index)
     }
 }
 
+namespace {
+// The shuffle of ShuffleUnknownsToHands(), taking uniformly random 64-bit values from fillRaw(out, n).
+template <typename FillRaw>
+FourHands shuffleUnknownsToHands(CardSet unknowns, const CardHands& hands, FillRaw fillRaw)
+{
+#ifndef NDEBUG
+    validateDealUnknowns(unknowns, hands);
+#endif
+
+    std::array<Ord, kCardsPerDeck> cards;
+    unsigned n = 0;
+    for (auto card : unknowns)
+        cards[n++] = card.ord();
+
+    // The hands take consecutive runs of the shuffled cards, so the run of the last hand only needs to hold the
+    // right cards, in any order. Only the positions before it are shuffled.
+    const unsigned shuffled = n - std::min<unsigned>(n, std::max<unsigned>(1, hands.availableCapacity(3)));
+
+    std::array<uint64_t, kCardsPerDeck> raw;
+    fillRaw(raw.data(), shuffled);
+    for (unsigned i = 0; i < shuffled; ++i)
+    {
+        // Swap position i with a position uniform over [i, n), by Lemire's multiply-shift with rejection.
+        const uint64_t range = n - i;
+        auto m = uint128_t{raw[i]} * range;
+        if (uint64_t(m) < range)
+        {
+            const uint64_t threshold = -range % range;
+            while (uint64_t(m) < threshold)
+            {
+                uint64_t x;
+                fillRaw(&x, 1);
+                m = uint128_t{x} * range;
+            }
+        }
+        std::swap(cards[i], cards[i + unsigned(m >> 64)]);
+    }
+
+    auto result = hands.get();
+    unsigned next = 0;
+    for (auto p : prim::range(kNumPlayers))
+    {
+        for (auto k : prim::range(hands.availableCapacity(p)))
+        {
+            (void)k;
+            result.at(p) += Card{cards[next++]};
+        }
+    }
+    assert(next == n);
+    return result;
+}
+} // namespace
+
+FourHands ShuffleUnknownsToHands(CardSet unknowns, const CardHands& hands, const math::RandomGenerator& rng)
+{
+    return shuffleUnknownsToHands(unknowns, hands, [&rng](uint64_t* out, size_t n) {
+        for (size_t i = 0; i < n; ++i)
+            out[i] = rng.random64();
+    });
+}
+
+FourHands ShuffleUnknownsToHands(CardSet unknowns, const CardHands& hands, const math::SimdRandomGenerator& rng)
+{
+    return shuffleUnknownsToHands(unknowns, hands, [&rng](uint64_t* out, size_t n) { rng.fill(out, n); });
+}
+
 void Deal::printDeal() const
 {
     for (auto p : prim::range(kNumPlayers))
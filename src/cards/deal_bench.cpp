@@ -0,0 +1,84 @@
+// deal_bench: compare random dealing by unranking a deal index with the Fisher-Yates dealer.
+//
+// Usage: deal_bench [--deals=N]
+//
+// Each scenario deals the same unknowns into the same capacities: a whole deck at the start of a game, and the
+// 30 cards unknown to the current player in the middle of one.
+
+#include "cards/Deal.hpp"
+
+#include <chrono>
+#include <fmt/format.h>
+#include <stdexcept>
+#include <string>
+
+using namespace pho;
+using namespace pho::cards;
+
+namespace {
+
+template <typename DealOnce>
+auto timeDeals(const std::string& name, uint64_t deals, DealOnce dealOnce) -> void
+{
+    auto sink = uint64_t{};
+    const auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < deals; ++i)
+        sink ^= dealOnce().at(1).asBits();
+    const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    fmt::print("{:<44} {:>8.2f} M deals/sec  (checksum {:x})\n", name, deals / seconds / 1e6, sink);
+}
+
+auto scenario(const std::string& name, uint64_t deals, CardSet unknowns, const CardHands& hands) -> void
+{
+    const auto rng = math::RandomGenerator{1};
+    const auto lanes = math::SimdRandomGenerator{1};
+
+    timeDeals(name + " DealUnknownsToHands", deals, [&] {
+        auto dealt = hands;
+        DealUnknownsToHands(unknowns, dealt, rng.range128(possibleDealsUnknownsToHands(unknowns, hands)));
+        return dealt.get();
+    });
+    timeDeals(name + " ShuffleUnknownsToHands", deals, [&] { return ShuffleUnknownsToHands(unknowns, hands, rng); });
+    timeDeals(name + " ShuffleUnknownsToHands (lanes)", deals,
+        [&] { return ShuffleUnknownsToHands(unknowns, hands, lanes); });
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        auto deals = uint64_t{1'000'000};
+        for (int i = 1; i < argc; ++i)
+        {
+            const auto arg = std::string{argv[i]};
+            if (arg.starts_with("--deals="))
+                deals = std::stoull(arg.substr(8));
+            else
+                throw std::invalid_argument(fmt::format("Unrecognized argument: {}", arg));
+        }
+
+        scenario("deck:", deals, CardSet::fullDeck(), CardHands{});
+
+        // Trick 4, player 0 to lead: player 0 holds 10 known cards, and 30 cards are unknown to them.
+        auto hands = CardHands{};
+        auto deck = CardSet::fullDeck();
+        auto known = CardSet{};
+        for (auto i = 0u; i < 10; ++i)
+            known += deck.nthCard(i * 4);
+        hands.prepCurrentPlayerForDeal(0, known);
+        for (auto p = 1u; p < kNumPlayers; ++p)
+            hands.prepForDeal(p, 10, CardSet{});
+        auto unknowns = deck - known;
+        for (auto i = 0u; i < 12; ++i)
+            unknowns -= unknowns.nthCard(unknowns.size() - 1 - i * 2);
+        scenario("mid-game:", deals, unknowns, hands);
+    }
+    catch (const std::exception& e)
+    {
+        fmt::print(stderr, "deal_bench: {}\n", e.what());
+        return 1;
+    }
+    return 0;
+}
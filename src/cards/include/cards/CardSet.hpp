@@ -8,6 +8,7 @@
 
 #include "cards/Card.hpp"
 #include "math/Bits.hpp"
+#include "math/combinatorics.hpp"
 
 namespace pho::cards {
 
@@ -231,4 +232,22 @@ protected:
     BitSetMask mCardBits;
 };
 
+// ---- Dense indexing of subsets
+
+// The colex rank of a k-card subset among all k-card subsets of the universe, in [0, C(universe.size(), k)).
+// The subset is first compressed to the universe's positions, so e.g. the passes from a 13 card hand rank 0..285
+// and the holdings of an opponent rank densely within the unseen cards.
+[[nodiscard]] inline uint64_t rankSubset(CardSet subset, CardSet universe)
+{
+    assert((subset & universe) == subset);
+    return math::rankCombination(math::extractBits(subset.asBits(), universe.asBits()));
+}
+
+// The k-card subset of the universe with the given colex rank. Requires index < C(universe.size(), k).
+[[nodiscard]] inline CardSet unrankSubset(uint64_t index, unsigned k, CardSet universe)
+{
+    const auto positions = math::unrankCombination(index, k, universe.size());
+    return CardSet{math::depositBits(positions, universe.asBits())};
+}
+
 } // namespace pho::cards
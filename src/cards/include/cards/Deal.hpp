@@ -5,6 +5,7 @@
 #include "cards/Card.hpp"
 #include "cards/CardHands.hpp"
 #include "cards/CardSet.hpp"
+#include "math/LaneGenerator.hpp"
 #include "math/math.hpp"
 #include "math/random.hpp"
 
@@ -17,6 +18,12 @@ void DealUnknownsToHands(CardSet unknowns, CardHands& hands);
 void DealUnknownsToHands(CardSet unknowns, CardHands& hands, DealIndex index);
 void validateDealUnknowns(CardSet unknowns, const CardHands& hands);
 
+// Deal the unknowns into the available capacities of the hands at random, every possible deal being equally likely,
+// and return the resulting hands. This is a partial Fisher-Yates shuffle of the unknowns, the random draws for
+// which are made in bulk, so it is much faster than DealUnknownsToHands() when the deal index is not needed.
+FourHands ShuffleUnknownsToHands(CardSet unknowns, const CardHands& hands, const math::RandomGenerator& rng);
+FourHands ShuffleUnknownsToHands(CardSet unknowns, const CardHands& hands, const math::SimdRandomGenerator& rng);
+
 class Deal
 {
 public:
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "cards/Card.hpp"
+#include "cards/CardSet.hpp"
+
+#include <array>
+#include <assert.h>
+
+namespace pho::cards {
+
+// A permutation of the four suits. It maps a card to the card of the same rank in the image of its suit, and a set of
+// cards to the set of their images.
+class SuitPermutation
+{
+public:
+    using Image = std::array<Suit, kSuitsPerDeck>;
+
+    constexpr SuitPermutation()
+    : mImage{kClubs, kDiamonds, kSpades, kHearts}
+    { }
+
+    // image[s] is the suit that suit s maps to.
+    constexpr explicit SuitPermutation(const Image& image)
+    : mImage{image}
+    {
+        assert(isPermutation(image));
+    }
+
+    constexpr auto image() const -> const Image& { return mImage; }
+
+    constexpr auto operator()(Suit suit) const -> Suit { return mImage[suit]; }
+
+    auto operator()(Card card) const -> Card
+    {
+        return card == Card{} ? card : Card::cardFor(mImage[card.suit()], card.rank());
+    }
+
+    auto operator()(CardSet cards) const -> CardSet
+    {
+        constexpr auto kSuitMask = (uint64_t{1} << kCardsPerSuit) - 1;
+        auto bits = uint64_t{};
+        for (unsigned s = 0; s < kSuitsPerDeck; ++s)
+            bits |= ((cards.asBits() >> (s * kCardsPerSuit)) & kSuitMask) << (mImage[s] * kCardsPerSuit);
+        return CardSet{bits};
+    }
+
+    constexpr auto inverse() const -> SuitPermutation
+    {
+        auto image = Image{};
+        for (unsigned s = 0; s < kSuitsPerDeck; ++s)
+            image[mImage[s]] = Suit(s);
+        return SuitPermutation{image};
+    }
+
+    // The permutation that applies this one and then `next`.
+    constexpr auto then(const SuitPermutation& next) const -> SuitPermutation
+    {
+        auto image = Image{};
+        for (unsigned s = 0; s < kSuitsPerDeck; ++s)
+            image[s] = next(mImage[s]);
+        return SuitPermutation{image};
+    }
+
+    constexpr auto isIdentity() const -> bool { return *this == SuitPermutation{}; }
+
+    friend constexpr bool operator==(const SuitPermutation& a, const SuitPermutation& b) = default;
+
+private:
+    static constexpr auto isPermutation(const Image& image) -> bool
+    {
+        auto seen = 0u;
+        for (auto suit : image)
+            seen |= unsigned(suit) < kSuitsPerDeck ? 1u << suit : 0u;
+        return seen == (1u << kSuitsPerDeck) - 1;
+    }
+
+    Image mImage;
+};
+
+} // namespace pho::cards
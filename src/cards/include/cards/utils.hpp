@@ -1,11 +1,14 @@
 #pragma once
 
 #include "cards/CardSet.hpp"
+#include "math/random.hpp"
 
 namespace pho::cards {
 
 Card aCardAtRandom(CardSet set);
+Card aCardAtRandom(CardSet set, const math::RandomGenerator& rng);
 
 CardSet chooseThreeAtRandom(CardSet dealt);
+CardSet chooseThreeAtRandom(CardSet dealt, const math::RandomGenerator& rng);
 
 } // namespace pho::cards
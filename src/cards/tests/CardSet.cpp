@@ -93,4 +93,34 @@ TEST(CardSet, range_for)
     EXPECT_EQ(it, cards.end());
 }
 
+TEST(CardSet, rank_subset_within_universe)
+{
+    const auto hand = CardSet::make({2, 5, 11, 17, 20, 23, 30, 31, 38, 40, 44, 47, 50});
+    auto seen = std::vector<bool>(286);
+    for (auto a : hand)
+    {
+        for (auto b : hand)
+        {
+            for (auto c : hand)
+            {
+                if (!(a < b && b < c))
+                    continue;
+                const auto passed = CardSet::make({a, b, c});
+                const auto rank = rankSubset(passed, hand);
+                ASSERT_LT(rank, 286u);
+                EXPECT_FALSE(seen[rank]);
+                seen[rank] = true;
+                EXPECT_EQ(unrankSubset(rank, 3, hand), passed);
+            }
+        }
+    }
+
+    // The rank only depends on the positions within the universe.
+    const auto lowHand = CardSet{(uint64_t{1} << 13) - 1};
+    EXPECT_EQ(rankSubset(CardSet::make({2, 17, 50}), hand), rankSubset(CardSet::make({0, 3, 12}), lowHand));
+    EXPECT_EQ(rankSubset(hand, hand), 0u);
+    EXPECT_EQ(unrankSubset(0, 13, hand), hand);
+    EXPECT_EQ(rankSubset(CardSet{}, CardSet::fullDeck()), 0u);
+}
+
 } // namespace pho::cards::tests
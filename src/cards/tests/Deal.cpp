@@ -4,6 +4,8 @@
 #include "math/combinatorics.hpp"
 #include "prim/range.hpp"
 
+#include <map>
+
 namespace pho::cards::tests {
 
 void dealIsValid(Deal deal)
@@ -127,4 +129,78 @@ TEST(Deal, hypotheticalForDealtHand)
     }
 }
 
+namespace {
+auto capacities(std::array<CardHands::Size_t, kNumPlayers> available) -> CardHands
+{
+    auto hands = CardHands{};
+    for (auto p : prim::range(kNumPlayers))
+        hands.prepForDeal(p, available[p], CardSet{});
+    return hands;
+}
+} // namespace
+
+TEST(Deal, shuffleUnknownsToHands)
+{
+    const auto rng = math::RandomGenerator{3};
+    const auto lanes = math::SimdRandomGenerator{3};
+    for (int i = 0; i < 100; ++i)
+    {
+        // A whole deck, as at the start of a game
+        const auto full = i % 2 ? ShuffleUnknownsToHands(CardSet::fullDeck(), CardHands{}, rng)
+                                : ShuffleUnknownsToHands(CardSet::fullDeck(), CardHands{}, lanes);
+        auto combined = CardSet{};
+        for (auto p : prim::range(kNumPlayers))
+        {
+            EXPECT_EQ(full.at(p).size(), kCardsPerHand);
+            EXPECT_TRUE(combined.setIntersection(full.at(p)).empty());
+            combined += full.at(p);
+        }
+        EXPECT_EQ(combined, CardSet::fullDeck());
+
+        // Mid-game: player 1 holds known cards, and the others have differing capacities.
+        auto hands = capacities({5, 0, 4, 4});
+        const auto known = CardSet::fullDeck().cardsWithSuit(kClubs);
+        hands.prepCurrentPlayerForDeal(1, known);
+        const auto unknowns = CardSet::fullDeck().cardsWithSuit(kHearts);
+        const auto midGame = ShuffleUnknownsToHands(unknowns, hands, lanes);
+        EXPECT_EQ(midGame.at(0).size(), 5u);
+        EXPECT_EQ(midGame.at(1), known);
+        EXPECT_EQ(midGame.at(2).size(), 4u);
+        EXPECT_EQ(midGame.at(3).size(), 4u);
+        EXPECT_EQ(midGame.at(0) + midGame.at(2) + midGame.at(3), unknowns);
+    }
+}
+
+TEST(Deal, shuffleUnknownsToHandsIsUniform)
+{
+    // Six cards into available capacities 2, 2, 1, 1 can be dealt 6!/(2!2!1!1!) = 180 ways.
+    const auto hands = capacities({2, 2, 1, 1});
+    auto unknowns = CardSet{};
+    for (Ord ord : {0, 7, 13, 20, 40, 51})
+        unknowns += Card{ord};
+    ASSERT_EQ(possibleDealsUnknownsToHands(unknowns, hands), 180u);
+
+    auto expectUniform = [&](auto&& deal) {
+        constexpr int kPerDeal = 400;
+        auto counts = std::map<std::array<uint64_t, 3>, int>{};
+        for (int i = 0; i < 180 * kPerDeal; ++i)
+        {
+            const auto dealt = deal();
+            ++counts[{dealt.at(0).asBits(), dealt.at(1).asBits(), dealt.at(2).asBits()}];
+        }
+        ASSERT_EQ(counts.size(), 180u);
+
+        // Pearson's chi-squared statistic has 179 degrees of freedom: mean 179 and standard deviation about 19.
+        auto chiSquared = 0.0;
+        for (const auto& [key, count] : counts)
+            chiSquared += (count - kPerDeal) * (count - kPerDeal) / double(kPerDeal);
+        EXPECT_LT(chiSquared, 179 + 5 * 19);
+    };
+
+    const auto rng = math::RandomGenerator{11};
+    const auto lanes = math::SimdRandomGenerator{11};
+    expectUniform([&] { return ShuffleUnknownsToHands(unknowns, hands, rng); });
+    expectUniform([&] { return ShuffleUnknownsToHands(unknowns, hands, lanes); });
+}
+
 } // namespace pho::cards::tests
@@ -4,9 +4,16 @@
 
 namespace pho::cards {
 
-Card aCardAtRandom(CardSet set) { return set.nthCard(pho::math::RandomGenerator::Range64(set.size())); }
+Card aCardAtRandom(CardSet set) { return aCardAtRandom(set, pho::math::RandomGenerator::ThreadSpecific()); }
+
+Card aCardAtRandom(CardSet set, const math::RandomGenerator& rng) { return set.nthCard(rng.range64(set.size())); }
 
 CardSet chooseThreeAtRandom(CardSet dealt)
+{
+    return chooseThreeAtRandom(dealt, math::RandomGenerator::ThreadSpecific());
+}
+
+CardSet chooseThreeAtRandom(CardSet dealt, const math::RandomGenerator& rng)
 {
     auto tmp = dealt;
     assert(tmp.size() == 13);
@@ -14,7 +21,7 @@ CardSet chooseThreeAtRandom(CardSet dealt)
     for (auto i : pho::prim::range(3))
     {
         (void)i;
-        auto card = aCardAtRandom(tmp);
+        auto card = aCardAtRandom(tmp, rng);
         result += card;
         tmp -= card;
     }
@@ -0,0 +1,385 @@
+#include "gstate/BeliefState.hpp"
+
+#include "math/combinatorics.hpp"
+
+#include <algorithm>
+
+namespace pho::gstate {
+
+namespace {
+// The capacities index the table of ways in steps of one more than the largest hand.
+constexpr unsigned kStride = kCardsPerHand + 1;
+constexpr unsigned kSuitStride = kStride * kStride * kStride;
+
+auto totalWeightOf(const std::vector<Particle>& particles) -> double
+{
+    auto total = 0.0;
+    for (const auto& particle : particles)
+        total += particle.weight;
+    return total;
+}
+
+auto effectiveSizeOf(const std::vector<Particle>& particles) -> double
+{
+    auto total = 0.0;
+    auto squares = 0.0;
+    for (const auto& particle : particles)
+    {
+        total += particle.weight;
+        squares += particle.weight * particle.weight;
+    }
+    return squares == 0.0 ? 0.0 : total * total / squares;
+}
+
+// Scale the weights to sum to `total`.
+auto scaleWeights(std::vector<Particle>& particles, double total) -> void
+{
+    const auto current = totalWeightOf(particles);
+    if (current == 0.0)
+        return;
+    for (auto& particle : particles)
+        particle.weight *= total / current;
+}
+} // namespace
+
+WorldSampler::WorldSampler(const GState& state, PlayerNum observer)
+: WorldSampler{KnowableState{state, observer}}
+{ }
+
+WorldSampler::WorldSampler(const KnowableState& known)
+: mKnown{}
+, mOthers{}
+, mCapacities{}
+, mUnknown{}
+, mAllowed{}
+, mWays((kSuitsPerDeck + 1) * kSuitStride)
+{
+    const auto observer = known.seat();
+    // The receiver of the observer's pass still holds every passed card that has not been played.
+    for (auto p : prim::range(kNumPlayers))
+        mKnown.at(p) = known.knownHand(p);
+    const auto unknown = known.unknownCards();
+
+    const auto voids = known.playerVoids();
+    for (auto j : prim::range(kOthers))
+    {
+        mOthers[j] = (observer + 1 + j) % kNumPlayers;
+        mCapacities[j] = known.handSize(mOthers[j]) - mKnown.at(mOthers[j]).size();
+    }
+    for (auto suit : allSuits)
+    {
+        mUnknown[suit] = unknown.cardsWithSuit(suit);
+        for (auto j : prim::range(kOthers))
+            mAllowed[suit] |= voids.isVoid(mOthers[j], suit) ? 0u : 1u << j;
+    }
+
+    ways(kSuitsPerDeck, Capacities{}) = 1.0;
+    for (auto suit = kSuitsPerDeck; suit-- > 0;)
+    {
+        auto capacities = Capacities{};
+        for (capacities[0] = 0; capacities[0] <= mCapacities[0]; ++capacities[0])
+            for (capacities[1] = 0; capacities[1] <= mCapacities[1]; ++capacities[1])
+                for (capacities[2] = 0; capacities[2] <= mCapacities[2]; ++capacities[2])
+                {
+                    auto total = 0.0;
+                    forEachSplit(suit, capacities, [&total](const Capacities&, double ways) {
+                        total += ways;
+                        return false;
+                    });
+                    ways(suit, capacities) = total;
+                }
+    }
+
+    if (worlds() == 0.0)
+        throw std::runtime_error("No world is consistent with the observer's knowledge");
+}
+
+auto WorldSampler::ways(unsigned suit, const Capacities& capacities) const -> double
+{
+    return mWays[suit * kSuitStride + (capacities[0] * kStride + capacities[1]) * kStride + capacities[2]];
+}
+
+auto WorldSampler::ways(unsigned suit, const Capacities& capacities) -> double&
+{
+    return mWays[suit * kSuitStride + (capacities[0] * kStride + capacities[1]) * kStride + capacities[2]];
+}
+
+template <typename Visit>
+auto WorldSampler::forEachSplit(unsigned suit, const Capacities& capacities, Visit visit) const -> void
+{
+    const auto cards = mUnknown[suit].size();
+    const auto allowed = mAllowed[suit];
+    const auto most = [&](unsigned j, unsigned left) {
+        return (allowed & (1u << j)) != 0 ? std::min(capacities[j], left) : 0u;
+    };
+
+    auto split = Capacities{};
+    for (split[0] = 0; split[0] <= most(0, cards); ++split[0])
+    {
+        for (split[1] = 0; split[1] <= most(1, cards - split[0]); ++split[1])
+        {
+            split[2] = cards - split[0] - split[1];
+            if (split[2] > most(2, split[2]) || split[2] > capacities[2])
+                continue;
+            const auto rest = Capacities{capacities[0] - split[0], capacities[1] - split[1], capacities[2] - split[2]};
+            const auto later = ways(suit + 1, rest);
+            if (later == 0.0)
+                continue;
+            if (visit(split, double(math::multinomial(split)) * later))
+                return;
+        }
+    }
+}
+
+auto WorldSampler::operator()(const math::RandomGenerator& rng) const -> FourHands
+{
+    auto hands = mKnown;
+    auto capacities = mCapacities;
+    for (auto suit : prim::range(kSuitsPerDeck))
+    {
+        // Choose how many cards of the suit each player gets in proportion to the worlds that follow.
+        auto target = rng.randNorm() * ways(suit, capacities);
+        auto chosen = Capacities{};
+        forEachSplit(suit, capacities, [&](const Capacities& split, double ways) {
+            chosen = split;
+            target -= ways;
+            return target < 0.0;
+        });
+
+        auto cards = mUnknown[suit];
+        for (auto j : prim::range(kOthers))
+        {
+            for (auto k : prim::range(chosen[j]))
+            {
+                (void)k;
+                const auto card = cards.nthCard(unsigned(rng.range64(cards.size())));
+                cards -= card;
+                hands.at(mOthers[j]) += card;
+            }
+            capacities[j] -= chosen[j];
+        }
+        assert(cards.empty());
+    }
+    return hands;
+}
+
+BeliefState::BeliefState(const GState& state, PlayerNum observer, const BeliefConfig& config,
+    const math::RandomGenerator& rng, PlayLikelihood likelihood)
+: mObserver{observer}
+, mConfig{config}
+, mRng{rng.random64()}
+, mLikelihood{std::move(likelihood)}
+, mLast{state}
+, mHistory{}
+, mParticles{}
+, mStats{}
+{
+    mParticles.reserve(mConfig.particles);
+    refill(state);
+}
+
+auto BeliefState::totalWeight() const -> double { return totalWeightOf(mParticles); }
+
+auto BeliefState::effectiveSampleSize() const -> double { return effectiveSizeOf(mParticles); }
+
+auto BeliefState::playsSince(const GState& state) const -> std::vector<Card>
+{
+    const auto count = state.playIndex() - mLast.playIndex();
+    auto recent = std::vector<Card>{};
+    if (state.playIndex() >= state.playInTrick() + GState::kPlaysPerTrick)
+    {
+        const auto prior = state.priorTrick();
+        for (auto i : prim::range(GState::kPlaysPerTrick))
+            recent.push_back(prior.getTrickPlay(i));
+    }
+    for (auto i : prim::range(state.playInTrick()))
+        recent.push_back(state.getTrickPlay(i));
+
+    if (state.playIndex() < mLast.playIndex() || count > recent.size())
+    {
+        throw std::invalid_argument(fmt::format(
+            "Cannot update a belief from play {} to play {}; it must be updated at least once a trick",
+            mLast.playIndex(),
+            state.playIndex()));
+    }
+    return {recent.end() - count, recent.end()};
+}
+
+auto BeliefState::update(const GState& state) -> void
+{
+    for (auto card : playsSince(state))
+    {
+        observe(mLast, card);
+        mLast.playCardUnchecked(card);
+    }
+    mLast = state;
+
+    auto voidCards = FourHands{};
+    const auto voids = state.playerVoids();
+    for (auto p : prim::range(kNumPlayers))
+    {
+        for (auto suit : allSuits)
+        {
+            if (p != mObserver && voids.isVoid(p, suit))
+                voidCards.at(p) += CardSet{CardSet::maskOfSuit(suit)};
+        }
+    }
+
+    const auto hand = state.playersHand(mObserver);
+    auto kept = size_t{};
+    for (auto& particle : mParticles)
+    {
+        auto consistent = true;
+        for (auto p : prim::range(kNumPlayers))
+            consistent = consistent && (particle.hands.at(p) & voidCards.at(p)).empty();
+        if (!consistent)
+            continue;
+        particle.hands.at(mObserver) = hand;
+        mParticles[kept++] = particle;
+    }
+    mStats.rejected += mParticles.size() - kept;
+    mParticles.erase(mParticles.begin() + kept, mParticles.end());
+
+    if (mParticles.empty() || double(mParticles.size()) < mConfig.refillBelow * double(mConfig.particles))
+        refill(state);
+    if (mParticles.empty())
+    {
+        // The likelihood rules out every world, so some player has strayed from the model. Start over from the worlds
+        // consistent with the cards alone, and weigh only the plays from here on.
+        mHistory.clear();
+        refill(state);
+        ++mStats.resets;
+    }
+    scaleWeights(mParticles, double(mParticles.size()));
+    if (effectiveSampleSize() < mConfig.resampleBelow * double(mParticles.size()))
+        resample();
+}
+
+auto BeliefState::observe(const GState& before, Card card) -> void
+{
+    const auto player = before.currentPlayer();
+    if (player == mObserver)
+        return;
+
+    // Drop the worlds in which the player did not hold the card, or did not have to play it off suit.
+    const auto follow = before.playInTrick() == 0 || suitOf(card) == before.currentTrick().trickSuit()
+        ? CardSet{}
+        : CardSet{CardSet::maskOfSuit(before.currentTrick().trickSuit())};
+    auto kept = size_t{};
+    for (auto& particle : mParticles)
+    {
+        const auto held = particle.hands.at(player);
+        if (held.hasCard(card) && (held & follow).empty())
+            mParticles[kept++] = particle;
+    }
+    mStats.rejected += mParticles.size() - kept;
+    mParticles.erase(mParticles.begin() + kept, mParticles.end());
+
+    if (mLikelihood)
+    {
+        if (!mParticles.empty())
+        {
+            auto hands = std::vector<CardSet>{};
+            hands.reserve(mParticles.size());
+            for (const auto& particle : mParticles)
+                hands.push_back(particle.hands.at(player));
+            reweight(mLikelihood(before, card, hands));
+            ++mStats.likelihoodBatches;
+        }
+        mHistory.push_back(Observed{before, card});
+    }
+
+    for (auto& particle : mParticles)
+        particle.hands.at(player) -= card;
+}
+
+auto BeliefState::reweight(const std::vector<double>& likelihoods) -> void
+{
+    assert(likelihoods.size() == mParticles.size());
+    auto kept = size_t{};
+    for (auto i : prim::range(mParticles.size()))
+    {
+        mParticles[i].weight *= likelihoods[i];
+        if (mParticles[i].weight > 0.0)
+            mParticles[kept++] = mParticles[i];
+    }
+    mStats.rejected += mParticles.size() - kept;
+    mParticles.erase(mParticles.begin() + kept, mParticles.end());
+}
+
+auto BeliefState::resample() -> void
+{
+    // Systematic resampling: one uniform offset, then evenly spaced pointers into the cumulative weights.
+    const auto count = mConfig.particles;
+    const auto step = totalWeight() / double(count);
+    auto pointer = mRng.randNorm() * step;
+    auto cumulative = 0.0;
+    auto resampled = std::vector<Particle>{};
+    resampled.reserve(count);
+    for (const auto& particle : mParticles)
+    {
+        cumulative += particle.weight;
+        for (; pointer < cumulative && resampled.size() < count; pointer += step)
+            resampled.push_back(Particle{particle.hands, 1.0});
+    }
+    while (resampled.size() < count)
+        resampled.push_back(Particle{mParticles.back().hands, 1.0});
+    mParticles = std::move(resampled);
+    ++mStats.resamples;
+}
+
+auto BeliefState::sample(const math::RandomGenerator& rng) const -> const FourHands&
+{
+    assert(!mParticles.empty());
+    auto target = rng.randNorm() * totalWeight();
+    for (const auto& particle : mParticles)
+    {
+        target -= particle.weight;
+        if (target < 0.0)
+            return particle.hands;
+    }
+    return mParticles.back().hands;
+}
+
+auto BeliefState::refill(const GState& state) -> void
+{
+    const auto sampler = WorldSampler{state, mObserver};
+    auto fresh = std::vector<Particle>{};
+    while (mParticles.size() + fresh.size() < mConfig.particles)
+    {
+        fresh.push_back(Particle{sampler(mRng), 1.0});
+        ++mStats.sampled;
+    }
+
+    if (mLikelihood)
+    {
+        // The fresh worlds are uniform over the consistent worlds, so each needs the likelihood of every play so far.
+        // A player's hand before a play is their hand now plus the cards they have played since.
+        for (const auto& [before, card] : mHistory)
+        {
+            const auto player = before.currentPlayer();
+            const auto since = state.playedBy(player) - before.playedBy(player);
+            auto hands = std::vector<CardSet>{};
+            hands.reserve(fresh.size());
+            for (const auto& particle : fresh)
+                hands.push_back(particle.hands.at(player) + since);
+            const auto likelihoods = mLikelihood(before, card, hands);
+            ++mStats.likelihoodBatches;
+            for (auto i : prim::range(fresh.size()))
+                fresh[i].weight *= likelihoods[i];
+        }
+
+        const auto ruledOut = [](const Particle& particle) { return particle.weight == 0.0; };
+        const auto unlikely = std::remove_if(fresh.begin(), fresh.end(), ruledOut);
+        mStats.rejected += uint64_t(fresh.end() - unlikely);
+        fresh.erase(unlikely, fresh.end());
+
+        // The survivors and the fresh worlds each estimate the same belief, so each set is given weight in proportion
+        // to the number of equally weighted worlds it is worth.
+        scaleWeights(mParticles, effectiveSizeOf(mParticles));
+        scaleWeights(fresh, effectiveSizeOf(fresh));
+    }
+    mParticles.insert(mParticles.end(), fresh.begin(), fresh.end());
+}
+
+} // namespace pho::gstate
@@ -0,0 +1,454 @@
+#include "gstate/Endgame.hpp"
+#include "prim/hash.hpp"
+
+#include <climits>
+#include <cstring>
+
+namespace pho::gstate {
+
+namespace {
+constexpr auto kQueenOfSpades = Card::cardFor(kSpades, kQueen);
+constexpr auto kJackOfDiamonds = Card::cardFor(kDiamonds, kJack);
+constexpr auto kHeartsMask = CardSet::maskOfSuit(kHearts);
+constexpr auto kSpadesMask = CardSet::maskOfSuit(kSpades);
+constexpr auto kTotalPoints = 26;
+constexpr auto kShootPoints = 13;
+constexpr auto kJackPoints = 10;
+
+// The points-so-far classes. A class of 1 + p means that only player p has taken points.
+constexpr uint8_t kNoPoints = 0;
+constexpr uint8_t kSplitPoints = 1 + kNumPlayers;
+
+// The order of a card that is not in play.
+constexpr uint64_t kNoOrder = 31;
+
+auto suitMask(Suit suit) -> uint64_t { return CardSet::maskOfSuit(suit); }
+
+auto cardOf(uint64_t mask) -> Card { return Card{Ord(math::leastSetBitIndex(mask))}; }
+
+auto unionOf(const std::array<uint64_t, kNumPlayers>& hands) -> uint64_t
+{
+    return hands[0] | hands[1] | hands[2] | hands[3];
+}
+
+// The standard points of the cards, which decide a shoot of the moon.
+auto pointsOf(uint64_t cards) -> unsigned
+{
+    return math::countBits(cards & kHeartsMask) + ((cards & kQueenOfSpades.mask()) != 0 ? kShootPoints : 0);
+}
+
+// The order of the card among the cards of its suit in `live`, which must include it.
+auto orderOf(uint64_t live, Card card) -> uint64_t
+{
+    return math::countBits(live & suitMask(suitOf(card)) & (card.mask() - 1));
+}
+
+auto canonicalCard(uint64_t live, Card card) -> uint8_t { return uint8_t(suitOf(card) << 4 | orderOf(live, card)); }
+
+auto actualCard(uint64_t live, uint8_t code) -> Card
+{
+    return cardOf(math::depositBits(uint64_t{1} << (code & 0xf), live & suitMask(Suit(code >> 4))));
+}
+
+auto relativeSeat(PlayerNum seat, PlayerNum lead) -> uint8_t
+{
+    return uint8_t((seat + kNumPlayers - lead) % kNumPlayers);
+}
+
+auto keyOf(const std::array<uint64_t, kNumPlayers>& hands, PlayerNum lead, bool broken, uint8_t points,
+    GameVariant variant) -> EndgameKey
+{
+    const auto live = unionOf(hands);
+    auto lo = uint64_t{};
+    auto shift = 5 * kSuitsPerDeck;
+    for (auto suit : allSuits)
+    {
+        const auto cards = live & suitMask(suit);
+        lo |= uint64_t{math::countBits(cards)} << (5 * suit);
+        for (auto bits = cards; bits != 0; bits &= bits - 1)
+        {
+            const auto card = bits & -bits;
+            auto seat = PlayerNum{};
+            while ((hands[seat] & card) == 0)
+                ++seat;
+            lo |= uint64_t{relativeSeat(seat, lead)} << shift;
+            shift += 2;
+        }
+    }
+
+    const auto relativePoints = points == kNoPoints || points == kSplitPoints
+        ? points
+        : uint8_t(1 + relativeSeat(points - 1, lead));
+    const auto queen = variant != spades && (live & kQueenOfSpades.mask()) != 0 ? orderOf(live, kQueenOfSpades)
+                                                                                 : kNoOrder;
+    const auto jack = variant == GameVariant::jack && (live & kJackOfDiamonds.mask()) != 0
+        ? orderOf(live, kJackOfDiamonds)
+        : kNoOrder;
+    const auto hi = uint64_t{1} << 63 | relativePoints | uint64_t{broken} << 3 | queen << 4 | jack << 9;
+    return EndgameKey{lo, hi};
+}
+
+auto toRelative(EndgameValue value, PlayerNum lead) -> EndgameValue
+{
+    auto relative = value;
+    for (auto seat : prim::range(kNumPlayers))
+        relative.taken[relativeSeat(seat, lead)] = value.taken[seat];
+    if (value.tookJack != kNumPlayers)
+        relative.tookJack = relativeSeat(value.tookJack, lead);
+    return relative;
+}
+
+auto fromRelative(EndgameValue value, PlayerNum lead) -> EndgameValue
+{
+    auto actual = value;
+    for (auto seat : prim::range(kNumPlayers))
+        actual.taken[seat] = value.taken[relativeSeat(seat, lead)];
+    if (value.tookJack != kNumPlayers)
+        actual.tookJack = uint8_t((value.tookJack + lead) % kNumPlayers);
+    return actual;
+}
+
+auto slotOf(const EndgameKey& key, uint64_t mask) -> uint64_t
+{
+    return prim::mix64(key.lo ^ prim::mix64(key.hi)) & mask;
+}
+
+// The slot holding the key, or the empty slot where it belongs. The table must have an empty slot.
+auto probe(const EndgameEntry* entries, uint64_t capacity, const EndgameKey& key) -> uint64_t
+{
+    const auto mask = capacity - 1;
+    auto slot = slotOf(key, mask);
+    while (entries[slot].key.hi != 0 && entries[slot].key != key)
+        slot = (slot + 1) & mask;
+    return slot;
+}
+
+#if !__EMSCRIPTEN__
+auto readHeader(const prim::MappedFile& file) -> EndgameTableHeader
+{
+    const auto& header = file.header<EndgameTableHeader>("an endgame table");
+    if (header.entrySize != sizeof(EndgameEntry))
+        throw std::runtime_error(fmt::format("Endgame table {} has an unsupported layout: entries of {} bytes, not {}",
+            file.path(), header.entrySize, sizeof(EndgameEntry)));
+    if (header.capacity == 0 || (header.capacity & (header.capacity - 1)) != 0 || header.count >= header.capacity)
+        throw std::runtime_error(fmt::format("Endgame table {} has a bad capacity", file.path()));
+    file.expectSize(sizeof(EndgameTableHeader) + header.capacity * sizeof(EndgameEntry));
+    return header;
+}
+#endif
+} // namespace
+
+EndgameTable::EndgameTable(GameVariant variant, uint64_t capacity)
+: mVariant{variant}
+, mCount{0}
+, mEntries(math::roundUpToPowerOfTwo(std::max<uint64_t>(capacity, 16)))
+{ }
+
+auto EndgameTable::find(const EndgameKey& key) const -> const EndgameValue*
+{
+    const auto& entry = mEntries[probe(mEntries.data(), mEntries.size(), key)];
+    return entry.key.hi != 0 ? &entry.value : nullptr;
+}
+
+auto EndgameTable::insert(const EndgameKey& key, const EndgameValue& value) -> void
+{
+    assert(key.hi != 0);
+    if (2 * (mCount + 1) > mEntries.size())
+        grow();
+    auto& entry = mEntries[probe(mEntries.data(), mEntries.size(), key)];
+    if (entry.key.hi == 0)
+        ++mCount;
+    entry = EndgameEntry{key, value, {}};
+}
+
+auto EndgameTable::insertAll(const MappedEndgameTable& table) -> void
+{
+    if (table.variant() != mVariant)
+        throw std::invalid_argument("The endgame tables are for different variants");
+    for (auto slot : prim::range(table.capacity()))
+    {
+        const auto& entry = table.entries()[slot];
+        if (entry.key.hi != 0)
+            insert(entry.key, entry.value);
+    }
+}
+
+auto EndgameTable::grow() -> void
+{
+    auto entries = std::vector<EndgameEntry>(2 * mEntries.size());
+    for (const auto& entry : mEntries)
+    {
+        if (entry.key.hi != 0)
+            entries[probe(entries.data(), entries.size(), entry.key)] = entry;
+    }
+    mEntries.swap(entries);
+}
+
+#if !__EMSCRIPTEN__
+auto EndgameTable::save(const std::string& path) const -> void
+{
+    auto header = EndgameTableHeader{};
+    std::memcpy(header.magic, EndgameTableHeader::kMagic, sizeof(header.magic));
+    header.version = EndgameTableHeader::kVersion;
+    header.headerSize = sizeof(EndgameTableHeader);
+    header.entrySize = sizeof(EndgameEntry);
+    header.variant = uint32_t(mVariant);
+    header.capacity = mEntries.size();
+    header.count = mCount;
+    header.checksum = prim::hash64(mEntries.data(), mEntries.size() * sizeof(EndgameEntry));
+
+    auto file = prim::AtomicFileWriter{path};
+    file.write(&header, sizeof(header));
+    file.write(mEntries.data(), mEntries.size() * sizeof(EndgameEntry));
+    file.commit();
+}
+
+MappedEndgameTable::MappedEndgameTable(const std::string& path, bool verifyChecksum)
+: mFile{path, prim::MappedFile::eRandom} // each lookup hashes to an unrelated slot
+, mHeader{readHeader(mFile)}
+, mEntries{reinterpret_cast<const EndgameEntry*>(mFile.data() + sizeof(EndgameTableHeader))}
+{
+    if (verifyChecksum && prim::hash64(mEntries, mHeader.capacity * sizeof(EndgameEntry)) != mHeader.checksum)
+        throw std::runtime_error(fmt::format("Endgame table {} failed checksum", path));
+}
+#endif
+
+auto MappedEndgameTable::find(const EndgameKey& key) const -> const EndgameValue*
+{
+    const auto& entry = mEntries[probe(mEntries, mHeader.capacity, key)];
+    return entry.key.hi != 0 ? &entry.value : nullptr;
+}
+
+// A position during the search: the hands and the trick in progress, with what the players' choices depend on.
+struct EndgameSolver::Node
+{
+    std::array<uint64_t, kNumPlayers> hands;
+    std::array<Card, kNumPlayers> plays; // by seat
+    PlayerNum lead;
+    bool broken;
+    uint8_t points; // the points-so-far class before this trick
+
+    // The points taken before this trick, when a shoot of the moon is still possible.
+    std::array<int, kNumPlayers> tally;
+    bool moonPossible;
+};
+
+EndgameSolver::EndgameSolver(GameVariant variant, const MappedEndgameTable* persisted)
+: mVariant{variant}
+, mPointCards{GameBehavior::make(variant).pointCards().asBits()}
+, mPersisted{persisted}
+, mMemo{variant}
+, mStats{}
+{
+    if (persisted != nullptr && persisted->variant() != variant)
+        throw std::invalid_argument("The persisted endgame table is for another variant");
+}
+
+auto EndgameSolver::canSolve(const GState& state) -> bool
+{
+    return state.gameStarted() && !state.done()
+        && state.playIndex() >= kCardsPerDeck - kMaxEndgameTricks * kCardsPerTrick;
+}
+
+auto EndgameSolver::bestPlay(const GState& state) -> Card
+{
+    assert(canSolve(state));
+    assert(state.behavior().variant() == mVariant);
+
+    auto node = Node{};
+    for (auto p : prim::range(kNumPlayers))
+    {
+        node.hands[p] = state.playersHand(p).asBits();
+        node.plays[p] = state.currentTrick().at(p);
+    }
+    node.lead = state.trickLead();
+    node.broken = !(state.allTaken() & CardSet{mPointCards}).empty();
+    node.points = kNoPoints;
+    if (mVariant != spades)
+    {
+        const auto& tally = state.tally();
+        for (auto p : prim::range(kNumPlayers))
+        {
+            node.tally[p] = tally.points[p];
+            if (tally.points[p] != 0)
+                node.points = node.points == kNoPoints ? uint8_t(1 + p) : kSplitPoints;
+        }
+        node.moonPossible = node.points != kSplitPoints;
+    }
+
+    auto best = Card{};
+    if (state.playInTrick() == 0)
+        solveBoundary(node.hands, node.lead, node.broken, node.points, &best);
+    else
+        searchTrick(node, state.playInTrick(), &best);
+    assert(state.legalPlays().hasCard(best));
+    return best;
+}
+
+auto EndgameSolver::solve(GState& state) -> void
+{
+    while (!state.done())
+        state.playCard(bestPlay(state));
+}
+
+auto EndgameSolver::outcome(const GState& state) -> GState::Outcome
+{
+    auto solved = state;
+    solve(solved);
+    return solved.outcome();
+}
+
+auto EndgameSolver::solveBoundary(const std::array<uint64_t, kNumPlayers>& hands, PlayerNum lead, bool broken,
+    uint8_t points, Card* best) -> EndgameValue
+{
+    const auto live = unionOf(hands);
+    if (live == 0)
+        return EndgameValue{{}, kNumPlayers, 0};
+
+    const auto key = keyOf(hands, lead, broken, points, mVariant);
+    const auto* found = mPersisted != nullptr ? mPersisted->find(key) : nullptr;
+    if (found != nullptr)
+        ++mStats.persistedHits;
+    else if ((found = mMemo.find(key)) != nullptr)
+        ++mStats.memoHits;
+    if (found != nullptr)
+    {
+        if (best != nullptr)
+            *best = actualCard(live, found->best);
+        return fromRelative(*found, lead);
+    }
+
+    auto node = Node{hands, {}, lead, broken, points, {}, mVariant != spades && points != kSplitPoints};
+    if (points != kNoPoints && points != kSplitPoints)
+        node.tally[points - 1] = kTotalPoints - pointsOf(live);
+
+    auto leadCard = Card{};
+    const auto value = searchTrick(node, 0, &leadCard);
+    ++mStats.solved;
+
+    auto stored = toRelative(value, lead);
+    stored.best = canonicalCard(live, leadCard);
+    mMemo.insert(key, stored);
+    if (best != nullptr)
+        *best = leadCard;
+    return value;
+}
+
+auto EndgameSolver::searchTrick(Node& node, unsigned play, Card* best) -> EndgameValue
+{
+    if (play == kCardsPerTrick)
+        return finishTrick(node);
+
+    const auto player = PlayerNum((node.lead + play) % kNumPlayers);
+    const auto hand = node.hands[player];
+    auto legal = hand;
+    if (play == 0)
+    {
+        if (!node.broken && (hand & ~mPointCards) != 0)
+            legal = hand & ~mPointCards;
+    }
+    else
+    {
+        const auto follow = hand & suitMask(suitOf(node.plays[node.lead]));
+        if (follow != 0)
+            legal = follow;
+    }
+
+    auto live = unionOf(node.hands);
+    for (auto card : node.plays)
+    {
+        if (card != Card{})
+            live |= card.mask();
+    }
+
+    // A card worth the same as the next lower card in play of its suit, held by the same player, plays the same.
+    const auto worth = [this](uint64_t card) {
+        if (mVariant == spades)
+            return 0;
+        if (mVariant == GameVariant::jack && card == kJackOfDiamonds.mask())
+            return -kJackPoints;
+        return int(pointsOf(card));
+    };
+
+    auto bestValue = EndgameValue{};
+    auto bestCost = INT_MAX;
+    auto bestCard = Card{};
+    for (auto bits = legal; bits != 0; bits &= bits - 1)
+    {
+        const auto mask = bits & -bits;
+        const auto card = cardOf(mask);
+        const auto below = live & suitMask(suitOf(card)) & (mask - 1);
+        if (below != 0 && (hand & math::isolateGreatestBit(below)) != 0
+            && worth(math::isolateGreatestBit(below)) == worth(mask))
+            continue;
+
+        node.hands[player] = hand & ~mask;
+        node.plays[player] = card;
+        const auto value = searchTrick(node, play + 1, nullptr);
+        const auto playerCost = cost(node, value, player);
+        if (playerCost < bestCost)
+        {
+            bestCost = playerCost;
+            bestValue = value;
+            bestCard = card;
+        }
+    }
+    node.hands[player] = hand;
+    node.plays[player] = Card{};
+
+    if (best != nullptr)
+        *best = bestCard;
+    return bestValue;
+}
+
+auto EndgameSolver::finishTrick(const Node& node) -> EndgameValue
+{
+    auto trick = uint64_t{};
+    for (auto card : node.plays)
+        trick |= card.mask();
+
+    auto suit = suitOf(node.plays[node.lead]);
+    if (mVariant == spades && (trick & kSpadesMask) != 0)
+        suit = kSpades;
+    auto winner = node.lead;
+    for (auto p : prim::range(kNumPlayers))
+    {
+        const auto card = node.plays[p];
+        if (suitOf(card) == suit && (suitOf(node.plays[winner]) != suit || rankOf(node.plays[winner]) < rankOf(card)))
+            winner = p;
+    }
+
+    const auto points = mVariant == spades ? 0u : pointsOf(trick);
+    auto nextPoints = node.points;
+    if (points != 0)
+        nextPoints = node.points == kNoPoints || node.points == 1 + winner ? uint8_t(1 + winner) : kSplitPoints;
+    const auto broken = node.broken || (trick & mPointCards) != 0;
+
+    auto value = solveBoundary(node.hands, winner, broken, nextPoints, nullptr);
+    value.taken[winner] += mVariant == spades ? 1 : points;
+    if (mVariant == GameVariant::jack && (trick & kJackOfDiamonds.mask()) != 0)
+        value.tookJack = uint8_t(winner);
+    return value;
+}
+
+// A cost with the same order as the player's final score: GState::computeOutcome() scales it and shifts it.
+auto EndgameSolver::cost(const Node& node, const EndgameValue& value, PlayerNum player) const -> int
+{
+    if (mVariant == spades)
+        return -int(value.taken[player]);
+
+    auto result = node.tally[player] + value.taken[player];
+    if (node.moonPossible)
+    {
+        for (auto p : prim::range(kNumPlayers))
+        {
+            if (node.tally[p] + value.taken[p] == kTotalPoints)
+                result = p == player ? -kShootPoints : kShootPoints;
+        }
+    }
+    if (value.tookJack == player)
+        result -= kJackPoints;
+    return result;
+}
+
+} // namespace pho::gstate
@@ -1,5 +1,6 @@
 #include "gstate/GState.hpp"
 #include "cards/utils.hpp"
+#include "gstate/TensorSchema.hpp"
 #include "prim/range.hpp"
 
 #if __EMSCRIPTEN__
@@ -11,20 +12,44 @@ namespace pho::gstate {
 using math::RandomGenerator;
 
 namespace {
-auto actualDealIndex(uint128_t dealIndex) -> uint128_t
+constexpr auto kQueenOfSpades = cardFor(kSpades, kQueen);
+constexpr auto kJackOfDiamonds = cardFor(kDiamonds, kJack);
+
+auto actualDealIndex(uint128_t dealIndex, const RandomGenerator& rng = RandomGenerator::ThreadSpecific()) -> uint128_t
 {
     if (dealIndex == GState::Init::kRandomDealIndex)
-        dealIndex = Deal::randomDealIndex();
+        dealIndex = Deal::randomDealIndex(rng);
     return dealIndex;
 }
 
-auto actualPassOffset(uint8_t passOffset) -> uint8_t
+auto actualPassOffset(uint8_t passOffset, const RandomGenerator& rng = RandomGenerator::ThreadSpecific()) -> uint8_t
 {
     if (passOffset == GState::Init::kRandomPassOffset)
-        passOffset = RandomGenerator::Range64(4u);
+        passOffset = rng.range64(4u);
     return passOffset;
 }
 
+// The tally of the taken cards, as finishTrick() would have kept it.
+auto tallyOf(const FourHands& taken) -> GState::TakenTally
+{
+    auto tally = GState::TakenTally::empty();
+    for (auto p : prim::range(kNumPlayers))
+    {
+        const auto cards = taken.at(p);
+        tally.tricks.at(p) = uint8_t(cards.size() / kCardsPerTrick);
+        tally.hearts.at(p) = uint8_t(cards.cardsWithSuit(kHearts).size());
+        tally.points.at(p) = tally.hearts.at(p);
+        if (cards.hasCard(kQueenOfSpades))
+        {
+            tally.tookQueen = uint8_t(p);
+            tally.points.at(p) += 13;
+        }
+        if (cards.hasCard(kJackOfDiamonds))
+            tally.tookJack = uint8_t(p);
+    }
+    return tally;
+}
+
 #if __EMSCRIPTEN__
 auto asActualVals(const GState::Init& init) -> GStateInit
 {
@@ -48,24 +73,71 @@ GState::Init GState::kRandom = GState::Init::kRandom;
 GState::Init GState::kNoPass = GState::Init::kNoPass;
 
 GState::GState(const cards::Deal& deal, uint8_t passOffset, GameBehavior behavior)
+: GState{deal, passOffset, behavior, RandomGenerator::ThreadSpecific()}
+{ }
+
+GState::GState(const cards::Deal& deal, PassOffset passOffset, GameBehavior behavior, const RandomGenerator& rng)
 : mDealIndex{deal.dealIndex()}
 , mBehavior(behavior)
 , mUnplayedCards{CardSet::fullDeck()}
 , mHands{deal.hands()}
 , mPassed{}
 , mTaken{}
+, mTally{TakenTally::empty()}
 , mPlayerVoids{}
-, mPassOffset{actualPassOffset(passOffset)}
+, mPassOffset{actualPassOffset(passOffset, rng)}
 , mPlayIndex{}
 , mCurrent{}
 , mAllTaken{}
 , mTrick{}
 , mPriorTrick{}
 , mPassingComplete{}
+, mBids{}
+, mOutcome{}
+, mRng{rng.random64()}
 { }
 
+GState::GState(const Position& position, const FourHands& hands, const FourHands& passed, PlayerNum observer,
+    GameBehavior behavior, const RandomGenerator& rng)
+: mDealIndex{~uint128_t{0}}
+, mBehavior(behavior)
+, mUnplayedCards{CardSet::fullDeck()}
+, mHands{hands}
+, mPassed{passed}
+, mCardsPlayed{position.played}
+, mTaken{position.taken}
+, mTally{tallyOf(position.taken)}
+, mPlayerVoids{position.voids}
+, mPassOffset{position.passOffset}
+, mPlayIndex{}
+, mCurrent{}
+, mAllTaken{}
+, mTrick{position.trick}
+, mPriorTrick{position.priorTrick}
+, mPassingComplete{true}
+, mBids{position.bids}
+, mOutcome{}
+, mRng{rng.random64()}
+{
+    for (auto p : prim::range(kNumPlayers))
+    {
+        mUnplayedCards -= mCardsPlayed.at(p);
+        mAllTaken += mTaken.at(p);
+        mPlayIndex += mCardsPlayed.at(p).size();
+    }
+    mCurrent = (mTrick.lead() + playInTrick()) % kNumPlayers;
+    if (mPassOffset != 0)
+        adjustPassedState(observer);
+    if (done())
+        mOutcome = computeOutcome();
+}
+
 GState::GState(Init init, GameBehavior behavior)
-: GState{Deal{actualDealIndex(init.dealIndex)}, actualPassOffset(init.passOffset), behavior}
+: GState{init, behavior, RandomGenerator::ThreadSpecific()}
+{ }
+
+GState::GState(Init init, GameBehavior behavior, const RandomGenerator& rng)
+: GState{Deal{actualDealIndex(init.dealIndex, rng)}, init.passOffset, behavior, rng}
 { }
 
 #if __EMSCRIPTEN__
@@ -98,6 +170,20 @@ auto totalCards(const FourHands& hands) -> uint32_t
 }
 
 auto GState::startGame() -> void
+{
+    exchangePasses();
+    beginPlay(mBehavior.firstLead(*this));
+}
+
+auto GState::startGame(PlayerNum firstLead) -> void
+{
+    assert(firstLead < kNumPlayers);
+    exchangePasses();
+    assert(mBehavior.variant() == GameVariant::spades || firstLead == mBehavior.firstLead(*this));
+    beginPlay(firstLead);
+}
+
+auto GState::exchangePasses() -> void
 {
     assert(mPlayIndex == 0u);
     assert(!mPassingComplete);
@@ -123,8 +209,11 @@ auto GState::startGame() -> void
         }
     }
     mPassingComplete = true;
+}
 
-    mCurrent = mBehavior.firstLead(*this);
+auto GState::beginPlay(PlayerNum firstLead) -> void
+{
+    mCurrent = firstLead;
 
     mUnplayedCards = CardSet::fullDeck();
     mAllTaken = CardSet{};
@@ -135,27 +224,50 @@ auto GState::finishTrick() -> void
 {
     auto winner = mBehavior.trickWinner(mTrick);
     assert(mCardsPlayed.at(winner).hasCard(mTrick.at(winner)));
+    auto trick = CardSet{};
     for (auto i : prim::range(kCardsPerTrick))
     {
         auto card = mTrick.at(i);
         assert(card.ord() != Card::kNone);
         assert(mCardsPlayed.at(i).hasCard(card));
-        mTaken.at(winner) += card;
-        mAllTaken += card;
+        trick += card;
     }
+    mTaken.at(winner) += trick;
+    mAllTaken += trick;
+
+    const auto hearts = trick.cardsWithSuit(kHearts).size();
+    mTally.tricks.at(winner) += 1;
+    mTally.hearts.at(winner) += hearts;
+    mTally.points.at(winner) += hearts;
+    if (trick.hasCard(kQueenOfSpades))
+    {
+        mTally.tookQueen = winner;
+        mTally.points.at(winner) += 13;
+    }
+    if (trick.hasCard(kJackOfDiamonds))
+        mTally.tookJack = winner;
+
     std::swap(mTrick, mPriorTrick);
     mTrick.resetTrick(winner);
     mCurrent = winner;
+
+    if (done())
+        mOutcome = computeOutcome();
 }
 
 auto GState::playCard(Card card) -> void
 {
-    auto player = currentPlayer();
-    assert(mHands.at(player).hasCard(card));
-
     if (!legalPlays().hasCard(card))
         throw std::invalid_argument(
             fmt::format("Card {} is not a legal play ({})", nameOfCard(card), to_string(legalPlays())));
+    playCardUnchecked(card);
+}
+
+auto GState::playCardUnchecked(Card card) -> void
+{
+    auto player = currentPlayer();
+    assert(mHands.at(player).hasCard(card));
+    assert(legalPlays().hasCard(card));
     assert(mUnplayedCards.hasCard(card));
 
     if (playInTrick() != 0 && suitOf(card) != trickSuit())
@@ -178,27 +290,167 @@ auto GState::playCard(Card card) -> void
         finishTrick();
 }
 
+auto GState::outcomeDecided() const -> bool
+{
+    if (done())
+        return true;
+
+    switch (mBehavior.variant())
+    {
+        case GameVariant::standard:
+            return (mAllTaken & kPointCards) == kPointCards;
+        case GameVariant::jack:
+            return (mAllTaken & kPointCards) == kPointCards && mAllTaken.hasCard(kJackOfDiamonds);
+        case GameVariant::spades: {
+            constexpr auto kNoBids = std::array<Bid, kNumPlayers>{};
+            if (mBids == kNoBids)
+                return false;
+            const auto tricksLeft = (kCardsPerDeck - mAllTaken.size()) / kCardsPerTrick;
+            for (auto p : prim::range(kNumPlayers))
+            {
+                if (mTally.tricks.at(p) + tricksLeft >= mBids.at(p))
+                    return false;
+            }
+            return true;
+        }
+        default: {
+            assert(false);
+            throw std::runtime_error("Bad behavior variant");
+        }
+    }
+}
+
+auto GState::bidsDecided() const -> bool
+{
+    constexpr auto kNoBids = std::array<Bid, kNumPlayers>{};
+    if (mBehavior.variant() != GameVariant::spades || mBids == kNoBids)
+        return false;
+
+    const auto tricksLeft = (kCardsPerDeck - mAllTaken.size()) / kCardsPerTrick;
+    for (auto p : prim::range(kNumPlayers))
+    {
+        const auto made = mTally.tricks.at(p) >= mBids.at(p);
+        const auto failed = mTally.tricks.at(p) + tricksLeft < mBids.at(p);
+        if (!made && !failed)
+            return false;
+    }
+    return true;
+}
+
+auto GState::fastForward() -> void
+{
+    assert(mPassingComplete);
+    assert(outcomeDecided());
+    if (done())
+        return;
+
+    // The cards still in hands and those already on the table for the current trick
+    const auto remaining = CardSet::fullDeck() - mAllTaken;
+    assert(remaining.size() % kCardsPerTrick == 0);
+    assert((remaining & kPointCards).empty() || mBehavior.variant() == GameVariant::spades);
+
+    const auto winner = mTrick.lead();
+    mTaken.at(winner) += remaining;
+    mAllTaken += remaining;
+    mTally.tricks.at(winner) += remaining.size() / kCardsPerTrick;
+    for (auto p : prim::range(kNumPlayers))
+    {
+        mCardsPlayed.at(p) += mHands.at(p);
+        mHands.at(p) = CardSet{};
+    }
+    mUnplayedCards = CardSet{};
+    mPlayIndex = kCardsPerDeck;
+    mTrick.resetTrick(winner);
+    mCurrent = winner;
+    mOutcome = computeOutcome();
+}
+
+auto GState::trickCheckpoint() const -> TrickCheckpoint
+{
+    assert(mPassingComplete);
+    assert(playInTrick() == 0);
+    return TrickCheckpoint{
+        .played = mCardsPlayed,
+        .taken = mTaken,
+        .tally = mTally,
+        .priorTrick = mPriorTrick,
+        .voids = mPlayerVoids.bits(),
+        .playIndex = uint8_t(mPlayIndex),
+        .lead = uint8_t(mCurrent),
+    };
+}
+
+auto GState::position() const -> Position
+{
+    assert(mPassingComplete);
+    return Position{
+        .passOffset = mPassOffset,
+        .played = mCardsPlayed,
+        .taken = mTaken,
+        .voids = mPlayerVoids,
+        .trick = mTrick,
+        .priorTrick = mPriorTrick,
+        .bids = mBids,
+    };
+}
+
+auto GState::restore(const TrickCheckpoint& checkpoint) -> void
+{
+    assert(mPassingComplete);
+    mUnplayedCards = CardSet::fullDeck();
+    mAllTaken = CardSet{};
+    for (auto p : prim::range(kNumPlayers))
+    {
+        // The hand held when play started is the same for every state of the game.
+        const auto startingHand = mHands.at(p) + mCardsPlayed.at(p);
+        mHands.at(p) = startingHand - checkpoint.played.at(p);
+        mCardsPlayed.at(p) = checkpoint.played.at(p);
+        mTaken.at(p) = checkpoint.taken.at(p);
+        mUnplayedCards -= checkpoint.played.at(p);
+        mAllTaken += checkpoint.taken.at(p);
+    }
+    mTally = checkpoint.tally;
+    mPlayerVoids = PlayerVoids{checkpoint.voids};
+    mPlayIndex = checkpoint.playIndex;
+    mCurrent = checkpoint.lead;
+    mTrick.resetTrick(mCurrent);
+    mPriorTrick = checkpoint.priorTrick;
+    if (done())
+        mOutcome = computeOutcome();
+}
+
 auto GState::trickSuit() const -> Suit
 {
     assert(playInTrick() != 0);
     return mTrick.trickSuit();
 }
 
-auto GState::getVariantOutcomeRep() const -> VariantOutcomeRep
+auto GState::setBid(PlayerNum p, Bid bid) -> void
+{
+    assert(bid > 0);
+    assert(bid <= 13);
+    mBids[p] = bid;
+    if (done())
+        mOutcome = computeOutcome();
+}
+
+auto GState::computeOutcome() const -> Outcome
 {
-    auto outcome = VariantOutcomeRep{};
+    auto outcome = Outcome{};
     switch (mBehavior.variant())
     {
         case GameVariant::standard: {
-            outcome = getStandardOutcome();
+            auto standard = VariantOutcome::Standard{};
+            getStandardOutcome(standard);
+            outcome.rep = standard;
             break;
         }
         case GameVariant::jack: {
-            outcome = getJackOutcome();
+            outcome.rep = getJackOutcome();
             break;
         }
         case GameVariant::spades: {
-            outcome = getSpadesOutcome();
+            outcome.rep = getSpadesOutcome();
             break;
         }
         default: {
@@ -206,9 +458,38 @@ auto GState::getVariantOutcomeRep() const -> VariantOutcomeRep
             throw std::runtime_error("Bad behavior variant");
         }
     }
+    std::visit(
+        [&outcome](auto&& rep) {
+            outcome.scores = rep.normalizedScores();
+            for (auto p : prim::range(kNumPlayers))
+                outcome.winPts[p] = rep.playerOutcomeResult(p);
+        },
+        outcome.rep);
     return outcome;
 }
 
+auto GState::getPlayerScores() const -> PlayerScores
+{
+    if (done())
+        return mOutcome.scores;
+    return computeOutcome().scores;
+}
+
+auto GState::getPlayerOutcome(unsigned p) const -> PlayerOutcome
+{
+    if (done())
+        return PlayerOutcome{mOutcome.scores[p], mOutcome.winPts[p]};
+    const auto outcome = computeOutcome();
+    return PlayerOutcome{outcome.scores[p], outcome.winPts[p]};
+}
+
+auto GState::getVariantOutcomeRep() const -> VariantOutcomeRep
+{
+    if (done())
+        return mOutcome.rep;
+    return computeOutcome().rep;
+}
+
 constexpr auto kNoOne = kNumPlayers;
 constexpr auto kExpectedTotalHearts = 13;
 
@@ -222,26 +503,16 @@ auto GState::getStandardOutcome() const -> VariantOutcome::Standard
 
 void GState::getStandardOutcome(VariantOutcome::Standard& outcome) const
 {
-    outcome.mTookQueen = kNoOne;
-    for (auto p : prim::range(kNumPlayers))
-    {
-        auto taken = takenBy(p);
-        outcome.mHeartsTaken[p] = taken.cardsWithSuit(kHearts).size();
-        if (taken.hasCard(cards::cardFor(cards::kSpades, cards::kQueen)))
-        {
-            outcome.mTookQueen = p;
-            if (outcome.mHeartsTaken[p] == kExpectedTotalHearts)
-                outcome.mShooter = p;
-        }
-    }
+    outcome.mTookQueen = mTally.tookQueen;
+    outcome.mHeartsTaken = mTally.hearts;
     assert(outcome.mTookQueen != kNoOne);
+    if (outcome.mHeartsTaken.at(outcome.mTookQueen) == kExpectedTotalHearts)
+        outcome.mShooter = outcome.mTookQueen;
     for (auto p : prim::range(kNumPlayers))
     {
         if (outcome.mShooter == kNoOne)
         {
-            outcome.mScores[p] = outcome.mHeartsTaken[p];
-            if (outcome.mTookQueen == p)
-                outcome.mScores[p] += 13;
+            outcome.mScores[p] = mTally.points[p];
             outcome.mScores[p] -= 6.5;
         }
         else
@@ -261,18 +532,15 @@ auto GState::getJackOutcome() const -> VariantOutcome::Jack
     auto outcome = VariantOutcome::Jack{};
     getStandardOutcome(outcome);
 
-    auto tookJack = kNoOne;
+    const auto tookJack = PlayerNum{mTally.tookJack};
     for (auto p : prim::range(kNumPlayers))
     {
         assert(outcome.mScores[p] >= -1.0);
         assert(outcome.mScores[p] <= 1.0);
         outcome.mScores[p] *= 19.5;
         outcome.mScores[p] += 6.5 - 4.0;
-        if (takenBy(p).hasCard(cards::cardFor(cards::kDiamonds, cards::kJack)))
-        {
-            tookJack = p;
+        if (p == tookJack)
             outcome.mScores[p] -= 10;
-        }
         outcome.mScores[p] /= 24.0;
     }
 
@@ -307,7 +575,7 @@ auto GState::getSpadesOutcome() const -> VariantOutcome::Spades
     // In that case, the scores will be -1/13, 1/39, 1/39, 1/39.
     for (auto p : prim::range(kNumPlayers))
     {
-        outcome.mScores[p] = (13.0 - takenBy(p).size()) / 39.0;
+        outcome.mScores[p] = (13.0 - kCardsPerTrick * mTally.tricks[p]) / 39.0;
     }
 
     // Now we can adjust the scores based on the bids.
@@ -324,7 +592,7 @@ auto GState::getSpadesOutcome() const -> VariantOutcome::Spades
         for (auto p : prim::range(kNumPlayers))
         {
             auto bid = mBids.at(p);
-            auto tricksTaken = takenBy(p).size() / 4;
+            auto tricksTaken = unsigned{mTally.tricks.at(p)};
             if (tricksTaken >= bid)
             {
                 outcome.mScores[p] = -1.0 * (10.0 * bid + tricksTaken - bid);
@@ -344,9 +612,9 @@ auto GState::getSpadesOutcome() const -> VariantOutcome::Spades
     return outcome;
 }
 
-auto GState::adjustPassedState() -> void
+auto GState::adjustPassedState(PlayerNum observer) -> void
 {
-    const auto kCarl = currentPlayer();
+    const auto kCarl = observer;
     const auto kAlan = (kCarl + mPassOffset) % 4u;
     const auto kBetty = (kCarl + 4 - mPassOffset) % 4u;
 
@@ -385,7 +653,7 @@ auto GState::adjustPassedState() -> void
         else
         {
             assert(p != kCarl && p != kAlan);
-            received = chooseThreeAtRandom(handAtStart); // not ideal, but should be good enough
+            received = chooseThreeAtRandom(handAtStart, mRng); // not ideal, but should be good enough
             assert((handAtStart & received) == received);
         }
 
@@ -396,9 +664,11 @@ auto GState::adjustPassedState() -> void
     }
 }
 
-auto GState::alternate(const FourHands& hands) const -> GState
+auto GState::alternate(const FourHands& hands, PlayerNum observer) const -> GState
 {
     auto alt{*this};
+    // Each alternate gets its own stream, so alternates of the same state do not repeat each other's choices.
+    alt.mRng = RandomGenerator{mRng.random64()};
 
     alt.mDealIndex = ~uint128_t{0};
     alt.mHands = hands;
@@ -406,12 +676,42 @@ auto GState::alternate(const FourHands& hands) const -> GState
     assert(mPassingComplete);
     if (mPassOffset != 0)
     {
-        alt.adjustPassedState();
+        alt.adjustPassedState(observer);
     }
 
     return alt;
 }
 
+auto GState::permuteSuits(const SuitPermutation& permutation) const -> GState
+{
+    auto permuted{*this};
+    permuted.mDealIndex = ~uint128_t{0};
+    permuted.mUnplayedCards = permutation(mUnplayedCards);
+    permuted.mAllTaken = permutation(mAllTaken);
+    for (auto p : prim::range(kNumPlayers))
+    {
+        permuted.mHands.at(p) = permutation(mHands.at(p));
+        permuted.mPassed.at(p) = permutation(mPassed.at(p));
+        permuted.mCardsPlayed.at(p) = permutation(mCardsPlayed.at(p));
+        permuted.mTaken.at(p) = permutation(mTaken.at(p));
+    }
+    for (auto i : prim::range(kNumPlayers))
+    {
+        permuted.mTrick[i] = permutation(mTrick.at(i));
+        permuted.mPriorTrick[i] = permutation(mPriorTrick.at(i));
+    }
+    permuted.mPlayerVoids = PlayerVoids{};
+    for (auto p : prim::range(kNumPlayers))
+    {
+        for (auto suit : allSuits)
+        {
+            if (mPlayerVoids.isVoid(p, suit))
+                permuted.mPlayerVoids.setIsVoid(p, permutation(suit));
+        }
+    }
+    return permuted;
+}
+
 PlayerVoids GState::voidsForOthers() const
 {
     // Here is where we must ensure that when there are no cards remaining for a suit, that
@@ -556,95 +856,7 @@ auto GState::asProbabilities() const -> ProbArray
     return prob;
 }
 
-namespace min2022 {
-enum InputSchema
-{
-    eLegalPlay,
-    eP0ProbHasCard,
-    eP1ProbHasCard,
-    eP2ProbHasCard,
-    eP3ProbHasCard,
-    eP0TakenCard,
-    eP1TakenCard,
-    eP2TakenCard,
-    eP3TakenCard,
-    eCardOnTable,
-    eCardLeadingTrick,
-    eHighCardInTrick,
-
-    kNumInFeatures
-};
-} // namespace min2022
-
-auto GState::asMin2022InputTensor(float* data) const -> void
-{
-    const GState& self = *this;
-    // ---- Legal Plays ----
-    // Note: A tensor encoding is always created from the perspective as if the current player (Carl) is sitting at
-    // the South seat, but the actual state is unconstrained: the player may be at any seat. (It's possible that we
-    // should have constrained KnowableState the same way, but let's set that aside.) So, we remap the seating here.
-
-    // In the code below, we use the convention that `pMain` is a player numbering with Carl at South (seat 0),
-    // and `pState` is the actual player numbering in the knowable state.
-
-    // We also have yet another player numbering: the "playInTrick" numbering, which is 0 for the player leading
-    // the current trick.
-
-    const auto mainToState = [&](unsigned pMain) -> unsigned {
-        assert(pMain < kNumPlayers);
-        return (self.currentPlayer() + pMain) % kNumPlayers;
-    };
-
-    // Note to future self: using an accessor is critical for good performance here
-    float(*rowAccessor)[min2022::kNumInFeatures] = reinterpret_cast<float(*)[min2022::kNumInFeatures]>(data);
-
-    for (auto card : self.legalPlays())
-    {
-        auto cardAccessor = rowAccessor[card.ord()];
-        cardAccessor[min2022::eLegalPlay] = 1.0;
-    }
-
-    // ---- Probability Has Card (for unknown cards) ----
-    GState::ProbArray prob = self.asProbabilities();
-    for (auto pMain : prim::range(kNumPlayers))
-    {
-        // AsProbabilities fills the probabilities in pMain (absolute player) order.
-        auto pState = mainToState(pMain);
-        for (Card card : CardSet::fullDeck())
-        {
-            rowAccessor[card.ord()][min2022::eP0ProbHasCard + pMain] = prob[card.ord()][pState];
-        }
-    }
-
-    // ---- Probability Took Card (for cards in completed tricks) ----
-    unsigned totalTaken = 0;
-    for (auto pMain : prim::range(kNumPlayers))
-    {
-        auto pState = mainToState(pMain);
-        for (Card card : self.takenBy(pState))
-        {
-            rowAccessor[card.ord()][min2022::eP0TakenCard + pMain] = 1.0;
-            ++totalTaken;
-        }
-    }
-    (void)totalTaken;
-    assert(totalTaken == (self.playIndex() / kCardsPerTrick) * kCardsPerTrick);
-
-    // ---- Current trick features ----
-    if (self.playInTrick() > 0)
-    {
-        // ---- Lead and High Card in current trick ----
-        rowAccessor[self.getTrickPlay(0).ord()][min2022::eCardLeadingTrick] = 1.0;
-        rowAccessor[self.highCardInTrick().ord()][min2022::eHighCardInTrick] = 1.0;
-
-        // Fill columns eP1CardOnTable .. eP3CardOnTable
-        for (auto pTrick : prim::range(self.playInTrick()))
-        {
-            Card card = self.getTrickPlay(pTrick);
-            rowAccessor[card.ord()][min2022::eCardOnTable] = 1.0;
-        }
-    }
-}
+auto GState::asMin2022InputTensor(float* data) const -> void { min2022::Schema::encode(*this, data); }
 
 #if __EMSCRIPTEN__
 using namespace emscripten;
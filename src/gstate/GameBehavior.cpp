@@ -29,29 +29,32 @@ GameBehavior::StandardHearts::~StandardHearts() { }
 GameBehavior::JackDiamondsHearts::~JackDiamondsHearts() { }
 GameBehavior::Spades::~Spades() { }
 
-auto GameBehavior::Concept::legalLeadPlays(const GState& state) const -> CardSet
+auto GameBehavior::Concept::legalLeadPlays(const GState& state, CardSet hand) const -> CardSet
 {
-    auto hand = state.currentPlayersHand();
     auto pointsTaken = state.allTaken() & pointCards();
     return pointsTaken.size() > 0 ? hand : hand & ~pointCards();
 }
 
-auto GameBehavior::Concept::legalFollowPlays(const GState& state) const -> CardSet
+auto GameBehavior::Concept::legalFollowPlays(const GState& state, CardSet hand) const -> CardSet
 {
-    auto hand = state.currentPlayersHand();
     return hand.cardsWithSuit(state.trickSuit());
 }
 
 auto GameBehavior::Concept::legal(const GState& state) const -> CardSet
+{
+    return legalFor(state, state.currentPlayersHand());
+}
+
+auto GameBehavior::Concept::legalFor(const GState& state, CardSet hand) const -> CardSet
 {
     assert(state.gameStarted());
 
     if (state.playIndex() == 0 && mVariant != spades)
-        return CardSet::make({Card::cardFor(kClubs, kTwo)});
+        return CardSet::make({Card::cardFor(kClubs, kTwo)}) & hand;
 
-    auto choices = state.playInTrick() == 0 ? legalLeadPlays(state) : legalFollowPlays(state);
+    auto choices = state.playInTrick() == 0 ? legalLeadPlays(state, hand) : legalFollowPlays(state, hand);
     if (choices.empty())
-        choices = state.currentPlayersHand();
+        choices = hand;
 
     return choices;
 }
@@ -99,7 +102,9 @@ auto GameBehavior::Spades::trumpSuit(const pho::gstate::Trick& trick) const -> S
         for (auto p : prim::range(kNumPlayers))
         {
             auto card = trick.at(p);
-            assert(card != Card::kNone);
+            // The trick may still be in progress, see highCard().
+            if (card == Card::kNone)
+                continue;
             if (suitOf(card) == kSpades)
             {
                 suit = kSpades;
@@ -129,9 +134,9 @@ auto GameBehavior::Spades::trickWinner(const pho::gstate::Trick& trick) const ->
     return winner;
 }
 
-auto GameBehavior::Spades::firstLead(const GState&) const -> uint32_t
+auto GameBehavior::Spades::firstLead(const GState& state) const -> uint32_t
 {
-    return math::RandomGenerator::Range64(4u);
+    return state.rng().range64(kNumPlayers);
 }
 
 ActiveGameBehavior* ActiveGameBehavior::gActive = nullptr;
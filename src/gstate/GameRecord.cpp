@@ -0,0 +1,325 @@
+#include "gstate/GameRecord.hpp"
+#include "math/Bits.hpp"
+#include "math/MixedRadix.hpp"
+#include "math/combinatorics.hpp"
+
+#include <cstring>
+#include <fmt/ranges.h>
+#include <stdexcept>
+
+namespace pho::gstate {
+
+using math::MixedRadixDecoder;
+using math::MixedRadixEncoder;
+
+namespace {
+constexpr char kMagic[8] = {'P', 'H', 'O', 'G', 'A', 'M', 'E', 'S'};
+constexpr uint32_t kVersion = 2;
+
+constexpr uint64_t kVariants = 3;
+constexpr uint64_t kPassOffsets = kNumPlayers;
+constexpr uint64_t kPasses = 286; // C(13, 3)
+constexpr uint64_t kMaxBid = 13;
+constexpr uint64_t kPlayCounts = kCardsPerDeck + 1;
+constexpr unsigned kCardsPassed = 3;
+
+// The first (least significant) digit is the length of the encoding in bytes, so that a truncated encoding is
+// detected instead of decoding to a different game. It only sets the low six bits of the first byte, so it does not
+// change the length.
+constexpr uint32_t kLengthRadix = 64;
+
+// The deal index is coded as two 32-bit digits and a high digit.
+const uint64_t kDealHighRadix = uint64_t((math::possibleDistinguishableDeals() - 1) >> 64) + 1;
+
+// The colex rank of the three passed cards among the 13 cards of the dealt hand.
+auto rankPass(CardSet dealt, CardSet passed) -> uint32_t
+{
+    assert(dealt.size() == kCardsPerHand && passed.size() == kCardsPassed);
+    return uint32_t(rankSubset(passed, dealt));
+}
+
+auto unrankPass(CardSet dealt, uint32_t rank) -> CardSet
+{
+    assert(rank < kPasses);
+    return unrankSubset(rank, kCardsPassed, dealt);
+}
+
+auto indexInSet(CardSet cards, Card card) -> uint32_t
+{
+    assert(cards.hasCard(card));
+    return math::countBits(cards.asBits() & (card.mask() - 1));
+}
+} // namespace
+
+GameRecord::GameRecord(const GState& started)
+: mVariant{started.behavior().variant()}
+, mDealIndex{started.dealIndex()}
+, mPassOffset{started.passOffset()}
+, mPassed{}
+, mFirstLead{started.currentPlayer()}
+, mBids{started.bids()}
+, mPlays{}
+{
+    if (!started.gameStarted() || started.playIndex() != 0)
+        throw std::invalid_argument("GameRecord must start from a started game before the first play");
+    // The bids are coded as all or nothing, each in 1..13.
+    if (mBids != Bids{})
+    {
+        for (auto bid : mBids)
+        {
+            if (bid < 1 || bid > kMaxBid)
+                throw std::invalid_argument(
+                    fmt::format("GameRecord needs every bid in 1..{} or none, not {}", kMaxBid, fmt::join(mBids, ",")));
+        }
+    }
+    if (mPassOffset != 0)
+    {
+        for (auto p : prim::range(kNumPlayers))
+            mPassed.at(p) = started.passedBy(p);
+    }
+    mPlays.reserve(kCardsPerDeck);
+}
+
+auto GameRecord::add(Card card) -> void
+{
+    if (mPlays.size() == kCardsPerDeck)
+        throw std::invalid_argument("GameRecord already has all 52 plays");
+    mPlays.push_back(card);
+}
+
+auto GameRecord::initialState() const -> GState
+{
+    auto state = GState{GState::Init{mDealIndex, mPassOffset}, GameBehavior::make(mVariant)};
+    if (mPassOffset != 0)
+    {
+        for (auto p : prim::range(kNumPlayers))
+            state.setPassFor(p, mPassed.at(p));
+    }
+    if (mBids != Bids{})
+    {
+        for (auto p : prim::range(kNumPlayers))
+            state.setBid(p, mBids[p]);
+    }
+    if (mVariant == spades)
+        state.startGame(mFirstLead);
+    else
+        state.startGame();
+    return state;
+}
+
+auto GameRecord::replay() const -> GState
+{
+    auto state = initialState();
+    for (auto card : mPlays)
+        state.playCard(card);
+    return state;
+}
+
+auto GameRecord::encode() const -> std::vector<uint8_t>
+{
+    auto digits = MixedRadixEncoder{};
+
+    digits.push(0, kLengthRadix);
+    digits.push(mVariant, kVariants);
+    digits.push(uint32_t(mDealIndex), math::kMaxRadix);
+    digits.push(uint32_t(mDealIndex >> 32), math::kMaxRadix);
+    digits.push(uint32_t(mDealIndex >> 64), kDealHighRadix);
+    digits.push(mPassOffset, kPassOffsets);
+
+    auto state = initialState();
+    if (mPassOffset != 0)
+    {
+        const auto deal = Deal{mDealIndex};
+        for (auto p : prim::range(kNumPlayers))
+            digits.push(rankPass(deal.dealFor(p), mPassed.at(p)), kPasses);
+    }
+
+    if (mVariant == spades)
+    {
+        digits.push(mFirstLead, kNumPlayers);
+        const auto hasBids = mBids != Bids{};
+        digits.push(hasBids, 2);
+        if (hasBids)
+        {
+            for (auto bid : mBids)
+                digits.push(bid - 1u, kMaxBid);
+        }
+    }
+
+    digits.push(uint32_t(mPlays.size()), kPlayCounts);
+    for (auto card : mPlays)
+    {
+        const auto legal = state.legalPlays();
+        if (!legal.hasCard(card))
+            throw std::invalid_argument(fmt::format("Recorded play {} is not legal", nameOfCard(card)));
+        digits.push(indexInSet(legal, card), legal.size());
+        state.playCard(card);
+    }
+
+    auto bytes = digits.bytes();
+    assert(bytes.size() < kLengthRadix);
+    if (!bytes.empty())
+        bytes.front() |= uint8_t(bytes.size());
+    return bytes;
+}
+
+auto GameRecord::decode(const uint8_t* data, size_t size) -> GameRecord { return decode(data, size, nullptr); }
+
+auto GameRecord::decode(const uint8_t* data, size_t size, const PlyVisitor& visit) -> GameRecord
+{
+    auto digits = MixedRadixDecoder{data, size};
+    auto record = GameRecord{};
+
+    if (digits.pop(kLengthRadix) != size)
+        throw std::invalid_argument("Malformed game record: wrong length");
+    const auto variant = digits.pop(kVariants);
+    record.mVariant = GameVariant(variant);
+    record.mDealIndex = digits.pop(math::kMaxRadix);
+    record.mDealIndex |= DealIndex{digits.pop(math::kMaxRadix)} << 32;
+    record.mDealIndex |= DealIndex{digits.pop(kDealHighRadix)} << 64;
+    if (record.mDealIndex >= math::possibleDistinguishableDeals())
+        throw std::invalid_argument("Malformed game record: deal index out of range");
+    record.mPassOffset = PassOffset(digits.pop(kPassOffsets));
+
+    if (record.mPassOffset != 0)
+    {
+        const auto deal = Deal{record.mDealIndex};
+        for (auto p : prim::range(kNumPlayers))
+            record.mPassed.at(p) = unrankPass(deal.dealFor(p), digits.pop(kPasses));
+    }
+
+    if (record.mVariant == spades)
+    {
+        record.mFirstLead = digits.pop(kNumPlayers);
+        if (digits.pop(2))
+        {
+            for (auto& bid : record.mBids)
+                bid = GState::Bid(digits.pop(kMaxBid) + 1);
+        }
+    }
+
+    auto state = record.initialState();
+    record.mFirstLead = state.currentPlayer();
+
+    const auto numPlays = digits.pop(kPlayCounts);
+    for (uint32_t i = 0; i < numPlays; ++i)
+    {
+        const auto legal = state.legalPlays();
+        const auto card = legal.nthCard(digits.pop(legal.size()));
+        record.mPlays.push_back(card);
+        if (visit)
+            visit(state, card);
+        state.playCardUnchecked(card);
+    }
+
+    if (!digits.empty())
+        throw std::invalid_argument("Malformed game record: trailing data");
+    return record;
+}
+
+auto GameRecord::operator==(const GameRecord& other) const -> bool
+{
+    if (mVariant != other.mVariant || mDealIndex != other.mDealIndex || mPassOffset != other.mPassOffset
+        || mFirstLead != other.mFirstLead || mBids != other.mBids || mPlays != other.mPlays)
+        return false;
+    for (auto p : prim::range(kNumPlayers))
+    {
+        if (mPassed.at(p) != other.mPassed.at(p))
+            return false;
+    }
+    return true;
+}
+
+GameRecordWriter::GameRecordWriter(const std::string& path)
+: mPath{path}
+, mFile{std::fopen(path.c_str(), "wb")}
+, mRecordsWritten{}
+, mBytesWritten{}
+{
+    if (mFile == nullptr)
+        throw std::runtime_error(fmt::format("Cannot create {}", path));
+    std::fwrite(kMagic, sizeof(kMagic), 1, mFile);
+    std::fwrite(&kVersion, sizeof(kVersion), 1, mFile);
+    mBytesWritten = sizeof(kMagic) + sizeof(kVersion);
+}
+
+GameRecordWriter::~GameRecordWriter()
+{
+    try
+    {
+        close();
+    }
+    catch (const std::exception& e)
+    {
+        fmt::print(stderr, "{}\n", e.what());
+    }
+}
+
+auto GameRecordWriter::append(const GameRecord& record) -> void
+{
+    assert(mFile != nullptr);
+    const auto encoded = record.encode();
+    assert(encoded.size() <= 0xff);
+    const auto length = uint8_t(encoded.size());
+    std::fwrite(&length, sizeof(length), 1, mFile);
+    std::fwrite(encoded.data(), encoded.size(), 1, mFile);
+    ++mRecordsWritten;
+    mBytesWritten += sizeof(length) + encoded.size();
+}
+
+auto GameRecordWriter::close() -> void
+{
+    if (mFile == nullptr)
+        return;
+    const auto failed = std::ferror(mFile) != 0;
+    const auto closeFailed = std::fclose(mFile) != 0;
+    mFile = nullptr;
+    if (failed || closeFailed)
+        throw std::runtime_error(fmt::format("Failed writing {}", mPath));
+}
+
+GameRecordReader::GameRecordReader(const std::string& path)
+: mPath{path}
+, mFile{std::fopen(path.c_str(), "rb")}
+{
+    if (mFile == nullptr)
+        throw std::runtime_error(fmt::format("Cannot open {}", path));
+
+    char magic[sizeof(kMagic)];
+    uint32_t version{};
+    if (std::fread(magic, sizeof(magic), 1, mFile) != 1 || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0
+        || std::fread(&version, sizeof(version), 1, mFile) != 1)
+    {
+        std::fclose(mFile);
+        throw std::runtime_error(fmt::format("{} is not a game record archive", path));
+    }
+    if (version != kVersion)
+    {
+        std::fclose(mFile);
+        throw std::runtime_error(fmt::format("{} has unsupported version {}", path, version));
+    }
+}
+
+GameRecordReader::~GameRecordReader() { std::fclose(mFile); }
+
+auto GameRecordReader::next(std::vector<uint8_t>& encoded) -> bool
+{
+    const int length = std::fgetc(mFile);
+    if (length == EOF)
+        return false;
+    encoded.resize(length);
+    if (length > 0 && std::fread(encoded.data(), length, 1, mFile) != 1)
+        throw std::runtime_error(fmt::format("{} is truncated", mPath));
+    return true;
+}
+
+auto GameRecordReader::next(GameRecord& record) -> bool
+{
+    auto encoded = std::vector<uint8_t>{};
+    if (!next(encoded))
+        return false;
+    record = GameRecord::decode(encoded.data(), encoded.size());
+    return true;
+}
+
+} // namespace pho::gstate
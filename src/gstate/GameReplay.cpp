@@ -0,0 +1,86 @@
+#include "gstate/GameReplay.hpp"
+
+namespace pho::gstate {
+
+GameReplay::GameReplay(const GameRecord& record)
+: mRecord{record}
+, mInitial{record.initialState()}
+, mCheckpoints{}
+{
+    mCheckpoints.reserve(kCardsPerDeck / kNumPlayers + 1);
+    auto state = mInitial;
+    for (auto card : mRecord.plays())
+    {
+        if (state.playInTrick() == 0)
+            mCheckpoints.push_back(state.trickCheckpoint());
+        state.playCard(card);
+    }
+    if (state.playInTrick() == 0)
+        mCheckpoints.push_back(state.trickCheckpoint());
+}
+
+GameReplay::GameReplay(GameRecord record, GState initial, std::vector<GState::TrickCheckpoint> checkpoints)
+: mRecord{std::move(record)}
+, mInitial{std::move(initial)}
+, mCheckpoints{std::move(checkpoints)}
+{ }
+
+auto GameReplay::decode(const uint8_t* data, size_t size) -> GameReplay
+{
+    auto checkpoints = std::vector<GState::TrickCheckpoint>{};
+    checkpoints.reserve(kCardsPerDeck / kNumPlayers + 1);
+    auto record = GameRecord::decode(data, size, [&checkpoints](const GState& state, Card) {
+        if (state.playInTrick() == 0)
+            checkpoints.push_back(state.trickCheckpoint());
+    });
+
+    // The visitor only sees the states before each play, so a game that ends on a trick boundary still needs the
+    // checkpoint of its final state.
+    auto initial = record.initialState();
+    const auto numPlies = unsigned(record.plays().size());
+    if (numPlies % kNumPlayers == 0)
+    {
+        auto state = initial;
+        if (numPlies > 0)
+        {
+            state.restore(checkpoints.back());
+            for (auto i = numPlies - kNumPlayers; i < numPlies; ++i)
+                state.playCardUnchecked(record.plays()[i]);
+        }
+        checkpoints.push_back(state.trickCheckpoint());
+    }
+    return GameReplay{std::move(record), std::move(initial), std::move(checkpoints)};
+}
+
+auto GameReplay::stateAt(unsigned ply) const -> GState
+{
+    auto state = mInitial;
+    seek(ply, state);
+    return state;
+}
+
+auto GameReplay::seek(unsigned ply, GState& state) const -> void
+{
+    if (ply > numPlies())
+        throw std::out_of_range(fmt::format("Ply {} is past the end of a game of {} plies", ply, numPlies()));
+
+    const auto trick = ply / kNumPlayers;
+    state.restore(mCheckpoints.at(trick));
+    const auto& plays = mRecord.plays();
+    for (auto i = trick * kNumPlayers; i < ply; ++i)
+        state.playCardUnchecked(plays[i]);
+}
+
+auto forEachPly(GameRecordReader& reader, const GameRecord::PlyVisitor& visit) -> uint64_t
+{
+    auto games = uint64_t{};
+    auto encoded = std::vector<uint8_t>{};
+    while (reader.next(encoded))
+    {
+        GameRecord::decode(encoded.data(), encoded.size(), visit);
+        ++games;
+    }
+    return games;
+}
+
+} // namespace pho::gstate
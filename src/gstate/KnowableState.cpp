@@ -0,0 +1,131 @@
+#include "gstate/KnowableState.hpp"
+
+#include "gstate/BeliefState.hpp"
+#include "prim/hash.hpp"
+
+namespace pho::gstate {
+
+namespace {
+// Each card's byte says where the seat knows the card to be. An unplayed card the seat cannot place is zero.
+constexpr uint8_t kPlayed = 0x10; // the low two bits are the player who played it
+constexpr uint8_t kTaken = 0x20; // bits 2-3 are the player who took it
+constexpr uint8_t kHeld = 0x40; // in the seat's hand
+constexpr uint8_t kPassed = 0x80; // passed by the seat, or to it when the seat holds or played it
+constexpr unsigned kTakerShift = 2;
+
+constexpr unsigned kBidBits = 4;
+} // namespace
+
+KnowableState::KnowableState(const GState& state, PlayerNum seat)
+: mSeat{seat}
+, mBehavior{state.behavior()}
+, mPosition{}
+, mHand{}
+, mPassed{}
+, mReceived{}
+, mHandSizes{}
+, mEncoding{}
+, mHash{}
+{
+    if (!state.gameStarted())
+        throw std::invalid_argument("A KnowableState requires a game that has started");
+    if (seat >= kNumPlayers)
+        throw std::invalid_argument(fmt::format("Invalid seat {}", seat));
+
+    mPosition = state.position();
+    mHand = state.playersHand(seat);
+    mPassed = state.passedBy(seat);
+    mReceived = state.passedBy(passedFrom());
+    for (auto p : prim::range(kNumPlayers))
+        mHandSizes.at(p) = uint8_t(state.playersHand(p).size());
+
+    mEncoding = encode();
+    mHash = prim::hash64(mEncoding.cards.data(), mEncoding.cards.size(), mEncoding.header);
+}
+
+auto KnowableState::knownHand(PlayerNum p) const -> CardSet
+{
+    if (p == mSeat)
+        return hand();
+    if (passOffset() != 0 && p == passedTo())
+        return passed() & unplayedCards();
+    return CardSet{};
+}
+
+auto KnowableState::unplayedCards() const -> CardSet
+{
+    auto unplayed = CardSet::fullDeck();
+    for (auto p : prim::range(kNumPlayers))
+        unplayed -= mPosition.played.at(p);
+    return unplayed;
+}
+
+auto KnowableState::unknownCards() const -> CardSet
+{
+    return unplayedCards() - hand() - (passOffset() != 0 ? passed() : CardSet{});
+}
+
+auto KnowableState::encode() const -> Encoding
+{
+    auto result = Encoding{};
+    for (auto card : hand())
+        result.cards[card.ord()] |= kHeld;
+    for (auto card : passed() + received())
+        result.cards[card.ord()] |= kPassed;
+    for (auto p : prim::range(kNumPlayers))
+    {
+        for (auto card : playedBy(p))
+            result.cards[card.ord()] |= kPlayed | uint8_t(p);
+        for (auto card : takenBy(p))
+            result.cards[card.ord()] |= kTaken | uint8_t(p << kTakerShift);
+    }
+
+    auto bids = uint64_t{};
+    for (auto p : prim::range(kNumPlayers))
+    {
+        assert(this->bids()[p] < (1u << kBidBits));
+        bids |= uint64_t(this->bids()[p]) << (p * kBidBits);
+    }
+    result.header = uint64_t(mSeat) | uint64_t(passOffset()) << 2 | uint64_t(variant()) << 4
+        | uint64_t(playIndex()) << 6 | uint64_t(currentPlayer()) << 12 | uint64_t(playerVoids().bits()) << 14
+        | bids << 30;
+    return result;
+}
+
+auto KnowableState::consistent(const FourHands& hands) const -> bool
+{
+    auto all = CardSet{};
+    for (auto p : prim::range(kNumPlayers))
+    {
+        const auto held = hands.at(p);
+        if (held.size() != handSize(p) || !(all & held).empty() || (held & knownHand(p)) != knownHand(p))
+            return false;
+        for (auto suit : allSuits)
+        {
+            if (playerVoids().isVoid(p, suit) && !held.cardsWithSuit(suit).empty())
+                return false;
+        }
+        all += held;
+    }
+    return all == unplayedCards();
+}
+
+auto KnowableState::determinize(const FourHands& hands, const math::RandomGenerator& rng) const -> GState
+{
+    if (!consistent(hands))
+        throw std::invalid_argument(fmt::format("The hands are not consistent with what seat {} knows", mSeat));
+    auto passes = FourHands{};
+    if (passOffset() != 0)
+    {
+        passes.at(mSeat) = mPassed;
+        passes.at(passedFrom()) = mReceived;
+    }
+    return GState{mPosition, hands, passes, mSeat, mBehavior, rng};
+}
+
+auto KnowableState::determinize(const math::RandomGenerator& rng) const -> GState
+{
+    return determinize(WorldSampler{*this}(rng), rng);
+}
+
+} // namespace pho::gstate
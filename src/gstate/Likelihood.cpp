@@ -0,0 +1,63 @@
+#include "gstate/Likelihood.hpp"
+
+namespace pho::gstate {
+
+namespace likelihoods {
+
+namespace {
+// The likelihood of a deterministic policy that plays choose(legal plays).
+template <typename Choose>
+auto deterministic(Choose choose) -> PlayLikelihood
+{
+    return [choose](const GState& before, Card card, const std::vector<CardSet>& hands) {
+        auto result = std::vector<double>(hands.size());
+        for (auto i : prim::range(hands.size()))
+        {
+            const auto legal = before.legalPlaysFor(hands[i]);
+            result[i] = !legal.empty() && choose(legal) == card ? 1.0 : 0.0;
+        }
+        return result;
+    };
+}
+} // namespace
+
+auto random() -> PlayLikelihood
+{
+    return [](const GState& before, Card card, const std::vector<CardSet>& hands) {
+        auto result = std::vector<double>(hands.size());
+        for (auto i : prim::range(hands.size()))
+        {
+            const auto legal = before.legalPlaysFor(hands[i]);
+            result[i] = legal.hasCard(card) ? 1.0 / double(legal.size()) : 0.0;
+        }
+        return result;
+    };
+}
+
+auto front() -> PlayLikelihood
+{
+    return deterministic([](CardSet legal) { return legal.front(); });
+}
+
+auto back() -> PlayLikelihood
+{
+    return deterministic([](CardSet legal) { return legal.back(); });
+}
+
+auto mixture(PlayLikelihood model, double epsilon) -> PlayLikelihood
+{
+    if (epsilon < 0.0 || epsilon > 1.0)
+        throw std::invalid_argument(fmt::format("The mixture epsilon {} is not a probability", epsilon));
+    return [model = std::move(model), epsilon, uniform = random()](
+               const GState& before, Card card, const std::vector<CardSet>& hands) {
+        auto result = model(before, card, hands);
+        const auto noise = uniform(before, card, hands);
+        for (auto i : prim::range(hands.size()))
+            result[i] = (1.0 - epsilon) * result[i] + epsilon * noise[i];
+        return result;
+    };
+}
+
+} // namespace likelihoods
+
+} // namespace pho::gstate
@@ -0,0 +1,107 @@
+#include "gstate/Policy.hpp"
+#include "prim/range.hpp"
+
+#include <map>
+#include <stdexcept>
+
+namespace pho::gstate {
+
+namespace policies {
+
+auto random() -> Policy
+{
+    return [](const GState& state, const math::RandomGenerator& rng) -> Card {
+        auto legal = state.legalPlays();
+        return legal.nthCard(unsigned(rng.range64(legal.size())));
+    };
+}
+
+auto front() -> Policy
+{
+    return [](const GState& state, const math::RandomGenerator&) -> Card { return state.legalPlays().front(); };
+}
+
+auto back() -> Policy
+{
+    return [](const GState& state, const math::RandomGenerator&) -> Card { return state.legalPlays().back(); };
+}
+
+namespace {
+auto registry() -> const std::map<std::string, Policy>&
+{
+    static const auto kPolicies = std::map<std::string, Policy>{
+        {"random", random()},
+        {"front", front()},
+        {"back", back()},
+    };
+    return kPolicies;
+}
+} // namespace
+
+auto named(const std::string& name) -> Policy
+{
+    auto it = registry().find(name);
+    if (it == registry().end())
+        throw std::invalid_argument(fmt::format("Unrecognized policy name: {}", name));
+    return it->second;
+}
+
+auto names() -> std::vector<std::string>
+{
+    auto result = std::vector<std::string>{};
+    for (const auto& entry : registry())
+        result.push_back(entry.first);
+    return result;
+}
+
+} // namespace policies
+
+auto namedVariant(const std::string& name) -> GameVariant
+{
+    static const auto kVariants
+        = std::map<std::string, GameVariant>{{"standard", standard}, {"jack", jack}, {"spades", spades}};
+    auto it = kVariants.find(name);
+    if (it == kVariants.end())
+        throw std::invalid_argument(fmt::format("Unrecognized variant: {}", name));
+    return it->second;
+}
+
+auto playout(GState& state, const Policy& policy, const math::RandomGenerator& rng) -> void
+{
+    assert(state.gameStarted());
+    while (!state.outcomeDecided())
+        state.playCard(policy(state, rng));
+    state.fastForward();
+}
+
+auto randomPass(CardSet hand, const math::RandomGenerator& rng) -> CardSet
+{
+    assert(hand.size() == kCardsPerHand);
+    auto result = CardSet{};
+    for (auto i : prim::range(3))
+    {
+        (void)i;
+        auto card = hand.nthCard(unsigned(rng.range64(hand.size())));
+        result += card;
+        hand -= card;
+    }
+    return result;
+}
+
+auto randomState(GameBehavior behavior, PassOffset passOffset, unsigned plays, const math::RandomGenerator& rng)
+    -> GState
+{
+    GState state{GState::Init{Deal::randomDealIndex(rng), passOffset}, std::move(behavior), rng};
+    if (passOffset != 0)
+    {
+        for (auto p : prim::range(kNumPlayers))
+            state.setPassFor(p, randomPass(state.playersHand(p), rng));
+    }
+    state.startGame();
+    const auto policy = policies::random();
+    while (state.playIndex() < plays)
+        state.playCard(policy(state, rng));
+    return state;
+}
+
+} // namespace pho::gstate
@@ -12,6 +12,16 @@ namespace {
 DLog dlog("ScoreResult");
 }
 
+auto ScoreResult::fromTotals(const Totals& totals) -> ScoreResult
+{
+    auto result = ScoreResult{};
+    result.mWinPts = totals.winPts;
+    result.mZms = totals.zms;
+    result.N = totals.count;
+    result.kScoreType = totals.scoreType;
+    return result;
+}
+
 ScoreResult& ScoreResult::operator+=(const ScoreResult& other)
 {
     if (N == 0)
@@ -58,10 +68,9 @@ ScoreResult& ScoreResult::teamUpdate(const GState& game, unsigned p1, unsigned p
     assert(p1 != p2);
     assert(p1 < 4 && p2 < 4);
 
-    auto result1 = game.getPlayerOutcome(p1);
-    auto result2 = game.getPlayerOutcome(p2);
-    auto teamZms = result1.zms + result2.zms;
-    auto teamWin = result1.winPts + result2.winPts;
+    const auto& outcome = game.outcome();
+    auto teamZms = outcome.scores[p1] + outcome.scores[p2];
+    auto teamWin = outcome.winPts[p1] + outcome.winPts[p2];
     dlog("teamZms: {}\n", teamZms);
     dlog("teamWin: {}\n", teamWin);
     assert(teamWin >= 0.0 && teamWin <= 1.0);
@@ -83,16 +92,18 @@ auto ScoreResult::winFraction() const -> double
         return 0.5;
 }
 
-auto ScoreResult::eloDelta() const -> double
+auto ScoreResult::eloScore() const -> double
 {
     auto win = winFraction();
     if (kScoreType == eSolo)
         win *= 2.0;
     else
         win *= 1.0;
-    return math::eloDelta(win);
+    return win;
 }
 
+auto ScoreResult::eloDelta() const -> double { return math::eloDelta(eloScore()); }
+
 auto ScoreResult::opponentWinFraction() const -> double
 {
     auto win = 1.0 - winFraction();
@@ -0,0 +1,93 @@
+#include "gstate/Sprt.hpp"
+#include "math/elo.hpp"
+
+#include <cmath>
+#include <fmt/format.h>
+#include <limits>
+#include <stdexcept>
+
+namespace pho::gstate {
+
+Sprt::Sprt(const SprtConfig& config)
+: mConfig{config}
+, mMean0{math::inverseEloDelta(config.elo0)}
+, mMean1{math::inverseEloDelta(config.elo1)}
+, mLower{std::log(config.beta / (1 - config.alpha))}
+, mUpper{std::log((1 - config.beta) / config.alpha)}
+{
+    if (!(config.alpha > 0 && config.alpha < 0.5) || !(config.beta > 0 && config.beta < 0.5))
+        throw std::invalid_argument(
+            fmt::format("SPRT error rates must be in (0, 0.5), not alpha {} beta {}", config.alpha, config.beta));
+    if (config.elo0 == config.elo1)
+        throw std::invalid_argument(fmt::format("SPRT hypotheses must differ, not both {}", config.elo0));
+}
+
+auto Sprt::llr(const stats::RunningStats& samples) const -> double
+{
+    if (samples.size() < 2)
+        return 0.0;
+    const auto variance = samples.variance();
+    if (!(variance > 0))
+        return 0.0;
+    const auto n = double(samples.size());
+    return n * (mMean1 - mMean0) * (2 * samples.mean() - mMean0 - mMean1) / (2 * variance);
+}
+
+auto Sprt::decide(const stats::RunningStats& samples) const -> Decision
+{
+    const auto ratio = llr(samples);
+    if (ratio >= mUpper)
+        return eAcceptH1;
+    if (ratio <= mLower)
+        return eAcceptH0;
+    return eContinue;
+}
+
+auto toString(Sprt::Decision decision) -> const char*
+{
+    switch (decision)
+    {
+        case Sprt::eAcceptH0:
+            return "H0";
+        case Sprt::eAcceptH1:
+            return "H1";
+        default:
+            return "-";
+    }
+}
+
+auto confidenceSequence(const stats::RunningStats& samples, double alpha, double tuneSamples)
+    -> std::pair<double, double>
+{
+    if (!(alpha > 0 && alpha < 1))
+        throw std::invalid_argument(fmt::format("Confidence sequence alpha must be in (0, 1), not {}", alpha));
+    if (!(tuneSamples > 0))
+        throw std::invalid_argument(
+            fmt::format("Confidence sequence tuneSamples must be positive, not {}", tuneSamples));
+
+    constexpr auto kInfinity = std::numeric_limits<double>::infinity();
+    if (samples.size() < 2)
+        return {-kInfinity, kInfinity};
+
+    const auto n = double(samples.size());
+    const auto mean = samples.mean();
+    const auto variance = samples.variance();
+    if (!(variance > 0))
+        return {mean, mean};
+
+    const auto intrinsic = n * variance;
+    const auto rho = variance * tuneSamples;
+    const auto boundary = std::sqrt((intrinsic + rho) * (std::log((intrinsic + rho) / rho) + 2 * std::log(2 / alpha)));
+    const auto radius = boundary / n;
+    return {mean - radius, mean + radius};
+}
+
+auto eloConfidenceSequence(const stats::RunningStats& samples, double alpha, double tuneSamples)
+    -> std::pair<double, double>
+{
+    // eloDelta() is increasing, so it maps the interval of the mean score to the interval of the Elo delta.
+    const auto [low, high] = confidenceSequence(samples, alpha, tuneSamples);
+    return {math::eloDelta(low), math::eloDelta(high)};
+}
+
+} // namespace pho::gstate
@@ -0,0 +1,104 @@
+#include "gstate/SuitSymmetry.hpp"
+
+#include <algorithm>
+
+namespace pho::gstate {
+
+namespace {
+constexpr auto kClubsAndDiamonds = 1u << kClubs | 1u << kDiamonds;
+constexpr auto kPlainSuits = kClubsAndDiamonds | 1u << kHearts;
+// The jack of diamonds scores, so a swap is only safe once neither it nor the jack of clubs it would swap with can
+// still be taken.
+constexpr auto kJacks = CardSet{CardSet::maskOf(kClubs, kJack) | CardSet::maskOf(kDiamonds, kJack)};
+
+auto holding(CardSet cards, Suit suit) -> uint16_t
+{
+    return uint16_t((cards.asBits() & CardSet::maskOfSuit(suit)) >> (suit * kCardsPerSuit));
+}
+
+// The permutation that moves the interchangeable suits into ascending suit order by descending key.
+template <typename Key>
+auto sortingPermutation(unsigned suits, const std::array<Key, kSuitsPerDeck>& keys) -> SuitPermutation
+{
+    auto members = std::array<Suit, kSuitsPerDeck>{};
+    auto count = 0u;
+    for (auto suit : {kClubs, kDiamonds, kSpades, kHearts})
+    {
+        if (suits & (1u << suit))
+            members[count++] = suit;
+    }
+    auto sorted = members;
+    std::stable_sort(sorted.begin(), sorted.begin() + count, [&keys](Suit a, Suit b) { return keys[a] > keys[b]; });
+
+    auto image = SuitPermutation{}.image();
+    for (auto i : prim::range(count))
+        image[sorted[i]] = members[i];
+    return SuitPermutation{image};
+}
+} // namespace
+
+auto interchangeableSuitsAtDeal(GameVariant variant) -> unsigned { return variant == spades ? kPlainSuits : 0u; }
+
+auto interchangeableSuits(const GState& state) -> unsigned
+{
+    switch (state.behavior().variant())
+    {
+        case spades:
+            return kPlainSuits;
+        case standard:
+            return state.gameStarted() && state.playIndex() > 0 ? kClubsAndDiamonds : 0u;
+        case jack:
+            return state.gameStarted() && (state.allTaken() & kJacks) == kJacks ? kClubsAndDiamonds : 0u;
+        default:
+            throw std::invalid_argument("Unrecognized game variant");
+    }
+}
+
+auto canonicalHand(CardSet hand, GameVariant variant) -> CanonicalHand
+{
+    auto keys = std::array<uint16_t, kSuitsPerDeck>{};
+    for (auto suit : allSuits)
+        keys[suit] = holding(hand, suit);
+    const auto permutation = sortingPermutation(interchangeableSuitsAtDeal(variant), keys);
+    return CanonicalHand{permutation(hand), permutation};
+}
+
+auto canonicalState(const GState& state) -> CanonicalState
+{
+    const auto suits = interchangeableSuits(state);
+
+    // Everything the state holds about each suit, most significant first.
+    constexpr auto kKeyLength = 4 * kNumPlayers + 3;
+    auto keys = std::array<std::array<uint16_t, kKeyLength>, kSuitsPerDeck>{};
+    auto currentTrick = CardSet{};
+    auto priorTrick = CardSet{};
+    for (auto i : prim::range(kNumPlayers))
+    {
+        if (state.currentTrick().at(i) != Card::kNone)
+            currentTrick += state.currentTrick().at(i);
+        if (state.priorTrick().at(i) != Card::kNone)
+            priorTrick += state.priorTrick().at(i);
+    }
+    const auto voids = state.playerVoids();
+    for (auto suit : allSuits)
+    {
+        auto& key = keys[suit];
+        auto k = 0u;
+        for (auto p : prim::range(kNumPlayers))
+        {
+            key[k++] = holding(state.playersHand(p), suit);
+            key[k++] = holding(state.passedBy(p), suit);
+            key[k++] = holding(state.playedBy(p), suit);
+            key[k++] = holding(state.takenBy(p), suit);
+        }
+        key[k++] = holding(currentTrick, suit);
+        key[k++] = holding(priorTrick, suit);
+        for (auto p : prim::range(kNumPlayers))
+            key[k] = uint16_t(key[k] << 1 | (voids.isVoid(p, suit) ? 1 : 0));
+    }
+
+    const auto permutation = sortingPermutation(suits, keys);
+    return CanonicalState{permutation.isIdentity() ? state : state.permuteSuits(permutation), permutation};
+}
+
+} // namespace pho::gstate
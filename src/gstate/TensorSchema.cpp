@@ -0,0 +1,126 @@
+#include "gstate/TensorSchema.hpp"
+#include "prim/range.hpp"
+
+namespace pho::gstate::tensor {
+
+namespace {
+auto cardsOnTable(const GState& state) -> CardSet
+{
+    auto result = CardSet{};
+    for (auto pTrick : prim::range(state.playInTrick()))
+        result += state.getTrickPlay(pTrick);
+    return result;
+}
+} // namespace
+
+EncodeContext::EncodeContext(const GState& state)
+: state{state}
+, carl{state.currentPlayer()}
+, legal{state.legalPlays()}
+, hand{state.currentPlayersHand()}
+, passed{state.passedBy(carl) & state.unplayedCards()}
+, unknown{state.unplayedCards() - hand - passed}
+, onTable{cardsOnTable(state)}
+, voids{state.voidsForOthers()}
+, suitProb{}
+{
+    for (Suit suit : allSuits)
+    {
+        if (unknown.cardsWithSuit(suit).empty())
+            continue;
+        unsigned numVoid = voids.CountVoidInSuit(suit);
+        assert(numVoid < 3);
+        suitProb[suit] = 1.0 / (3 - numVoid);
+    }
+}
+
+auto EncodeContext::voidCards(PlayerNum pState) const -> CardSet
+{
+    auto result = CardSet{};
+    for (Suit suit : allSuits)
+    {
+        const auto isVoid = pState == carl ? hand.cardsWithSuit(suit).empty() : voids.isVoid(pState, suit);
+        if (isVoid)
+            result += CardSet{CardSet::maskOfSuit(suit)};
+    }
+    return result;
+}
+
+auto LegalPlays::plan(const EncodeContext& context, ColumnPlan* columns) -> void
+{
+    columns[0].ones = context.legal.asBits();
+}
+
+auto ProbHasCard::plan(const EncodeContext& context, ColumnPlan* columns) -> void
+{
+    for (auto pMain : prim::range(kWidth))
+    {
+        auto& column = columns[pMain];
+        const auto pState = context.stateSeat(pMain);
+        if (pState == context.carl)
+        {
+            column.ones = context.hand.asBits();
+            continue;
+        }
+        column.scaled = (context.unknown - context.voidCards(pState)).asBits();
+        column.suitScale = context.suitProb;
+        if (pState == context.state.currentPassedTo())
+            column.ones = context.passed.asBits();
+        assert((column.ones & column.scaled) == 0);
+    }
+}
+
+auto TakenBySeat::plan(const EncodeContext& context, ColumnPlan* columns) -> void
+{
+    for (auto pMain : prim::range(kWidth))
+        columns[pMain].ones = context.state.takenBy(context.stateSeat(pMain)).asBits();
+}
+
+auto PointsTakenBySeat::plan(const EncodeContext& context, ColumnPlan* columns) -> void
+{
+    const auto points = context.state.behavior().pointCards();
+    for (auto pMain : prim::range(kWidth))
+        columns[pMain].ones = (context.state.takenBy(context.stateSeat(pMain)) & points).asBits();
+}
+
+auto PlayedBySeat::plan(const EncodeContext& context, ColumnPlan* columns) -> void
+{
+    for (auto pMain : prim::range(kWidth))
+        columns[pMain].ones = context.state.playedBy(context.stateSeat(pMain)).asBits();
+}
+
+auto VoidsBySeat::plan(const EncodeContext& context, ColumnPlan* columns) -> void
+{
+    for (auto pMain : prim::range(kWidth))
+        columns[pMain].ones = context.voidCards(context.stateSeat(pMain)).asBits();
+}
+
+auto PointCards::plan(const EncodeContext& context, ColumnPlan* columns) -> void
+{
+    columns[0].ones = context.state.behavior().pointCards().asBits();
+}
+
+auto CardOnTable::plan(const EncodeContext& context, ColumnPlan* columns) -> void
+{
+    columns[0].ones = context.onTable.asBits();
+}
+
+auto TrickPosition::plan(const EncodeContext& context, ColumnPlan* columns) -> void
+{
+    for (auto pTrick : prim::range(context.state.playInTrick()))
+        columns[pTrick].ones = context.state.getTrickPlay(pTrick).mask();
+}
+
+auto CardLeadingTrick::plan(const EncodeContext& context, ColumnPlan* columns) -> void
+{
+    if (context.state.playInTrick() > 0)
+        columns[0].ones = context.state.getTrickPlay(0).mask();
+}
+
+auto HighCardInTrick::plan(const EncodeContext& context, ColumnPlan* columns) -> void
+{
+    if (context.state.playInTrick() > 0)
+        columns[0].ones = context.state.highCardInTrick().mask();
+}
+
+} // namespace pho::gstate::tensor
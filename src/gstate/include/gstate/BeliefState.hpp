@@ -0,0 +1,148 @@
+#pragma once
+
+#include "gstate/GState.hpp"
+#include "gstate/KnowableState.hpp"
+#include "gstate/Likelihood.hpp"
+
+#include <vector>
+
+namespace pho::gstate {
+
+// Samples the hands of a game in progress uniformly from the worlds consistent with what one player knows: their own
+// hand, the cards they passed that the receiver has not yet played, the number of cards each player holds and the
+// voids the other players have revealed.
+//
+// The count of consistent worlds is computed up front by dynamic programming over the suits, with the opponents'
+// remaining capacities as the state, so every draw is exact and needs no rejection.
+class WorldSampler
+{
+public:
+    // Requires state.gameStarted(). Throws std::runtime_error if no world is consistent.
+    WorldSampler(const GState& state, PlayerNum observer);
+    explicit WorldSampler(const KnowableState& known);
+
+    // The number of consistent worlds.
+    auto worlds() const -> double { return ways(0, mCapacities); }
+
+    auto operator()(const math::RandomGenerator& rng) const -> FourHands;
+
+private:
+    static constexpr unsigned kOthers = kNumPlayers - 1;
+    using Capacities = std::array<unsigned, kOthers>;
+
+    auto ways(unsigned suit, const Capacities& capacities) const -> double;
+    auto ways(unsigned suit, const Capacities& capacities) -> double&;
+
+    // Call visit(split, ways) for each way to split the unknown cards of the suit among the others within capacities,
+    // until it returns true.
+    template <typename Visit>
+    auto forEachSplit(unsigned suit, const Capacities& capacities, Visit visit) const -> void;
+
+    FourHands mKnown;
+    std::array<PlayerNum, kOthers> mOthers;
+    Capacities mCapacities;
+    std::array<CardSet, kSuitsPerDeck> mUnknown;
+    std::array<unsigned, kSuitsPerDeck> mAllowed; // bit j set when the j-th other player may hold the suit
+    std::vector<double> mWays; // by suit and capacities: the ways to deal the unknown cards of this and later suits
+};
+
+struct BeliefConfig
+{
+    // The number of worlds to hold.
+    size_t particles{1000};
+
+    // Refill the worlds from a WorldSampler when fewer than this fraction of them survive an update.
+    double refillBelow{0.5};
+
+    // Resample the worlds in proportion to their weights when the effective sample size falls below this fraction
+    // of their number.
+    double resampleBelow{0.5};
+};
+
+struct Particle
+{
+    FourHands hands;
+    double weight;
+};
+
+// One player's belief about the hands of the other players, held as a weighted set of sampled worlds (particles) and
+// carried from one decision to the next.
+//
+// Each update drops the worlds contradicted by the plays since the last update: a world in which a player did not hold
+// the card they played, or holds a card of a suit they have since shown out of. The survivors are still uniform over
+// the consistent worlds, so they are kept, and new worlds are sampled only when too few survive. Searches such as PIMC
+// take their worlds from sample() instead of sampling every world afresh at every decision.
+//
+// Given a PlayLikelihood, the plays are also evidence about the hands: each world's weight is multiplied by the
+// likelihood of every play the other players make in it, with one call over all the worlds per play. When the weight
+// concentrates on a few worlds, i.e. the effective sample size drops, the worlds are resampled by weight. Worlds
+// sampled to refill the set are weighted by the likelihood of every play since the belief was created. If a player
+// strays from the model so far that no world survives, the belief starts over from uniformly weighted worlds and
+// weighs only the plays after that.
+class BeliefState
+{
+public:
+    // Requires state.gameStarted().
+    BeliefState(const GState& state, PlayerNum observer, const BeliefConfig& config, const math::RandomGenerator& rng,
+        PlayLikelihood likelihood = {});
+
+    auto observer() const -> PlayerNum { return mObserver; }
+
+    auto particles() const -> const std::vector<Particle>& { return mParticles; }
+
+    // The weights are kept at an average of one.
+    auto totalWeight() const -> double;
+
+    // The number of equally weighted worlds the weighted worlds are worth: (sum of weights)^2 / sum of squared weights.
+    auto effectiveSampleSize() const -> double;
+
+    // Bring the belief up to date with `state`, a later state of the same game. The plays since the last update are
+    // taken from the current and prior tricks of `state`, so the belief must be updated at least once a trick.
+    // Throws std::invalid_argument when it was not.
+    auto update(const GState& state) -> void;
+
+    // A world, drawn in proportion to the weights.
+    auto sample(const math::RandomGenerator& rng) const -> const FourHands&;
+
+    struct Stats
+    {
+        uint64_t sampled; // worlds drawn from a WorldSampler
+        uint64_t rejected; // worlds dropped by updates, or given no weight by the likelihood
+        uint64_t resamples; // times the worlds were resampled by weight
+        uint64_t likelihoodBatches; // calls to the likelihood
+        uint64_t resets; // times the likelihood ruled out every world and its history was dropped
+    };
+
+    auto stats() const -> const Stats& { return mStats; }
+
+private:
+    // A play by one of the other players, with the state before it.
+    struct Observed
+    {
+        GState before;
+        Card card;
+    };
+
+    // The plays made since `mLast`, in order.
+    auto playsSince(const GState& state) const -> std::vector<Card>;
+
+    // Apply the play of `card` by the current player of `before` to the worlds.
+    auto observe(const GState& before, Card card) -> void;
+
+    // Multiply the weights by the likelihoods and drop the worlds they rule out.
+    auto reweight(const std::vector<double>& likelihoods) -> void;
+
+    auto resample() -> void;
+    auto refill(const GState& state) -> void;
+
+    PlayerNum mObserver;
+    BeliefConfig mConfig;
+    math::RandomGenerator mRng;
+    PlayLikelihood mLikelihood;
+    GState mLast; // the state at the last update
+    std::vector<Observed> mHistory; // the other players' plays, kept only when there is a likelihood
+    std::vector<Particle> mParticles;
+    Stats mStats;
+};
+
+} // namespace pho::gstate
@@ -0,0 +1,174 @@
+#pragma once
+
+#include "gstate/GState.hpp"
+#include "prim/MappedFile.hpp"
+
+#include <string>
+#include <vector>
+
+namespace pho::gstate {
+
+// An exact solver for the last few tricks of a game with every hand known, as in a determinized world.
+//
+// Each player plays to minimize their own final score (a max^n search, ties going to the lowest card), which is the
+// solution GState::outcome() would score. In Spades each player maximizes their tricks and bids are ignored, for the
+// reasons given in GState::getSpadesOutcome().
+//
+// The search runs on the four hands as 64-bit masks and memoizes the result of every trick boundary it reaches. The
+// memo key is canonical, so that positions recurring across sampled worlds and across games share one entry:
+//  - seats are numbered from the leader of the trick,
+//  - within each suit only the order of the remaining cards matters, so ranks are compressed to their order, with
+//    the queen of spades (and in the jack variant the jack of diamonds) marked by its position,
+//  - the points taken so far are reduced to their class: no one, only one player, or more than one player. This is
+//    all that matters for a shoot of the moon; with the cards remaining it determines the exact tally when it matters.
+// A memo table can be saved and later memory-mapped (see MappedEndgameTable) to start with the positions solved before.
+// Saving and mapping are not built for WebAssembly.
+
+constexpr unsigned kMaxEndgameTricks = 4;
+
+struct EndgameKey
+{
+    uint64_t lo; // the number of remaining cards per suit, then the seat of each card by suit and ascending rank
+    uint64_t hi; // a marker bit, the points-so-far class, whether points are broken and the special cards
+
+    auto operator==(const EndgameKey& other) const -> bool = default;
+};
+
+// The solution of a position at a trick boundary, by seat relative to the leader.
+struct EndgameValue
+{
+    std::array<uint8_t, kNumPlayers> taken; // the points taken in the remaining tricks (tricks in Spades)
+    uint8_t tookJack; // the seat that takes the jack of diamonds in the remaining tricks, or kNumPlayers
+    uint8_t best; // the best lead, as suit << 4 | the order of the card among the remaining cards of its suit
+};
+
+struct EndgameEntry
+{
+    EndgameKey key; // key.hi == 0 for an empty slot
+    EndgameValue value;
+    uint8_t reserved[2];
+};
+static_assert(sizeof(EndgameEntry) == 24);
+
+// An endgame table file is a 64-byte EndgameTableHeader followed by the `capacity` slots of the open-addressing hash
+// table, empty slots included, so that it can be probed in place once mapped.
+struct EndgameTableHeader
+{
+    static constexpr char kMagic[8] = {'P', 'H', 'O', 'E', 'N', 'D', 'G', 'M'};
+    static constexpr uint32_t kVersion = 1;
+
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t entrySize;
+    uint32_t variant; // a GameVariant
+    uint64_t capacity; // the number of slots, a power of two
+    uint64_t count; // the number of occupied slots
+    uint64_t checksum; // prim::hash64 of the slots
+    uint64_t reserved[2];
+};
+static_assert(sizeof(EndgameTableHeader) == 64);
+
+class MappedEndgameTable;
+
+// A growable in-memory memo table.
+class EndgameTable
+{
+public:
+    explicit EndgameTable(GameVariant variant, uint64_t capacity = uint64_t{1} << 12);
+
+    auto variant() const -> GameVariant { return mVariant; }
+    auto size() const -> uint64_t { return mCount; }
+    auto capacity() const -> uint64_t { return mEntries.size(); }
+
+    auto find(const EndgameKey& key) const -> const EndgameValue*;
+    auto insert(const EndgameKey& key, const EndgameValue& value) -> void;
+
+    // Copy every entry of a mapped table of the same variant, e.g. to extend it and save it again.
+    auto insertAll(const MappedEndgameTable& table) -> void;
+
+#if !__EMSCRIPTEN__
+    // Write the table, replacing any file at path. Throws std::runtime_error on failure.
+    auto save(const std::string& path) const -> void;
+#endif
+
+private:
+    auto grow() -> void;
+
+    GameVariant mVariant;
+    uint64_t mCount;
+    std::vector<EndgameEntry> mEntries;
+};
+
+// A read-only, memory-mapped endgame table. Lookups are thread-safe, so one table can serve every solver.
+class MappedEndgameTable
+{
+public:
+#if !__EMSCRIPTEN__
+    // Validates the header and maps the file. Throws std::runtime_error on failure.
+    explicit MappedEndgameTable(const std::string& path, bool verifyChecksum = false);
+#endif
+
+    auto variant() const -> GameVariant { return GameVariant(mHeader.variant); }
+    auto size() const -> uint64_t { return mHeader.count; }
+    auto capacity() const -> uint64_t { return mHeader.capacity; }
+
+    auto find(const EndgameKey& key) const -> const EndgameValue*;
+
+    // The slots, capacity() of them.
+    auto entries() const -> const EndgameEntry* { return mEntries; }
+
+private:
+    prim::MappedFile mFile;
+    EndgameTableHeader mHeader;
+    const EndgameEntry* mEntries;
+};
+
+class EndgameSolver
+{
+public:
+    // The solver looks positions up in `persisted` first, if given, and memoizes new ones in its own table.
+    // Throws std::invalid_argument if the persisted table is for another variant.
+    explicit EndgameSolver(GameVariant variant, const MappedEndgameTable* persisted = nullptr);
+
+    // True when the state is a started game with at most kMaxEndgameTricks tricks left, counting the current one.
+    static auto canSolve(const GState& state) -> bool;
+
+    // The current player's play in the solution. Requires canSolve(state).
+    auto bestPlay(const GState& state) -> Card;
+
+    // Play the solution to the end of the game. Requires canSolve(state).
+    auto solve(GState& state) -> void;
+
+    // The outcome of the solution. Requires canSolve(state).
+    auto outcome(const GState& state) -> GState::Outcome;
+
+    // The positions solved by this solver, to save for later runs.
+    auto memo() const -> const EndgameTable& { return mMemo; }
+
+    struct Stats
+    {
+        uint64_t persistedHits;
+        uint64_t memoHits;
+        uint64_t solved;
+    };
+
+    auto stats() const -> const Stats& { return mStats; }
+
+private:
+    struct Node;
+
+    auto solveBoundary(const std::array<uint64_t, kNumPlayers>& hands, PlayerNum lead, bool broken, uint8_t points,
+        Card* best) -> EndgameValue;
+    auto searchTrick(Node& node, unsigned play, Card* best) -> EndgameValue;
+    auto finishTrick(const Node& node) -> EndgameValue;
+    auto cost(const Node& node, const EndgameValue& value, PlayerNum player) const -> int;
+
+    GameVariant mVariant;
+    uint64_t mPointCards;
+    const MappedEndgameTable* mPersisted;
+    EndgameTable mMemo;
+    Stats mStats;
+};
+
+} // namespace pho::gstate
@@ -5,10 +5,13 @@
 #include "cards/constants.hpp"
 
 #include "cards/FourHands.hpp"
+#include "cards/SuitPermutation.hpp"
 #include "gstate/GameBehavior.hpp"
 #include "gstate/PlayerVoids.hpp"
 #include "gstate/Trick.hpp"
 
+#include "math/random.hpp"
+
 #include "prim/range.hpp"
 
 #include <fmt/format.h>
@@ -19,10 +22,6 @@
 #include <emscripten/val.h>
 #endif
 
-namespace pho::hearts {
-class KState;
-}
-
 namespace pho::gstate {
 
 using namespace pho::cards;
@@ -122,6 +121,13 @@ public:
     GState(const cards::Deal& deal, PassOffset passOffset = Init::kRandomPassOffset, GameBehavior behavior = kStandard);
     GState(const GState&) = default;
 
+    // Like the above, but every random choice made for the game comes from `rng`: a random deal index or pass
+    // offset is drawn from it, and the state's own generator (see rng()) is seeded from it. A game created from
+    // RandomGenerator::forStream(seed, gameNumber) is therefore reproducible from (seed, gameNumber) alone,
+    // whichever thread plays it.
+    GState(Init init, GameBehavior behavior, const math::RandomGenerator& rng);
+    GState(const cards::Deal& deal, PassOffset passOffset, GameBehavior behavior, const math::RandomGenerator& rng);
+
 #if __EMSCRIPTEN__
     GState(const GStateInit& init, GameVariant variant);
 #endif
@@ -135,6 +141,10 @@ public:
     auto startGame() -> void;
     auto startGameNoPass() -> void;
 
+    // Start the game with the given player leading the first trick. The first lead is normally chosen by the
+    // GameBehavior; this is for replaying recorded games of variants where it is not determined by the deal.
+    auto startGame(PlayerNum firstLead) -> void;
+
     // Return the index 0..52 for the current play.
     // 0 means the first card (the two of clubs) is to be played.
     // 52 means all cards have been played (the game is over).
@@ -154,12 +164,89 @@ public:
     // Return the set of cards that the current play can play (as allowed by the rules)
     auto legalPlays() const -> CardSet { return mBehavior.legal(*this); }
 
+    // Return the cards in `hand` the current player could play if it were their hand, as when judging their plays in
+    // a sampled world.
+    auto legalPlaysFor(CardSet hand) const -> CardSet { return mBehavior.legal(*this, hand); }
+
     // Play the card (must be legal) and advance the game state to the next player.
     auto playCard(Card card) -> void;
 
+    // Like playCard() but without checking that the card is legal, for replaying plays already known to be legal.
+    auto playCardUnchecked(Card card) -> void;
+
+    // Running totals of what each player has taken, updated as each trick finishes so that outcomes never need to
+    // rescan takenBy().
+    struct TakenTally
+    {
+        std::array<uint8_t, kNumPlayers> tricks;
+        std::array<uint8_t, kNumPlayers> hearts;
+        std::array<uint8_t, kNumPlayers> points; // standard Hearts points: one per heart and 13 for the queen
+        uint8_t tookQueen;                       // kNumPlayers until the queen of spades is taken
+        uint8_t tookJack;                        // kNumPlayers until the jack of diamonds is taken
+
+        static constexpr auto kNoOne = uint8_t{kNumPlayers};
+        static constexpr auto empty() -> TakenTally { return TakenTally{{}, {}, {}, kNoOne, kNoOne}; }
+    };
+
+    auto tally() const -> const TakenTally& { return mTally; }
+
+    // A compact snapshot of the play state at the start of a trick. Everything else about a game in progress is
+    // fixed once the game has started, so any state of the same game can be restored to the checkpoint.
+    struct TrickCheckpoint
+    {
+        FourHands played;
+        FourHands taken;
+        TakenTally tally;
+        Trick priorTrick;
+        PlayerVoids::Rep voids;
+        uint8_t playIndex;
+        uint8_t lead;
+    };
+
+    // Requires playInTrick() == 0.
+    auto trickCheckpoint() const -> TrickCheckpoint;
+
+    // Restore this state, which must be a started state of the same game, to the checkpoint.
+    auto restore(const TrickCheckpoint& checkpoint) -> void;
+
+    // The public part of a started game: everything but the hands and the passes.
+    struct Position
+    {
+        PassOffset passOffset;
+        FourHands played; // as playedBy(), including the cards of the current trick
+        FourHands taken;
+        PlayerVoids voids;
+        Trick trick;
+        Trick priorTrick;
+        std::array<uint8_t, kNumPlayers> bids;
+    };
+
+    // Requires gameStarted().
+    auto position() const -> Position;
+
+    // A started game in the position with the given hands, as `observer` might imagine it. `passed` holds the cards the
+    // observer passed and those passed to them; the other passes are chosen at random to fit the hands (see
+    // alternate()). The state has no deal index.
+    GState(const Position& position, const FourHands& hands, const FourHands& passed, PlayerNum observer,
+        GameBehavior behavior, const math::RandomGenerator& rng);
+
     // Return true when all cards have been played.
     auto done() const -> bool { return mPlayIndex == kCardsPerDeck; }
 
+    // Return true when no way of playing the remaining cards can change any player's score. For Hearts this is
+    // once all the point cards (and in the jack variant the jack of diamonds) have been taken. For Spades without
+    // bids every trick counts, and with bids a player who made their bid still scores each overtrick, so the
+    // outcome is decided early only when every player has failed their bid.
+    auto outcomeDecided() const -> bool;
+
+    // For Spades with bids, return true when every player has either made their bid or can no longer make it.
+    // The scores may still change by overtricks. Always false when no bids were set.
+    auto bidsDecided() const -> bool;
+
+    // Finish a game whose outcomeDecided() without playing the remaining cards. They are all credited to the
+    // leader of the current trick, so the outcome is exact but takenBy() and playedBy() do not reflect real play.
+    auto fastForward() -> void;
+
     // Return the player number of the player that the current player passed to (or will pass to)
     // at the beginning of the game. Will return the current player's own player number when cards were held
     // as dealt.
@@ -181,6 +268,9 @@ public:
 
     auto takenBy(PlayerNum player) const -> CardSet { return mTaken.at(player); }
 
+    // The cards the player has played so far, including a card on the table in the current trick.
+    auto playedBy(PlayerNum player) const -> CardSet { return mCardsPlayed.at(player); }
+
     using ProbRow = std::array<float, kNumPlayers>;
     using ProbArray = std::array<ProbRow, kCardsPerDeck>;
     auto asProbabilities() const -> ProbArray;
@@ -221,48 +311,71 @@ public:
     };
 
     using PlayerScores = std::array<float, kNumPlayers>;
-    auto getPlayerScores() const -> PlayerScores
+
+    // The outcome for all four players. It is computed once, when the last trick finishes.
+    struct Outcome
     {
-        auto outcome = getVariantOutcomeRep();
-        return std::visit([](auto&& arg) { return arg.normalizedScores(); }, outcome);
-    }
+        VariantOutcomeRep rep;
+        PlayerScores scores;
+        PlayerScores winPts;
+    };
 
-    auto getPlayerOutcome(unsigned p) const -> PlayerOutcome
+    // Requires done().
+    auto outcome() const -> const Outcome&
     {
-        auto outcome = getVariantOutcomeRep();
-        return std::visit(
-            [p](auto&& arg) {
-                return PlayerOutcome{arg.normalizedScore(p), arg.playerOutcomeResult(p)};
-            },
-            outcome);
+        assert(done());
+        return mOutcome;
     }
 
+    // These read the cached outcome when the game is done, and otherwise compute the outcome so far from the tally.
+    auto getPlayerScores() const -> PlayerScores;
+    auto getPlayerOutcome(unsigned p) const -> PlayerOutcome;
+
     using Bid = uint8_t;
-    void setBid(PlayerNum p, Bid bid)
-    {
-        assert(bid > 0);
-        assert(bid <= 13);
-        mBids[p] = bid;
-    }
+    void setBid(PlayerNum p, Bid bid);
+
+    // The bids, all zero when no bids were set.
+    auto bids() const -> const std::array<Bid, kNumPlayers>& { return mBids; }
 
     auto dealIndex() const -> DealIndex { return mDealIndex; }
 
+    // The generator for random choices the rules make during the game, such as the first lead in Spades.
+    // Copies of a state share the position in the stream at the time of the copy.
+    auto rng() const -> const math::RandomGenerator& { return mRng; }
+
+    // The voids every player has revealed so far.
+    auto playerVoids() const -> PlayerVoids { return mPlayerVoids; }
+
     Trick currentTrick() const { return mTrick; }
     Trick priorTrick() const { return mPriorTrick; }
 
+    // A copy of this state with the suit of every card permuted. The permutation should be a symmetry of the game from
+    // this point on (see gstate/SuitSymmetry.hpp), since the taken tally is not remapped. The copy has no deal index.
+    auto permuteSuits(const SuitPermutation& permutation) const -> GState;
+
+    // A determinization of this started state as `observer` might imagine it: a copy with the given hands, which must
+    // be consistent with what the observer knows (see KnowableState::consistent()). The passes the observer did not
+    // see are chosen at random to fit the hands. The copy has no deal index and its own random stream.
+    auto alternate(const FourHands& hands, PlayerNum observer) const -> GState;
+
+    // The same from the current player's point of view.
+    auto alternate(const FourHands& hands) const -> GState { return alternate(hands, currentPlayer()); }
+
 private:
-    friend hearts::KState;
-    auto alternate(const FourHands& hands) const -> GState;
+    auto adjustPassedState(PlayerNum observer) -> void;
 
-    auto adjustPassedState() -> void;
+    auto exchangePasses() -> void;
+    auto beginPlay(PlayerNum firstLead) -> void;
 
 private:
     auto finishTrick() -> void;
+    auto computeOutcome() const -> Outcome;
 
 private:
     // The members used to represent the game state here are chosen to strke a good balance
     // between minimal redundancy and efficiency.
-    // We prefer efficient updates of state during game play over efficient calculation of the game outcome.
+    // We prefer efficient updates of state during game play, but the few counts needed for the game outcome are
+    // cheap enough to maintain per trick, which makes the outcome free to read once the game is done.
 
     // The index be used to create the original deal (before passing).
     uint128_t mDealIndex;
@@ -287,6 +400,9 @@ private:
     // The cards each player has taken (i.e. from won tricks) so far in the game.
     FourHands mTaken;
 
+    // Counts derived from mTaken, kept in step with it by finishTrick().
+    TakenTally mTally;
+
     // A compact representation (bitset of 4x4 bits) of which players have revealed that they are void per suit
     PlayerVoids mPlayerVoids;
 
@@ -315,6 +431,11 @@ private:
 
     // The bids for each player. This is only used for the "spades" variant.
     std::array<Bid, kNumPlayers> mBids;
+
+    // Valid only when done().
+    Outcome mOutcome;
+
+    math::RandomGenerator mRng;
 };
 
 } // namespace pho::gstate
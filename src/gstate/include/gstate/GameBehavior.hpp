@@ -24,6 +24,13 @@ public:
     /// @brief return the set of cards in the current player's hand that are legal to play
     [[nodiscard]] auto legal(const GState& gameState) const -> CardSet { return mRep->legal(gameState); }
 
+    /// @brief return the set of cards in `hand` that would be legal for the current player to play if it were their
+    /// hand, e.g. to judge the plays of a player in a sampled world
+    [[nodiscard]] auto legal(const GState& gameState, CardSet hand) const -> CardSet
+    {
+        return mRep->legalFor(gameState, hand);
+    }
+
     /// @brief return the (fixed) set of cards that have point value for this game variant
     auto pointCards() const -> CardSet { return mRep->pointCards(); };
 
@@ -75,13 +82,16 @@ private:
         [[nodiscard]] virtual auto pointCards() const -> CardSet = 0;
 
         /// @brief return the set of cards in the current player's hand that are legal to play
-        [[nodiscard]] virtual auto legal(const GState& gameState) const -> CardSet;
+        [[nodiscard]] auto legal(const GState& gameState) const -> CardSet;
+
+        /// @brief return the set of cards in the given hand that are legal for the current player to play
+        [[nodiscard]] virtual auto legalFor(const GState& gameState, CardSet hand) const -> CardSet;
 
-        /// @brief return the cards that are legal to lead with
-        [[nodiscard]] auto legalLeadPlays(const GState& state) const -> CardSet;
+        /// @brief return the cards of the hand that are legal to lead with
+        [[nodiscard]] auto legalLeadPlays(const GState& state, CardSet hand) const -> CardSet;
 
-        /// @brief return the cards that are legal to follow with
-        [[nodiscard]] auto legalFollowPlays(const GState& state) const -> CardSet;
+        /// @brief return the cards of the hand that are legal to follow with
+        [[nodiscard]] auto legalFollowPlays(const GState& state, CardSet hand) const -> CardSet;
 
         [[nodiscard]] virtual auto trickWinner(const Trick& trick) const -> uint32_t;
 
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "gstate/GState.hpp"
+
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace pho::gstate {
+
+// A complete record of one hand: everything needed to replay it exactly.
+//
+// A hand is determined by the variant, the deal index, the pass offset, the three cards each player passed, and
+// the plays. GameRecord::encode() codes each of these as a mixed-radix digit (see math/MixedRadix.hpp):
+//  - each pass is its rank among the C(13,3) = 286 ways to choose three cards of the dealt hand,
+//  - each play is its index within the legalPlays() of the state it was played from, so a forced play costs
+//    nothing and a typical play costs two or three bits.
+// In Spades the first lead and the bids (if any) are recorded too. The encoding starts with its own length, so that a
+// truncated one is rejected. A complete hand of random play takes about 26 bytes, and no more than 41.
+class GameRecord
+{
+public:
+    using Bids = std::array<GState::Bid, kNumPlayers>;
+
+    // An empty record of a standard game with deal index 0 that has not been started. Mainly a target for decode.
+    GameRecord() = default;
+
+    // Start recording a game that has been started but in which no card has been played yet. Throws
+    // std::invalid_argument for a Spades game in which only some players have bid.
+    explicit GameRecord(const GState& started);
+
+    // Record the next play.
+    auto add(Card card) -> void;
+
+    auto variant() const -> GameVariant { return mVariant; }
+    auto dealIndex() const -> DealIndex { return mDealIndex; }
+    auto passOffset() const -> PassOffset { return mPassOffset; }
+    auto passedBy(PlayerNum player) const -> CardSet { return mPassed.at(player); }
+    auto firstLead() const -> PlayerNum { return mFirstLead; }
+    auto bids() const -> const Bids& { return mBids; }
+    auto plays() const -> const std::vector<Card>& { return mPlays; }
+
+    // The started game, before the first play.
+    auto initialState() const -> GState;
+
+    // The game after all the recorded plays.
+    auto replay() const -> GState;
+
+    // The compact encoding. Throws std::invalid_argument if a recorded play was not legal.
+    auto encode() const -> std::vector<uint8_t>;
+
+    // Decode an encoding made by encode(). Throws std::invalid_argument if it is malformed: truncated or extended, with
+    // a deal index out of range, or with digits left over.
+    static auto decode(const uint8_t* data, size_t size) -> GameRecord;
+
+    // Called by decode() for each play, with the state before the play.
+    using PlyVisitor = std::function<void(const GState& state, Card play)>;
+
+    // Decode, calling visit for each play. Decoding replays the game anyway, so this visits every ply of the game
+    // for the cost of decoding it. Plays are replayed with GState::playCardUnchecked() because a decoded play is
+    // legal by construction.
+    static auto decode(const uint8_t* data, size_t size, const PlyVisitor& visit) -> GameRecord;
+
+    auto operator==(const GameRecord& other) const -> bool;
+
+private:
+    GameVariant mVariant{standard};
+    DealIndex mDealIndex{};
+    PassOffset mPassOffset{};
+    FourHands mPassed{};
+    PlayerNum mFirstLead{};
+    Bids mBids{};
+    std::vector<Card> mPlays;
+};
+
+// A game record archive is a small file header followed by the encoded records, each prefixed by its length in
+// one byte. Records can only be read sequentially.
+class GameRecordWriter
+{
+public:
+    explicit GameRecordWriter(const std::string& path);
+    ~GameRecordWriter();
+
+    GameRecordWriter(const GameRecordWriter&) = delete;
+    GameRecordWriter& operator=(const GameRecordWriter&) = delete;
+
+    auto append(const GameRecord& record) -> void;
+
+    // Flush and close the file. Throws std::runtime_error if any write failed.
+    auto close() -> void;
+
+    auto recordsWritten() const -> uint64_t { return mRecordsWritten; }
+    auto bytesWritten() const -> uint64_t { return mBytesWritten; }
+
+private:
+    std::string mPath;
+    FILE* mFile;
+    uint64_t mRecordsWritten;
+    uint64_t mBytesWritten;
+};
+
+class GameRecordReader
+{
+public:
+    // Throws std::runtime_error if the file is not a game record archive.
+    explicit GameRecordReader(const std::string& path);
+    ~GameRecordReader();
+
+    GameRecordReader(const GameRecordReader&) = delete;
+    GameRecordReader& operator=(const GameRecordReader&) = delete;
+
+    // Read the next record into `encoded`. Returns false at the end of the file.
+    // Throws std::runtime_error if the file ends in the middle of a record.
+    auto next(std::vector<uint8_t>& encoded) -> bool;
+
+    // Read and decode the next record. Returns false at the end of the file.
+    auto next(GameRecord& record) -> bool;
+
+private:
+    std::string mPath;
+    FILE* mFile;
+};
+
+} // namespace pho::gstate
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "gstate/GameRecord.hpp"
+
+#include <vector>
+
+namespace pho::gstate {
+
+// Random access to every ply of a recorded game.
+//
+// A GameReplay replays the game once, keeping the started state and a GState::TrickCheckpoint at the start of
+// every trick. Seeking to ply k restores the checkpoint of trick k/4 and replays at most three plays from it,
+// unchecked. The replay holds about 2KB for a complete game.
+class GameReplay
+{
+public:
+    // Replay a record, checking that every play is legal. Throws std::invalid_argument if one is not.
+    explicit GameReplay(const GameRecord& record);
+
+    // Decode an encoded record and replay it in the same pass, without any legality checks.
+    static auto decode(const uint8_t* data, size_t size) -> GameReplay;
+
+    auto record() const -> const GameRecord& { return mRecord; }
+
+    // The number of plies, i.e. plays, in the game. Valid plies for seek() are 0..numPlies().
+    auto numPlies() const -> unsigned { return unsigned(mRecord.plays().size()); }
+
+    // The state before play `ply`, or the final state when ply == numPlies().
+    auto stateAt(unsigned ply) const -> GState;
+
+    // Like stateAt(), but into an existing state of the same game (e.g. from a previous seek), which avoids
+    // copying the unchanging parts of the state.
+    auto seek(unsigned ply, GState& state) const -> void;
+
+private:
+    GameReplay(GameRecord record, GState initial, std::vector<GState::TrickCheckpoint> checkpoints);
+
+    GameRecord mRecord;
+    GState mInitial;
+    std::vector<GState::TrickCheckpoint> mCheckpoints; // mCheckpoints[t] is the state before play 4 * t
+};
+
+// Stream every ply of every game in an archive, calling visit(state, play) with the state before each play.
+// This is the bulk path for feature extraction: each game is decoded and replayed in a single pass.
+// Returns the number of games.
+auto forEachPly(GameRecordReader& reader, const GameRecord::PlyVisitor& visit) -> uint64_t;
+
+} // namespace pho::gstate
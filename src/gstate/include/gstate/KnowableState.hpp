@@ -0,0 +1,103 @@
+#pragma once
+
+#include "gstate/GState.hpp"
+
+#include <array>
+#include <functional>
+
+namespace pho::gstate {
+
+// What one seat knows about a game in progress: their own hand, the cards they passed and received, every card played
+// and who played and took it, the voids revealed and the current trick. It is the information set of the seat, so two
+// states of a game the seat cannot tell apart give equal KnowableStates, with equal encodings and hashes, which makes
+// them usable as keys for ISMCTS nodes and inference caches.
+//
+// The encoding does not keep the order in which earlier tricks were played, only what they revealed, so histories that
+// leave the seat knowing the same about every card share a key.
+class KnowableState
+{
+public:
+    // Requires state.gameStarted(); throws std::invalid_argument otherwise.
+    KnowableState(const GState& state, PlayerNum seat);
+
+    auto seat() const -> PlayerNum { return mSeat; }
+    auto variant() const -> GameVariant { return mBehavior.variant(); }
+    auto passOffset() const -> PassOffset { return mPosition.passOffset; }
+    auto playIndex() const -> PlayIndex { return kCardsPerDeck - unplayedCards().size(); }
+    auto playInTrick() const -> uint32_t { return playIndex() % GState::kPlaysPerTrick; }
+    auto currentPlayer() const -> PlayerNum { return (mPosition.trick.lead() + playInTrick()) % kNumPlayers; }
+    auto done() const -> bool { return playIndex() == kCardsPerDeck; }
+
+    auto hand() const -> CardSet { return mHand; }
+    auto handSize(PlayerNum p) const -> unsigned { return mHandSizes.at(p); }
+
+    // The players the seat passed to and received from, the seat itself when cards were held as dealt.
+    auto passedTo() const -> PlayerNum { return (mSeat + passOffset()) % kNumPlayers; }
+    auto passedFrom() const -> PlayerNum { return (mSeat + kNumPlayers - passOffset()) % kNumPlayers; }
+
+    // The cards the seat passed, and the cards passed to it. Both are empty when cards were held as dealt.
+    auto passed() const -> CardSet { return mPassed; }
+    auto received() const -> CardSet { return mReceived; }
+
+    // The cards the seat knows the player holds: its own hand, and for the player it passed to the passed cards they
+    // have not played yet.
+    auto knownHand(PlayerNum p) const -> CardSet;
+
+    // The unplayed cards the seat cannot place.
+    auto unknownCards() const -> CardSet;
+
+    auto unplayedCards() const -> CardSet;
+    auto playedBy(PlayerNum p) const -> CardSet { return mPosition.played.at(p); }
+    auto takenBy(PlayerNum p) const -> CardSet { return mPosition.taken.at(p); }
+    auto playerVoids() const -> PlayerVoids { return mPosition.voids; }
+    auto currentTrick() const -> Trick { return mPosition.trick; }
+    auto priorTrick() const -> Trick { return mPosition.priorTrick; }
+    auto bids() const -> const std::array<GState::Bid, kNumPlayers>& { return mPosition.bids; }
+
+    // One byte per card (see KnowableState.cpp) and a header word with the seat, variant, pass offset, play index,
+    // current player, voids and bids.
+    struct Encoding
+    {
+        uint64_t header;
+        std::array<uint8_t, kCardsPerDeck> cards;
+
+        auto operator==(const Encoding& other) const -> bool = default;
+    };
+
+    auto encoding() const -> const Encoding& { return mEncoding; }
+    auto hash() const -> uint64_t { return mHash; }
+
+    auto operator==(const KnowableState& other) const -> bool { return mEncoding == other.mEncoding; }
+
+    // True when the hands could be the actual ones as far as the seat knows.
+    auto consistent(const FourHands& hands) const -> bool;
+
+    // A GState with the given hands, which must be consistent(); throws std::invalid_argument otherwise. The passes the
+    // seat did not see are chosen with `rng` to fit the hands.
+    auto determinize(const FourHands& hands, const math::RandomGenerator& rng) const -> GState;
+
+    // A GState with hands drawn uniformly from the consistent worlds. Each call builds a WorldSampler; for many
+    // determinizations of the same state use one WorldSampler and determinize(hands, rng).
+    auto determinize(const math::RandomGenerator& rng) const -> GState;
+
+private:
+    auto encode() const -> Encoding;
+
+    PlayerNum mSeat;
+    GameBehavior mBehavior;
+    GState::Position mPosition;
+    CardSet mHand;
+    CardSet mPassed;
+    CardSet mReceived;
+    std::array<uint8_t, kNumPlayers> mHandSizes;
+    Encoding mEncoding;
+    uint64_t mHash;
+};
+
+} // namespace pho::gstate
+
+template <>
+struct std::hash<pho::gstate::KnowableState>
+{
+    auto operator()(const pho::gstate::KnowableState& state) const -> size_t { return state.hash(); }
+};
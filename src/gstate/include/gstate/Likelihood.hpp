@@ -0,0 +1,35 @@
+#pragma once
+
+#include "gstate/GState.hpp"
+
+#include <functional>
+#include <vector>
+
+namespace pho::gstate {
+
+/// @brief A PlayLikelihood gives, for each of a batch of hands the current player of `before` might have held, the
+/// probability that they would have played `card` from it. It is the model of an opponent used to weight sampled
+/// worlds by the plays actually seen, so one call covers every world and can be a single batched evaluation.
+/// It must judge each hand only from what is public in `before` (the plays, voids and scores so far), not from the
+/// hands `before` holds.
+using PlayLikelihood
+    = std::function<auto(const GState& before, Card card, const std::vector<CardSet>& hands)->std::vector<double>>;
+
+namespace likelihoods {
+
+/// @brief The likelihood of policies::random(): one over the number of legal plays, if the card is legal.
+auto random() -> PlayLikelihood;
+
+/// @brief The likelihood of policies::front(): one when the card is the lowest legal play.
+auto front() -> PlayLikelihood;
+
+/// @brief The likelihood of policies::back(): one when the card is the highest legal play.
+auto back() -> PlayLikelihood;
+
+/// @brief A model of a player who follows `model` but plays at random with probability epsilon. Mixing in the random
+/// likelihood keeps a deterministic model from ruling out the actual world when the player strays from it.
+auto mixture(PlayLikelihood model, double epsilon) -> PlayLikelihood;
+
+} // namespace likelihoods
+
+} // namespace pho::gstate
@@ -47,6 +47,8 @@ public:
 
     void operator=(const PlayerVoids& other) { mBits = other.mBits; }
 
+    Rep bits() const { return mBits; }
+
     PriorityList MakePriorityList() const;
 
     bool isVoid(int player, Suit suit) const { return (mBits & VoidBit(player, suit)) != 0; }
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "gstate/GState.hpp"
+#include "math/random.hpp"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace pho::gstate {
+
+/// @brief A Policy chooses the card for the current player to play.
+/// The returned card must be one of state.legalPlays(). Any randomness must come from the given generator,
+/// so that a caller that owns the generator (e.g. one per worker thread) controls reproducibility.
+using Policy = std::function<auto(const GState& state, const math::RandomGenerator& rng)->Card>;
+
+namespace policies {
+
+/// @brief Play a legal card uniformly at random. This is the policy of a "random playout".
+auto random() -> Policy;
+
+/// @brief Play the lowest legal card (by ord).
+auto front() -> Policy;
+
+/// @brief Play the highest legal card (by ord).
+auto back() -> Policy;
+
+/// @brief Return the policy with the given name, one of names().
+/// Throws std::invalid_argument for an unknown name.
+auto named(const std::string& name) -> Policy;
+
+auto names() -> std::vector<std::string>;
+
+} // namespace policies
+
+/// @brief Return the game variant with the given name: "standard", "jack" or "spades", as given on command lines.
+/// Throws std::invalid_argument for an unknown name.
+auto namedVariant(const std::string& name) -> GameVariant;
+
+/// @brief Play a started game to its end with the policy choosing for every player.
+/// The playout stops as soon as GState::outcomeDecided() and fast-forwards the rest, so the final state has the
+/// exact outcome but not necessarily the cards the policy would have played.
+auto playout(GState& state, const Policy& policy, const math::RandomGenerator& rng) -> void;
+
+/// @brief Choose three cards from the hand uniformly at random, using the given generator.
+auto randomPass(CardSet hand, const math::RandomGenerator& rng) -> CardSet;
+
+/// @brief A started game with a random deal and, unless passOffset is 0, random passes, played with
+/// policies::random() up to `plays` plays. Mainly for tests.
+auto randomState(GameBehavior behavior, PassOffset passOffset, unsigned plays, const math::RandomGenerator& rng)
+    -> GState;
+
+} // namespace pho::gstate
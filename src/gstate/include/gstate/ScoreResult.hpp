@@ -50,6 +50,9 @@ public:
 
     auto scoreDelta() const -> double { return N == 0 ? 0.0 : mZms / N; }
 
+    // The win fraction scaled so that equal strength is 0.5: the argument of math::eloDelta().
+    auto eloScore() const -> double;
+
     auto eloDelta() const -> double;
 
     auto opponentWinFraction() const -> double;
@@ -64,6 +67,19 @@ public:
 
     auto scoreType() const -> ScoreType { return kScoreType; }
 
+    // The accumulated totals, for saving a ScoreResult (e.g. in a checkpoint) and restoring it exactly.
+    struct Totals
+    {
+        double winPts;
+        double zms;
+        uint64_t count;
+        ScoreType scoreType;
+    };
+
+    auto totals() const -> Totals { return Totals{mWinPts, mZms, N, kScoreType}; }
+
+    static auto fromTotals(const Totals& totals) -> ScoreResult;
+
 private:
     double mWinPts;
     double mZms;
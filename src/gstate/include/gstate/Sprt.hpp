@@ -0,0 +1,79 @@
+#pragma once
+
+#include "gstate/ScoreResult.hpp"
+#include "stats/RunningStats.hpp"
+
+#include <utility>
+
+namespace pho::gstate {
+
+/// @brief The hypotheses and error rates of a sequential probability ratio test of a match between two agents.
+/// The hypotheses are Elo deltas of the hero over the opponent, as reported by ScoreResult::eloDelta().
+struct SprtConfig
+{
+    double elo0{0.0}; // H0: the hero is this much stronger
+    double elo1{10.0}; // H1: the hero is this much stronger; must differ from elo0
+    double alpha{0.05}; // the probability of accepting H1 when H0 is true
+    double beta{0.05}; // the probability of accepting H0 when H1 is true
+};
+
+/// @brief A sequential probability ratio test (Wald) of the Elo delta of a match.
+///
+/// The samples are independent per-deal results, each the ScoreResult::eloScore() of the hero's hands on one deal (for
+/// duplicate play, averaged over the rotations of the seating). The test uses the normal approximation of the
+/// generalized SPRT: under hypothesis i the samples have mean inverseEloDelta(eloi) and the observed variance, so
+///     LLR = n (mu1 - mu0) (2 mean - mu0 - mu1) / (2 variance)
+/// and the test stops once the LLR leaves [log(beta / (1 - alpha)), log((1 - beta) / alpha)].
+///
+/// The test may be checked after every sample or only now and then (e.g. after each batch of deals); checking less
+/// often only makes it slightly more conservative.
+class Sprt
+{
+public:
+    enum Decision
+    {
+        eContinue,
+        eAcceptH0,
+        eAcceptH1
+    };
+
+    /// @brief Throws std::invalid_argument unless alpha and beta are in (0, 0.5) and elo0 != elo1.
+    explicit Sprt(const SprtConfig& config);
+
+    auto config() const -> const SprtConfig& { return mConfig; }
+
+    /// @brief The log-likelihood ratio of H1 to H0. Zero, i.e. no evidence either way, with fewer than two samples or
+    /// when every sample is the same.
+    auto llr(const stats::RunningStats& samples) const -> double;
+
+    auto lowerBound() const -> double { return mLower; }
+    auto upperBound() const -> double { return mUpper; }
+
+    auto decide(const stats::RunningStats& samples) const -> Decision;
+
+private:
+    SprtConfig mConfig;
+    double mMean0;
+    double mMean1;
+    double mLower;
+    double mUpper;
+};
+
+auto toString(Sprt::Decision decision) -> const char*;
+
+/// @brief A confidence sequence for the mean of the samples: an interval that holds the true mean at every sample
+/// count at once with probability at least 1 - alpha, so unlike a fixed-sample confidence interval it stays valid
+/// when the samples stop as soon as they look conclusive (e.g. by an SPRT).
+/// It is the two-sided normal-mixture boundary of Robbins, with the observed variance in place of the true one:
+///     |sum - n mu| <= sqrt((V + rho) (log((V + rho) / rho) + 2 log(2 / alpha))),  V = n variance,
+/// where rho = variance * tuneSamples makes the interval tightest near tuneSamples samples.
+/// Returns (-inf, inf) with fewer than two samples. Throws std::invalid_argument unless alpha is in (0, 1) and
+/// tuneSamples is positive.
+auto confidenceSequence(const stats::RunningStats& samples, double alpha, double tuneSamples = 1000.0)
+    -> std::pair<double, double>;
+
+/// @brief The confidence sequence of the Elo delta, from samples of ScoreResult::eloScore().
+auto eloConfidenceSequence(const stats::RunningStats& samples, double alpha, double tuneSamples = 1000.0)
+    -> std::pair<double, double>;
+
+} // namespace pho::gstate
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "cards/SuitPermutation.hpp"
+#include "gstate/GState.hpp"
+#include "gstate/GameVariant.hpp"
+
+namespace pho::gstate {
+
+// Canonical representatives of hands and states under the suit permutations that do not change the game.
+//
+// Which suits may be exchanged depends on the variant and on how far the game has gone:
+//  - spades: clubs, diamonds and hearts are interchangeable throughout, since spades are trump and the first lead is
+//    chosen at random.
+//  - standard: clubs and diamonds once the two of clubs has been led. Before that clubs are the suit of the first
+//    lead, so a dealt hand (e.g. for a pass table) has no symmetry.
+//  - jack: as standard, but only once the jacks of diamonds and clubs have both been taken.
+// The representative sorts the interchangeable suits so that the holdings in them descend, keeping every other suit
+// in place. Looking up a cache, opening book or pass table by the representative shares entries across the
+// symmetric cases; the permutation maps answers back (e.g. a card c of the representative is
+// permutation.inverse()(c) in the original).
+
+// The suits that can be exchanged in a dealt hand, before the passes and the first lead, as a mask of 1 << suit.
+auto interchangeableSuitsAtDeal(GameVariant variant) -> unsigned;
+
+// The suits that can be exchanged in the state from this point on, as a mask of 1 << suit.
+auto interchangeableSuits(const GState& state) -> unsigned;
+
+struct CanonicalHand
+{
+    CardSet hand;
+    SuitPermutation permutation; // hand == permutation(original)
+};
+
+// The canonical representative of a dealt hand.
+auto canonicalHand(CardSet hand, GameVariant variant) -> CanonicalHand;
+
+struct CanonicalState
+{
+    GState state;
+    SuitPermutation permutation; // state == original.permuteSuits(permutation)
+};
+
+// The canonical representative of a started game's state. The interchangeable suits are ordered by all of their cards
+// the state knows: the players' hands, passes, plays and taken cards, both tricks and the revealed voids.
+auto canonicalState(const GState& state) -> CanonicalState;
+
+} // namespace pho::gstate
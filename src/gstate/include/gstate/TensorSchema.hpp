@@ -0,0 +1,237 @@
+#pragma once
+
+#include "gstate/GState.hpp"
+
+#include <algorithm>
+#include <array>
+#include <type_traits>
+
+namespace pho::gstate::tensor {
+
+// An input tensor is a 52-row matrix with one row per card (by ord) and one column per feature value.
+// A Schema is an ordered list of Features. Each Feature contributes kWidth adjacent columns.
+
+// Every feature column can be described by a ColumnPlan: two card masks and a per-suit scale.
+// The value written for card `c` is `bit(ones, c) + bit(scaled, c) * suitScale[suitOf(c)]`.
+// The `ones` and `scaled` masks must be disjoint.
+// Reducing every feature to this form is what lets a Schema emit one fused, branch-free loop over the
+// 52x(width) output, no matter how the features are combined.
+struct ColumnPlan
+{
+    uint64_t ones{};
+    uint64_t scaled{};
+    std::array<float, kSuitsPerDeck> suitScale{};
+};
+
+// The facts about a GState that features are derived from, gathered once per encoding.
+// The tensor is always built from the perspective of the current player (Carl) sitting at the South seat.
+// We use the convention that `pMain` is a player numbering with Carl at seat 0, and `pState` is the actual
+// player numbering in the game state.
+struct EncodeContext
+{
+    explicit EncodeContext(const GState& state);
+
+    auto stateSeat(unsigned pMain) const -> PlayerNum { return (carl + pMain) % kNumPlayers; }
+
+    // The cards of all suits in which player pState is known (by Carl) to be void.
+    auto voidCards(PlayerNum pState) const -> CardSet;
+
+    const GState& state;
+    const PlayerNum carl;
+    const CardSet legal;
+    const CardSet hand;
+    const CardSet passed; // the cards Carl passed that are not yet played
+    const CardSet unknown; // the unplayed cards whose location is not known to Carl
+    const CardSet onTable;
+    const PlayerVoids voids;
+    std::array<float, kSuitsPerDeck> suitProb; // probability that a non-void opponent holds an unknown card
+};
+
+// ---- Features ----
+// A Feature declares kWidth, whether any of its columns use `scaled` (kScaled), and a plan() that fills kWidth
+// ColumnPlans. Features are stateless and are only ever used as template arguments of a Schema.
+
+// The cards Carl may legally play now.
+struct LegalPlays
+{
+    static constexpr unsigned kWidth = 1;
+    static constexpr bool kScaled = false;
+    static auto plan(const EncodeContext& context, ColumnPlan* columns) -> void;
+};
+
+// Per seat, the probability that the seat holds the card, the same values as GState::fillProbabilities().
+struct ProbHasCard
+{
+    static constexpr unsigned kWidth = kNumPlayers;
+    static constexpr bool kScaled = true;
+    static auto plan(const EncodeContext& context, ColumnPlan* columns) -> void;
+};
+
+// Per seat, the cards the seat has taken in completed tricks.
+struct TakenBySeat
+{
+    static constexpr unsigned kWidth = kNumPlayers;
+    static constexpr bool kScaled = false;
+    static auto plan(const EncodeContext& context, ColumnPlan* columns) -> void;
+};
+
+// Per seat, the point cards the seat has taken in completed tricks.
+struct PointsTakenBySeat
+{
+    static constexpr unsigned kWidth = kNumPlayers;
+    static constexpr bool kScaled = false;
+    static auto plan(const EncodeContext& context, ColumnPlan* columns) -> void;
+};
+
+// Per seat, the cards the seat has played so far (including the current trick).
+struct PlayedBySeat
+{
+    static constexpr unsigned kWidth = kNumPlayers;
+    static constexpr bool kScaled = false;
+    static auto plan(const EncodeContext& context, ColumnPlan* columns) -> void;
+};
+
+// Per seat, all cards of the suits in which the seat is known to be void.
+struct VoidsBySeat
+{
+    static constexpr unsigned kWidth = kNumPlayers;
+    static constexpr bool kScaled = false;
+    static auto plan(const EncodeContext& context, ColumnPlan* columns) -> void;
+};
+
+// The point cards of the game variant.
+struct PointCards
+{
+    static constexpr unsigned kWidth = 1;
+    static constexpr bool kScaled = false;
+    static auto plan(const EncodeContext& context, ColumnPlan* columns) -> void;
+};
+
+// All cards on the table in the current trick.
+struct CardOnTable
+{
+    static constexpr unsigned kWidth = 1;
+    static constexpr bool kScaled = false;
+    static auto plan(const EncodeContext& context, ColumnPlan* columns) -> void;
+};
+
+// Per position in the current trick (0 is the lead), the card played at that position.
+// The trick is complete after the last position is played, so only the first three positions are ever visible.
+struct TrickPosition
+{
+    static constexpr unsigned kWidth = kCardsPerTrick - 1;
+    static constexpr bool kScaled = false;
+    static auto plan(const EncodeContext& context, ColumnPlan* columns) -> void;
+};
+
+// The card leading the current trick.
+struct CardLeadingTrick
+{
+    static constexpr unsigned kWidth = 1;
+    static constexpr bool kScaled = false;
+    static auto plan(const EncodeContext& context, ColumnPlan* columns) -> void;
+};
+
+// The card currently winning the current trick.
+struct HighCardInTrick
+{
+    static constexpr unsigned kWidth = 1;
+    static constexpr bool kScaled = false;
+    static auto plan(const EncodeContext& context, ColumnPlan* columns) -> void;
+};
+
+// ---- Schema ----
+
+template <typename... Features>
+struct Schema
+{
+    static_assert(sizeof...(Features) > 0);
+
+    static constexpr unsigned kWidth = (Features::kWidth + ...);
+    static constexpr unsigned kFloats = kWidth * kCardsPerDeck;
+
+    using Plan = std::array<ColumnPlan, kWidth>;
+
+    // Return the index of the first column of the given feature
+    template <typename Feature>
+    static constexpr auto offsetOf() -> unsigned
+    {
+        static_assert((std::is_same_v<Feature, Features> || ...), "Feature is not part of this schema");
+        auto found = false;
+        auto offset = 0u;
+        ((found = found || std::is_same_v<Feature, Features>, offset += found ? 0u : Features::kWidth), ...);
+        return offset;
+    }
+
+    // Return for each column whether it may have `scaled` cards. Columns that don't are pure bit masks.
+    static constexpr auto scaledColumns() -> std::array<bool, kWidth>
+    {
+        auto result = std::array<bool, kWidth>{};
+        auto offset = 0u;
+        ((std::fill_n(result.begin() + offset, Features::kWidth, Features::kScaled), offset += Features::kWidth),
+            ...);
+        return result;
+    }
+
+    static auto plan(const GState& state) -> Plan
+    {
+        const auto context = EncodeContext{state};
+        auto result = Plan{};
+        auto offset = 0u;
+        ((Features::plan(context, result.data() + offset), offset += Features::kWidth), ...);
+        return result;
+    }
+
+    // Write the tensor for the plan into data, which must have room for kFloats floats.
+    // Every element is written, so the memory need not be zeroed first.
+    static auto expand(const Plan& plan, float* data) -> void
+    {
+        for (unsigned c = 0; c < kCardsPerDeck; ++c)
+        {
+            const auto suit = c / kCardsPerSuit;
+            float* row = data + c * kWidth;
+            for (unsigned col = 0; col < kWidth; ++col)
+            {
+                const auto& column = plan[col];
+                row[col] = float((column.ones >> c) & 1u) + float((column.scaled >> c) & 1u) * column.suitScale[suit];
+            }
+        }
+    }
+
+    static auto encode(const GState& state, float* data) -> void { expand(plan(state), data); }
+};
+
+} // namespace pho::gstate::tensor
+
+namespace pho::gstate::min2022 {
+
+// The column names of the min2022 schema.
+enum InputSchema
+{
+    eLegalPlay,
+    eP0ProbHasCard,
+    eP1ProbHasCard,
+    eP2ProbHasCard,
+    eP3ProbHasCard,
+    eP0TakenCard,
+    eP1TakenCard,
+    eP2TakenCard,
+    eP3TakenCard,
+    eCardOnTable,
+    eCardLeadingTrick,
+    eHighCardInTrick,
+
+    kNumInFeatures
+};
+
+using Schema = tensor::Schema<tensor::LegalPlays, tensor::ProbHasCard, tensor::TakenBySeat, tensor::CardOnTable,
+    tensor::CardLeadingTrick, tensor::HighCardInTrick>;
+
+static_assert(Schema::kWidth == kNumInFeatures);
+static_assert(Schema::offsetOf<tensor::ProbHasCard>() == eP0ProbHasCard);
+static_assert(Schema::offsetOf<tensor::TakenBySeat>() == eP0TakenCard);
+static_assert(Schema::offsetOf<tensor::CardOnTable>() == eCardOnTable);
+static_assert(Schema::offsetOf<tensor::CardLeadingTrick>() == eCardLeadingTrick);
+static_assert(Schema::offsetOf<tensor::HighCardInTrick>() == eHighCardInTrick);
+
+} // namespace pho::gstate::min2022
@@ -0,0 +1,92 @@
+// playout_bench: measure how random playouts scale with the threads of a prim::ThreadPool.
+//
+// Usage: playout_bench [--playouts=N] [--threads=T] [--grain=G]
+//
+// Each row plays the same N games, from fresh random deals, on a pool of 1, 2, 4, ... workers up to T (by default
+// one per hardware thread), and reports playouts per second and the speedup over one worker. The checksum of the
+// scores is the same in every row because each game draws from its own RandomGenerator::forStream() stream.
+
+#include "gstate/Policy.hpp"
+#include "prim/ThreadPool.hpp"
+
+#include <chrono>
+#include <fmt/format.h>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace pho;
+using namespace pho::gstate;
+
+namespace {
+
+constexpr uint64_t kSeed = 1;
+
+// Play the games on a pool of `threads` workers, returning playouts per second.
+auto timePlayouts(unsigned threads, uint64_t playouts, size_t grain, double baseline) -> double
+{
+    auto pool = prim::ThreadPool{threads};
+    auto checksums = prim::PerWorker<double>{pool};
+    const auto policy = policies::random();
+
+    const auto start = std::chrono::steady_clock::now();
+    pool.parallelFor(0, playouts, grain, [&](size_t game) {
+        const auto rng = math::RandomGenerator::forStream(kSeed, game);
+        auto state = GState{GState::Init{Deal::randomDealIndex(rng), 0}, GState::kStandard, rng};
+        state.startGame();
+        playout(state, policy, rng);
+        checksums.local() += state.outcome().scores[0] * double(game % 7 + 1);
+    });
+    const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    auto checksum = 0.0;
+    for (size_t i = 0; i < checksums.size(); ++i)
+        checksum += checksums[i];
+    const auto rate = double(playouts) / seconds;
+    const auto speedup = baseline > 0.0 ? rate / baseline : 1.0;
+    fmt::print("{:>4} threads {:>10.0f} playouts/sec  speedup {:>6.2f}  efficiency {:>5.1f}%  (checksum {:.0f})\n",
+        threads, rate, speedup, 100.0 * speedup / threads, checksum);
+    return rate;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        auto playouts = uint64_t{200'000};
+        auto threads = std::max(1u, std::thread::hardware_concurrency());
+        auto grain = size_t{64};
+        for (int i = 1; i < argc; ++i)
+        {
+            const auto arg = std::string{argv[i]};
+            if (arg.starts_with("--playouts="))
+                playouts = std::stoull(arg.substr(11));
+            else if (arg.starts_with("--threads="))
+                threads = unsigned(std::stoul(arg.substr(10)));
+            else if (arg.starts_with("--grain="))
+                grain = std::stoull(arg.substr(8));
+            else
+                throw std::invalid_argument(fmt::format("Unrecognized argument: {}", arg));
+        }
+        if (threads == 0)
+            throw std::invalid_argument("--threads must be positive");
+
+        auto counts = std::vector<unsigned>{};
+        for (auto count = 1u; count < threads; count *= 2)
+            counts.push_back(count);
+        counts.push_back(threads);
+
+        const auto baseline = timePlayouts(counts.front(), playouts, grain, 0.0);
+        for (size_t i = 1; i < counts.size(); ++i)
+            timePlayouts(counts[i], playouts, grain, baseline);
+    }
+    catch (const std::exception& e)
+    {
+        fmt::print(stderr, "playout_bench: {}\n", e.what());
+        return 1;
+    }
+    return 0;
+}
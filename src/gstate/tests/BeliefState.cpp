@@ -0,0 +1,283 @@
+#include "gtest/gtest.h"
+
+#include "gstate/BeliefState.hpp"
+#include "gstate/Policy.hpp"
+#include "prim/range.hpp"
+
+#include <map>
+
+namespace pho::gstate::tests {
+
+namespace {
+// True when the world could be the actual one, as far as the observer knows.
+auto consistent(const GState& state, PlayerNum observer, const FourHands& world) -> bool
+{
+    if (world.at(observer) != state.playersHand(observer))
+        return false;
+    auto all = CardSet{};
+    for (auto p : prim::range(kNumPlayers))
+    {
+        if (world.at(p).size() != state.playersHand(p).size() || !(all & world.at(p)).empty())
+            return false;
+        all += world.at(p);
+        for (auto suit : allSuits)
+        {
+            if (p != observer && state.playerVoids().isVoid(p, suit) && !world.at(p).cardsWithSuit(suit).empty())
+                return false;
+        }
+    }
+    const auto receiver = (observer + state.passOffset()) % kNumPlayers;
+    const auto held = state.passedBy(observer) & state.unplayedCards();
+    return all == state.unplayedCards() && (world.at(receiver) & held) == held;
+}
+
+using WorldKey = std::array<uint64_t, kNumPlayers>;
+
+auto keyOf(const FourHands& world) -> WorldKey
+{
+    return {world.at(0).asBits(), world.at(1).asBits(), world.at(2).asBits(), world.at(3).asBits()};
+}
+
+// Every consistent world, by trying each assignment of the cards the observer does not hold to the other players.
+auto allWorlds(const GState& state, PlayerNum observer) -> std::vector<FourHands>
+{
+    const auto cards = (state.unplayedCards() - state.playersHand(observer)).asCardVector();
+    auto assignments = 1u;
+    for (auto i : prim::range(cards.size()))
+    {
+        (void)i;
+        assignments *= kNumPlayers - 1;
+    }
+
+    auto result = std::vector<FourHands>{};
+    for (auto assignment : prim::range(assignments))
+    {
+        auto world = FourHands{};
+        world.at(observer) = state.playersHand(observer);
+        for (auto card : cards)
+        {
+            world.at((observer + 1 + assignment % 3) % kNumPlayers) += card;
+            assignment /= 3;
+        }
+        if (consistent(state, observer, world))
+            result.push_back(world);
+    }
+    return result;
+}
+} // namespace
+
+TEST(WorldSampler, samples_consistent_worlds)
+{
+    const auto rng = math::RandomGenerator{3};
+    for (auto plays : {0u, 7u, 21u, 34u, 47u})
+    {
+        const auto state = randomState(GState::kStandard, 1, plays, rng);
+        for (auto observer : prim::range(kNumPlayers))
+        {
+            const auto sampler = WorldSampler{state, observer};
+            EXPECT_TRUE(consistent(state, observer, state.hands()));
+            for (auto i : prim::range(50))
+            {
+                (void)i;
+                EXPECT_TRUE(consistent(state, observer, sampler(rng)));
+            }
+        }
+    }
+
+    // Before any play or void, the count is the number of ways to deal the unknown cards.
+    const auto state = randomState(GState::kStandard, 0, 0, rng);
+    EXPECT_DOUBLE_EQ(WorldSampler(state, 0).worlds(), double(math::multinomial({13, 13, 13})));
+}
+
+TEST(WorldSampler, is_uniform)
+{
+    const auto rng = math::RandomGenerator{5};
+    for (auto trial : prim::range(4))
+    {
+        (void)trial;
+        const auto state = randomState(GState::kStandard, 2, 45, rng);
+        const auto worlds = allWorlds(state, 0);
+        const auto sampler = WorldSampler{state, 0};
+        ASSERT_EQ(sampler.worlds(), double(worlds.size()));
+
+        constexpr auto kPerWorld = 200;
+        auto counts = std::map<WorldKey, int>{};
+        for (auto i : prim::range(kPerWorld * worlds.size()))
+        {
+            (void)i;
+            ++counts[keyOf(sampler(rng))];
+        }
+        EXPECT_EQ(counts.size(), worlds.size());
+        for (const auto& world : worlds)
+        {
+            EXPECT_GT(counts[keyOf(world)], kPerWorld / 2);
+            EXPECT_LT(counts[keyOf(world)], 2 * kPerWorld);
+        }
+    }
+}
+
+TEST(BeliefState, tracks_a_game)
+{
+    const auto rng = math::RandomGenerator{9};
+    auto state = randomState(GState::kStandard, 3, 0, rng);
+    const auto config = BeliefConfig{.particles = 300, .refillBelow = 0.5};
+    auto belief = BeliefState{state, 1, config, rng};
+    EXPECT_EQ(belief.stats().sampled, config.particles);
+
+    const auto policy = policies::random();
+    auto updates = 0u;
+    while (!state.done())
+    {
+        state.playCard(policy(state, rng));
+        belief.update(state);
+        ++updates;
+
+        ASSERT_GE(belief.particles().size(), config.particles / 2);
+        EXPECT_DOUBLE_EQ(belief.totalWeight(), double(belief.particles().size()));
+        for (const auto& particle : belief.particles())
+            ASSERT_TRUE(consistent(state, 1, particle.hands));
+        EXPECT_TRUE(consistent(state, 1, belief.sample(rng)));
+    }
+
+    // Carrying the surviving worlds from play to play samples less than half as many as sampling afresh each time.
+    EXPECT_GT(belief.stats().rejected, 0u);
+    EXPECT_EQ(belief.stats().sampled - belief.stats().rejected, belief.particles().size());
+    EXPECT_LT(belief.stats().sampled, updates * config.particles / 2);
+}
+
+TEST(Likelihood, matches_the_policies)
+{
+    const auto rng = math::RandomGenerator{13};
+    const auto model = likelihoods::mixture(likelihoods::front(), 0.2);
+    for (auto plays : {0u, 5u, 18u, 30u, 51u})
+    {
+        const auto state = randomState(GState::kStandard, 1, plays, rng);
+        const auto hand = state.currentPlayersHand();
+        const auto legal = state.legalPlays();
+        EXPECT_EQ(state.legalPlaysFor(hand), legal);
+
+        auto total = 0.0;
+        for (auto card : hand)
+        {
+            const auto uniform = likelihoods::random()(state, card, {hand}).at(0);
+            EXPECT_DOUBLE_EQ(uniform, legal.hasCard(card) ? 1.0 / double(legal.size()) : 0.0);
+            EXPECT_EQ(likelihoods::front()(state, card, {hand}).at(0), card == legal.front() ? 1.0 : 0.0);
+            EXPECT_EQ(likelihoods::back()(state, card, {hand}).at(0), card == legal.back() ? 1.0 : 0.0);
+            total += model(state, card, {hand}).at(0);
+        }
+        EXPECT_DOUBLE_EQ(total, 1.0);
+    }
+    EXPECT_THROW(likelihoods::mixture(likelihoods::front(), 1.5), std::invalid_argument);
+}
+
+namespace {
+// The weighted fraction of the cards the observer cannot see that the belief places in the right hand.
+auto accuracy(const GState& state, const BeliefState& belief) -> double
+{
+    const auto unknown = state.unplayedCards() - state.playersHand(belief.observer());
+    auto right = 0.0;
+    for (const auto& particle : belief.particles())
+    {
+        for (auto p : prim::range(kNumPlayers))
+            right += particle.weight * double((particle.hands.at(p) & state.playersHand(p) & unknown).size());
+    }
+    return right / (belief.totalWeight() * double(unknown.size()));
+}
+} // namespace
+
+TEST(BeliefState, weighs_worlds_by_the_plays)
+{
+    // The other players play their lowest legal card, and the observer knows it (allowing for some mistakes).
+    const auto rng = math::RandomGenerator{17};
+    const auto config = BeliefConfig{.particles = 400};
+    const auto opponents = policies::front();
+    auto uniformAccuracy = 0.0;
+    auto weightedAccuracy = 0.0;
+    auto resamples = 0u;
+    for (auto game : prim::range(4))
+    {
+        (void)game;
+        auto state = randomState(GState::kStandard, 0, 0, rng);
+        auto uniform = BeliefState{state, 0, config, rng};
+        auto weighted = BeliefState{state, 0, config, rng, likelihoods::mixture(likelihoods::front(), 0.1)};
+        while (state.playIndex() < 28)
+        {
+            const auto policy = state.currentPlayer() == 0 ? policies::random() : opponents;
+            state.playCard(policy(state, rng));
+            uniform.update(state);
+            weighted.update(state);
+
+            EXPECT_NEAR(weighted.totalWeight(), double(weighted.particles().size()), 1e-6);
+            EXPECT_LE(weighted.effectiveSampleSize(), double(weighted.particles().size()) + 1e-6);
+            for (const auto& particle : weighted.particles())
+                ASSERT_TRUE(consistent(state, 0, particle.hands));
+        }
+        uniformAccuracy += accuracy(state, uniform);
+        weightedAccuracy += accuracy(state, weighted);
+        resamples += weighted.stats().resamples;
+        EXPECT_EQ(uniform.stats().likelihoodBatches, 0u);
+    }
+    EXPECT_GT(resamples, 0u);
+    EXPECT_GT(weightedAccuracy, uniformAccuracy + 0.08);
+}
+
+TEST(BeliefState, survives_an_opponent_who_strays_from_the_model)
+{
+    // The model says the others play their lowest legal card, but they play their highest, which it rules out.
+    const auto rng = math::RandomGenerator{23};
+    auto state = randomState(GState::kStandard, 0, 0, rng);
+    const auto config = BeliefConfig{.particles = 200};
+    auto belief = BeliefState{state, 0, config, rng, likelihoods::front()};
+    while (!state.done())
+    {
+        const auto policy = state.currentPlayer() == 0 ? policies::random() : policies::back();
+        state.playCard(policy(state, rng));
+        belief.update(state);
+
+        ASSERT_FALSE(belief.particles().empty());
+        EXPECT_NEAR(belief.totalWeight(), double(belief.particles().size()), 1e-6);
+        for (const auto& particle : belief.particles())
+            ASSERT_TRUE(consistent(state, 0, particle.hands));
+        EXPECT_TRUE(consistent(state, 0, belief.sample(rng)));
+    }
+    EXPECT_GT(belief.stats().resets, 0u);
+}
+
+TEST(BeliefState, calls_the_likelihood_once_a_play)
+{
+    const auto rng = math::RandomGenerator{19};
+    auto state = randomState(GState::kStandard, 0, 0, rng);
+    auto calls = 0u;
+    auto worlds = size_t{};
+    const auto counting = [&](const GState& before, Card card, const std::vector<CardSet>& hands) {
+        ++calls;
+        worlds += hands.size();
+        return likelihoods::random()(before, card, hands);
+    };
+    const auto config = BeliefConfig{.particles = 2000, .refillBelow = 0.0};
+    auto belief = BeliefState{state, 2, config, rng, counting};
+
+    const auto policy = policies::random();
+    auto theirs = 0u;
+    for (auto play : prim::range(GState::kPlaysPerTrick))
+    {
+        (void)play;
+        theirs += state.currentPlayer() != 2 ? 1 : 0;
+        state.playCard(policy(state, rng));
+        belief.update(state);
+    }
+    EXPECT_EQ(calls, theirs);
+    EXPECT_EQ(belief.stats().likelihoodBatches, theirs);
+    EXPECT_GT(worlds, belief.particles().size());
+
+    // The plays are read back from the tricks, so a belief left behind for more than a trick cannot catch up.
+    auto stale = BeliefState{state, 2, config, rng};
+    for (auto play : prim::range(2 * GState::kPlaysPerTrick))
+    {
+        (void)play;
+        state.playCard(policy(state, rng));
+    }
+    EXPECT_THROW(stale.update(state), std::invalid_argument);
+}
+
+} // namespace pho::gstate::tests
@@ -0,0 +1,142 @@
+#include "gtest/gtest.h"
+
+#include "gstate/Endgame.hpp"
+#include "gstate/Policy.hpp"
+#include "prim/range.hpp"
+#include "prim/tests/scratch.hpp"
+
+#include <filesystem>
+
+namespace pho::gstate::tests {
+
+namespace fs = std::filesystem;
+using prim::tests::scratchPath;
+
+namespace {
+// The max^n solution by brute force on GState: each player picks the legal play with their lowest final score, the
+// lowest card on ties.
+auto referenceScores(const GState& state, Card* best) -> GState::PlayerScores
+{
+    if (state.done())
+        return state.outcome().scores;
+
+    const auto player = state.currentPlayer();
+    auto bestScores = GState::PlayerScores{};
+    auto found = false;
+    for (auto card : state.legalPlays())
+    {
+        auto next = state;
+        next.playCard(card);
+        const auto scores = referenceScores(next, nullptr);
+        if (!found || scores[player] < bestScores[player])
+        {
+            found = true;
+            bestScores = scores;
+            if (best != nullptr)
+                *best = card;
+        }
+    }
+    return bestScores;
+}
+
+auto expectMatchesReference(GameVariant variant, unsigned plays, unsigned trials, uint64_t seed)
+{
+    const auto rng = math::RandomGenerator{seed};
+    auto solver = EndgameSolver{variant};
+    for (auto trial : prim::range(trials))
+    {
+        (void)trial;
+        const auto state = randomState(GameBehavior::make(variant), 0, plays, rng);
+        ASSERT_TRUE(EndgameSolver::canSolve(state));
+
+        auto expectedPlay = Card{};
+        const auto expected = referenceScores(state, &expectedPlay);
+        EXPECT_EQ(solver.bestPlay(state), expectedPlay);
+        EXPECT_EQ(solver.outcome(state).scores, expected);
+    }
+}
+} // namespace
+
+TEST(Endgame, can_solve)
+{
+    const auto rng = math::RandomGenerator{1};
+    EXPECT_FALSE(EndgameSolver::canSolve(GState{}));
+    EXPECT_FALSE(EndgameSolver::canSolve(randomState(GameBehavior::make(standard), 0, 35, rng)));
+    EXPECT_TRUE(EndgameSolver::canSolve(randomState(GameBehavior::make(standard), 0, 36, rng)));
+    EXPECT_TRUE(EndgameSolver::canSolve(randomState(GameBehavior::make(standard), 0, 51, rng)));
+    EXPECT_FALSE(EndgameSolver::canSolve(randomState(GameBehavior::make(standard), 0, 52, rng)));
+}
+
+TEST(Endgame, matches_brute_force)
+{
+    for (auto variant : {standard, jack, spades})
+    {
+        SCOPED_TRACE(variant);
+        expectMatchesReference(variant, 44, 30, 7);
+        expectMatchesReference(variant, 42, 30, 8);
+        expectMatchesReference(variant, 40, 5, 9);
+    }
+}
+
+TEST(Endgame, solves_four_tricks)
+{
+    const auto rng = math::RandomGenerator{12};
+    for (auto variant : {standard, jack, spades})
+    {
+        auto solver = EndgameSolver{variant};
+        for (auto trial : prim::range(10))
+        {
+            (void)trial;
+            auto state = randomState(GameBehavior::make(variant), 0, 36, rng);
+            const auto expected = solver.outcome(state);
+            solver.solve(state);
+            EXPECT_TRUE(state.done());
+            EXPECT_EQ(state.outcome().scores, expected.scores);
+        }
+        EXPECT_GT(solver.stats().solved, 0u);
+        EXPECT_GT(solver.stats().memoHits, 0u);
+        EXPECT_EQ(solver.memo().size(), solver.stats().solved);
+    }
+}
+
+#if !__EMSCRIPTEN__
+TEST(Endgame, persists_the_memo)
+{
+    const auto path = scratchPath("persist");
+    const auto rng = math::RandomGenerator{21};
+    auto states = std::vector<GState>{};
+    for (auto trial : prim::range(10))
+    {
+        (void)trial;
+        states.push_back(randomState(GameBehavior::make(standard), 0, 36, rng));
+    }
+
+    auto solver = EndgameSolver{standard};
+    auto plays = std::vector<Card>{};
+    for (const auto& state : states)
+        plays.push_back(solver.bestPlay(state));
+    solver.memo().save(path);
+
+    const auto table = MappedEndgameTable{path, true};
+    EXPECT_EQ(table.size(), solver.memo().size());
+    auto persisted = EndgameSolver{standard, &table};
+    for (auto i : prim::range(states.size()))
+        EXPECT_EQ(persisted.bestPlay(states[i]), plays[i]);
+    EXPECT_EQ(persisted.stats().solved, 0u);
+    EXPECT_GT(persisted.stats().persistedHits, 0u);
+
+    auto extended = EndgameTable{standard, 16};
+    extended.insertAll(table);
+    EXPECT_EQ(extended.size(), table.size());
+
+    EXPECT_THROW(EndgameSolver(spades, &table), std::invalid_argument);
+    EXPECT_THROW(EndgameTable(jack).insertAll(table), std::invalid_argument);
+
+    fs::resize_file(path, fs::file_size(path) - 1);
+    EXPECT_THROW(MappedEndgameTable{path}, std::runtime_error);
+    EXPECT_THROW(MappedEndgameTable{path + ".missing"}, std::runtime_error);
+    fs::remove(path);
+}
+#endif
+
+} // namespace pho::gstate::tests
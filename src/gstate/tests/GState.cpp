@@ -114,4 +114,36 @@ TEST(GState, random_deals_with_passing_as_probs)
     }
 }
 
+TEST(GState, reproducible_from_stream)
+{
+    // Play a Spades game with random passes, a random first lead and random plays, all from the game's stream.
+    auto playGame = [](uint64_t seed, uint64_t game) {
+        const auto rng = math::RandomGenerator::forStream(seed, game);
+        GState gameState{GState::kRandom, GState::kSpades, rng};
+        if (gameState.passOffset() != 0)
+        {
+            for (auto p : prim::range(kNumPlayers))
+                gameState.setPassFor(p, chooseThreeAtRandom(gameState.playersHand(p), gameState.rng()));
+        }
+        gameState.startGame();
+        auto plays = std::vector<Card>{};
+        while (!gameState.done())
+        {
+            plays.push_back(aCardAtRandom(gameState.legalPlays(), gameState.rng()));
+            gameState.playCard(plays.back());
+        }
+        return std::make_tuple(gameState.dealIndex(), gameState.passOffset(), plays, gameState.getPlayerScores());
+    };
+
+    for (auto game : prim::range(20u))
+    {
+        // Interleave other uses of the thread's generator, which must not matter.
+        const auto first = playGame(3, game);
+        (void)math::RandomGenerator::Random64();
+        EXPECT_EQ(playGame(3, game), first);
+        EXPECT_NE(playGame(3, game + 1000), first);
+        EXPECT_NE(playGame(4, game), first);
+    }
+}
+
 } // namespace pho::gstate
@@ -3,6 +3,7 @@
 #include "cards/utils.hpp"
 #include "gstate/GState.hpp"
 #include "gstate/GameBehavior.hpp"
+#include "gstate/Policy.hpp"
 #include "prim/range.hpp"
 #include "stats/RunningStats.hpp"
 
@@ -12,6 +13,7 @@
 #include <magic_enum.hpp>
 #include <map>
 #include <numeric>
+#include <optional>
 
 namespace pho::gstate {
 
@@ -125,4 +127,177 @@ TEST(unbiased_by_seat, player_outcome)
     }
 }
 
+TEST(tally, matches_taken_cards)
+{
+    const auto queen = cards::cardFor(cards::kSpades, cards::kQueen);
+    const auto jack = cards::cardFor(cards::kDiamonds, cards::kJack);
+    for (auto variant : magic_enum::enum_values<GameBehavior::Variant>())
+    {
+        for (auto i : prim::range(50))
+        {
+            (void)i;
+            GState gameState{GState::kNoPass, GameBehavior::make(variant)};
+            gameState.startGame();
+            while (!gameState.done())
+            {
+                gameState.playCard(atRandom(gameState.legalPlays()));
+                if (gameState.playInTrick() != 0)
+                    continue;
+
+                const auto& tally = gameState.tally();
+                auto tookQueen = GState::TakenTally::kNoOne;
+                auto tookJack = GState::TakenTally::kNoOne;
+                for (auto p : prim::range(kNumPlayers))
+                {
+                    const auto taken = gameState.takenBy(p);
+                    const auto hearts = taken.cardsWithSuit(kHearts).size();
+                    EXPECT_EQ(tally.tricks[p] * kCardsPerTrick, taken.size());
+                    EXPECT_EQ(tally.hearts[p], hearts);
+                    EXPECT_EQ(tally.points[p], hearts + (taken.hasCard(queen) ? 13 : 0));
+                    if (taken.hasCard(queen))
+                        tookQueen = p;
+                    if (taken.hasCard(jack))
+                        tookJack = p;
+                }
+                EXPECT_EQ(tally.tookQueen, tookQueen);
+                EXPECT_EQ(tally.tookJack, tookJack);
+            }
+        }
+    }
+}
+
+TEST(tally, cached_outcome)
+{
+    for (auto variant : magic_enum::enum_values<GameBehavior::Variant>())
+    {
+        for (auto i : prim::range(50))
+        {
+            (void)i;
+            GState gameState{GState::kNoPass, GameBehavior::make(variant)};
+            gameState.startGame();
+            auto start = gameState;
+            auto lastTrick = gameState.trickCheckpoint();
+            while (!gameState.done())
+            {
+                if (gameState.playIndex() == kCardsPerDeck - kCardsPerTrick)
+                    lastTrick = gameState.trickCheckpoint();
+                gameState.playCard(atRandom(gameState.legalPlays()));
+            }
+
+            const auto& outcome = gameState.outcome();
+            const auto scores = std::visit([](auto&& arg) { return arg.normalizedScores(); }, outcome.rep);
+            EXPECT_EQ(outcome.scores, scores);
+            EXPECT_EQ(gameState.getPlayerScores(), scores);
+            for (auto p : prim::range(kNumPlayers))
+            {
+                const auto result = gameState.getPlayerOutcome(p);
+                EXPECT_EQ(result.zms, scores[p]);
+                const auto winPts = std::visit([p](auto&& arg) { return arg.playerOutcomeResult(p); }, outcome.rep);
+                EXPECT_EQ(result.winPts, winPts);
+            }
+
+            // A state restored to the end of the game gets the same outcome.
+            start.restore(gameState.trickCheckpoint());
+            EXPECT_EQ(start.getPlayerScores(), scores);
+
+            // Restoring to an earlier trick and finishing the game again recomputes the outcome.
+            start.restore(lastTrick);
+            while (!start.done())
+                start.playCard(start.legalPlays().front());
+            EXPECT_EQ(start.getPlayerScores(), start.outcome().scores);
+        }
+    }
+
+    // Bids set after the game finished are reflected in the outcome.
+    auto gameState = runOneGame(atRandom, anyGame, GameBehavior::Variant::spades);
+    const auto withoutBids = gameState.getPlayerScores();
+    for (auto p : prim::range(kNumPlayers))
+        gameState.setBid(p, 13);
+    EXPECT_NE(gameState.getPlayerScores(), withoutBids);
+}
+
+TEST(early_termination, fast_forward_matches_play)
+{
+    auto plays = std::map<GameBehavior::Variant, unsigned>{};
+    for (auto variant : magic_enum::enum_values<GameBehavior::Variant>())
+    {
+        for (auto i : prim::range(100))
+        {
+            (void)i;
+            GState gameState{GState::kNoPass, GameBehavior::make(variant)};
+            gameState.startGame();
+            auto decided = std::vector<GState>{};
+            while (!gameState.done())
+            {
+                if (gameState.outcomeDecided())
+                    decided.push_back(gameState);
+                gameState.playCard(atRandom(gameState.legalPlays()));
+            }
+            EXPECT_TRUE(gameState.outcomeDecided());
+            plays[variant] += kCardsPerDeck - decided.size();
+
+            // Once decided, the outcome stays decided and every fast-forwarded state has the final outcome.
+            for (auto& state : decided)
+            {
+                EXPECT_TRUE(state.outcomeDecided());
+                state.fastForward();
+                EXPECT_TRUE(state.done());
+                EXPECT_EQ(state.getPlayerScores(), gameState.getPlayerScores());
+                EXPECT_EQ(state.allTaken(), CardSet::fullDeck());
+            }
+        }
+    }
+
+    // Random Hearts games are often decided before the last trick; Spades without bids never is.
+    EXPECT_LT(plays[GameBehavior::Variant::standard], 100u * kCardsPerDeck);
+    EXPECT_LT(plays[GameBehavior::Variant::jack], 100u * kCardsPerDeck);
+    EXPECT_EQ(plays[GameBehavior::Variant::spades], 100u * kCardsPerDeck);
+}
+
+TEST(early_termination, spades_bids)
+{
+    for (auto i : prim::range(200))
+    {
+        (void)i;
+        GState gameState{GState::kNoPass, GState::kSpades};
+        gameState.setBid(0, 13);
+        gameState.setBid(1, 13);
+        gameState.setBid(2, 13);
+        gameState.setBid(3, 1 + i % 13);
+        gameState.startGame();
+        EXPECT_FALSE(gameState.outcomeDecided());
+        EXPECT_FALSE(gameState.bidsDecided());
+
+        auto decided = std::optional<GState>{};
+        while (!gameState.done())
+        {
+            if (!decided && gameState.outcomeDecided())
+                decided = gameState;
+            gameState.playCard(atRandom(gameState.legalPlays()));
+        }
+        EXPECT_TRUE(gameState.bidsDecided());
+        if (decided)
+        {
+            // Only possible when player 3 cannot make their bid either.
+            EXPECT_LT(gameState.tally().tricks[3], 1 + i % 13);
+            decided->fastForward();
+            EXPECT_EQ(decided->getPlayerScores(), gameState.getPlayerScores());
+        }
+    }
+}
+
+TEST(early_termination, playout)
+{
+    const auto rng = math::RandomGenerator{5};
+    for (auto variant : magic_enum::enum_values<GameBehavior::Variant>())
+    {
+        GState gameState{GState::kNoPass, GameBehavior::make(variant)};
+        gameState.startGame();
+        playout(gameState, policies::random(), rng);
+        EXPECT_TRUE(gameState.done());
+        const auto scores = gameState.getPlayerScores();
+        EXPECT_NEAR(std::accumulate(scores.begin(), scores.end(), 0.0), 0.0, 1e-5);
+    }
+}
+
 } // namespace pho::gstate
@@ -0,0 +1,196 @@
+#include "gtest/gtest.h"
+
+#include "cards/utils.hpp"
+#include "gstate/GameRecord.hpp"
+#include "math/MixedRadix.hpp"
+#include "math/combinatorics.hpp"
+#include "prim/range.hpp"
+#include "prim/tests/scratch.hpp"
+
+#include <filesystem>
+
+namespace pho::gstate::tests {
+
+namespace {
+// Play a random game of the variant, recording it. Stops after `plays` plays.
+auto recordRandomGame(GameBehavior behavior, PassOffset passOffset, unsigned plays = kCardsPerDeck)
+    -> std::pair<GameRecord, GState>
+{
+    GState state{GState::Init{Deal::randomDealIndex(), passOffset}, behavior};
+    if (passOffset != 0)
+    {
+        for (auto p : prim::range(kNumPlayers))
+            state.setPassFor(p, chooseThreeAtRandom(state.playersHand(p)));
+    }
+    state.startGame();
+
+    auto record = GameRecord{state};
+    while (state.playIndex() < plays)
+    {
+        const auto card = aCardAtRandom(state.legalPlays());
+        record.add(card);
+        state.playCard(card);
+    }
+    return {record, state};
+}
+
+auto sameState(const GState& a, const GState& b) -> bool
+{
+    for (auto p : prim::range(kNumPlayers))
+    {
+        if (a.playersHand(p) != b.playersHand(p) || a.takenBy(p) != b.takenBy(p))
+            return false;
+    }
+    return a.playIndex() == b.playIndex() && a.currentPlayer() == b.currentPlayer()
+        && a.dealIndex() == b.dealIndex();
+}
+} // namespace
+
+TEST(GameRecord, round_trip_all_variants)
+{
+    for (auto behavior : {GState::kStandard, GState::kJackDiamonds, GState::kSpades})
+    {
+        auto totalBytes = size_t{};
+        constexpr auto kGames = 200;
+        for (auto i : prim::range(kGames))
+        {
+            const auto [record, state] = recordRandomGame(behavior, PassOffset(i % 4));
+            const auto encoded = record.encode();
+            totalBytes += encoded.size();
+            EXPECT_LE(encoded.size(), 41u);
+
+            const auto decoded = GameRecord::decode(encoded.data(), encoded.size());
+            EXPECT_EQ(decoded, record);
+            EXPECT_TRUE(sameState(decoded.replay(), state));
+            EXPECT_EQ(decoded.replay().getPlayerScores(), state.getPlayerScores());
+        }
+        const auto averageBytes = double(totalBytes) / kGames;
+        EXPECT_GT(averageBytes, 20.0);
+        EXPECT_LT(averageBytes, 32.0);
+    }
+}
+
+TEST(GameRecord, spades_first_lead_and_bids)
+{
+    GState state{GState::Init{Deal::randomDealIndex(), 0}, GState::kSpades};
+    state.setBid(0, 3);
+    state.setBid(1, 13);
+    state.setBid(2, 1);
+    state.setBid(3, 4);
+    state.startGame(2);
+    EXPECT_EQ(state.currentPlayer(), 2u);
+
+    auto record = GameRecord{state};
+    while (!state.done())
+    {
+        const auto card = aCardAtRandom(state.legalPlays());
+        record.add(card);
+        state.playCard(card);
+    }
+
+    const auto encoded = record.encode();
+    const auto decoded = GameRecord::decode(encoded.data(), encoded.size());
+    EXPECT_EQ(decoded.firstLead(), 2u);
+    EXPECT_EQ(decoded.bids(), (GameRecord::Bids{3, 13, 1, 4}));
+    EXPECT_EQ(decoded.replay().getPlayerScores(), state.getPlayerScores());
+}
+
+TEST(GameRecord, rejects_partial_bids)
+{
+    GState state{GState::Init{Deal::randomDealIndex(), 0}, GState::kSpades};
+    state.setBid(0, 3);
+    state.setBid(2, 5);
+    state.startGame(0);
+    EXPECT_THROW(GameRecord{state}, std::invalid_argument);
+}
+
+TEST(GameRecord, partial_games)
+{
+    for (auto plays : {0u, 1u, 17u, 51u})
+    {
+        const auto [record, state] = recordRandomGame(GState::kStandard, 1, plays);
+        const auto encoded = record.encode();
+        const auto decoded = GameRecord::decode(encoded.data(), encoded.size());
+        EXPECT_EQ(decoded.plays().size(), plays);
+        EXPECT_TRUE(sameState(decoded.replay(), state));
+    }
+}
+
+TEST(GameRecord, rejects_bad_input)
+{
+    auto [record, state] = recordRandomGame(GState::kStandard, 0, 1);
+    // The two of clubs was played, so it cannot be played again.
+    record.add(Card::cardFor(kClubs, kTwo));
+    EXPECT_THROW(record.encode(), std::invalid_argument);
+
+    // A deal index that is out of range
+    const auto dealHighRadix = uint64_t((math::possibleDistinguishableDeals() - 1) >> 64) + 1;
+    auto digits = math::MixedRadixEncoder{};
+    digits.push(0, 64);
+    digits.push(standard, 3);
+    digits.push(~uint32_t{0}, math::kMaxRadix);
+    digits.push(~uint32_t{0}, math::kMaxRadix);
+    digits.push(uint32_t(dealHighRadix - 1), dealHighRadix);
+    auto badDeal = digits.bytes();
+    badDeal.front() |= uint8_t(badDeal.size());
+    EXPECT_THROW(GameRecord::decode(badDeal.data(), badDeal.size()), std::invalid_argument);
+
+    // A value larger than the product of all the radices of the record is not valid.
+    const auto [complete, _] = recordRandomGame(GState::kStandard, 2);
+    auto encoded = complete.encode();
+    encoded.resize(64, 0xff);
+    EXPECT_THROW(GameRecord::decode(encoded.data(), encoded.size()), std::invalid_argument);
+
+    // Every nonempty proper prefix of an encoding is rejected, rather than decoded as some shorter game. (The empty
+    // encoding is that of the empty record.)
+    encoded = complete.encode();
+    for (auto size : prim::range(size_t{1}, encoded.size()))
+        EXPECT_THROW(GameRecord::decode(encoded.data(), size), std::invalid_argument) << size;
+}
+
+TEST(GameRecord, archive)
+{
+    const auto path = prim::tests::scratchPath("game_records");
+
+    auto records = std::vector<GameRecord>{};
+    {
+        auto writer = GameRecordWriter{path};
+        for (auto i : prim::range(50))
+        {
+            records.push_back(recordRandomGame(GState::kJackDiamonds, PassOffset(i % 4)).first);
+            writer.append(records.back());
+        }
+        writer.close();
+        EXPECT_EQ(writer.recordsWritten(), 50u);
+        EXPECT_EQ(writer.bytesWritten(), std::filesystem::file_size(path));
+    }
+
+    {
+        auto reader = GameRecordReader{path};
+        auto record = GameRecord{};
+        auto count = size_t{};
+        while (reader.next(record))
+        {
+            ASSERT_LT(count, records.size());
+            EXPECT_EQ(record, records[count]);
+            ++count;
+        }
+        EXPECT_EQ(count, records.size());
+    }
+
+    // Truncate in the middle of the last record
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+    {
+        auto reader = GameRecordReader{path};
+        auto readAll = [&reader]() {
+            auto record = GameRecord{};
+            while (reader.next(record)) { }
+        };
+        EXPECT_THROW(readAll(), std::runtime_error);
+    }
+
+    std::filesystem::remove(path);
+    EXPECT_THROW(GameRecordReader{path}, std::runtime_error);
+}
+
+} // namespace pho::gstate::tests
@@ -0,0 +1,150 @@
+#include "gtest/gtest.h"
+
+#include "cards/utils.hpp"
+#include "gstate/GameReplay.hpp"
+#include "prim/range.hpp"
+#include "prim/tests/scratch.hpp"
+
+#include <filesystem>
+
+namespace pho::gstate::tests {
+
+namespace {
+struct PlayedGame
+{
+    GameRecord record;
+    std::vector<GState> states; // states[i] is the state before play i, states.back() the final state
+};
+
+auto playRandomGame(GameBehavior behavior, PassOffset passOffset, unsigned plays = kCardsPerDeck) -> PlayedGame
+{
+    GState state{GState::Init{Deal::randomDealIndex(), passOffset}, behavior};
+    if (passOffset != 0)
+    {
+        for (auto p : prim::range(kNumPlayers))
+            state.setPassFor(p, chooseThreeAtRandom(state.playersHand(p)));
+    }
+    state.startGame();
+
+    auto game = PlayedGame{GameRecord{state}, {}};
+    while (state.playIndex() < plays)
+    {
+        game.states.push_back(state);
+        const auto card = aCardAtRandom(state.legalPlays());
+        game.record.add(card);
+        state.playCard(card);
+    }
+    game.states.push_back(state);
+    return game;
+}
+
+auto expectSameState(const GState& actual, const GState& expected)
+{
+    ASSERT_EQ(actual.playIndex(), expected.playIndex());
+    EXPECT_EQ(actual.currentPlayer(), expected.currentPlayer());
+    EXPECT_EQ(actual.trickLead(), expected.trickLead());
+    EXPECT_EQ(actual.unplayedCards(), expected.unplayedCards());
+    EXPECT_EQ(actual.allTaken(), expected.allTaken());
+    EXPECT_EQ(actual.currentTrick().rep(), expected.currentTrick().rep());
+    EXPECT_EQ(actual.priorTrick().rep(), expected.priorTrick().rep());
+    EXPECT_EQ(actual.voidsForOthers(), expected.voidsForOthers());
+    for (auto p : prim::range(kNumPlayers))
+    {
+        EXPECT_EQ(actual.playersHand(p), expected.playersHand(p));
+        EXPECT_EQ(actual.playedBy(p), expected.playedBy(p));
+        EXPECT_EQ(actual.takenBy(p), expected.takenBy(p));
+        EXPECT_EQ(actual.passedBy(p), expected.passedBy(p));
+    }
+    if (!expected.done())
+        EXPECT_EQ(actual.legalPlays(), expected.legalPlays());
+    else
+        EXPECT_EQ(actual.getPlayerScores(), expected.getPlayerScores());
+}
+} // namespace
+
+TEST(GameReplay, every_ply_matches_play)
+{
+    for (auto behavior : {GState::kStandard, GState::kJackDiamonds, GState::kSpades})
+    {
+        for (auto i : prim::range(20))
+        {
+            const auto game = playRandomGame(behavior, PassOffset(i % 4));
+            const auto encoded = game.record.encode();
+
+            for (const auto& replay : {GameReplay{game.record}, GameReplay::decode(encoded.data(), encoded.size())})
+            {
+                ASSERT_EQ(replay.numPlies(), kCardsPerDeck);
+                EXPECT_EQ(replay.record(), game.record);
+                for (auto ply : prim::range(kCardsPerDeck + 1))
+                    expectSameState(replay.stateAt(ply), game.states.at(ply));
+            }
+        }
+    }
+}
+
+TEST(GameReplay, seek_in_any_order)
+{
+    const auto game = playRandomGame(GState::kStandard, 2);
+    const auto replay = GameReplay{game.record};
+
+    auto state = replay.stateAt(0);
+    for (auto ply : {51u, 3u, 4u, 52u, 0u, 27u, 26u, 13u})
+    {
+        replay.seek(ply, state);
+        expectSameState(state, game.states.at(ply));
+    }
+    EXPECT_THROW(replay.seek(53, state), std::out_of_range);
+}
+
+TEST(GameReplay, partial_games)
+{
+    for (auto plays : {0u, 1u, 4u, 8u, 30u})
+    {
+        const auto game = playRandomGame(GState::kJackDiamonds, 3, plays);
+        const auto encoded = game.record.encode();
+        const auto replay = GameReplay::decode(encoded.data(), encoded.size());
+        ASSERT_EQ(replay.numPlies(), plays);
+        for (auto ply : prim::range(plays + 1))
+            expectSameState(replay.stateAt(ply), game.states.at(ply));
+    }
+}
+
+TEST(GameReplay, illegal_play_is_rejected)
+{
+    auto game = playRandomGame(GState::kStandard, 0, 4);
+    auto record = game.record;
+    record.add(Card::cardFor(kClubs, kTwo)); // already played
+    EXPECT_THROW(GameReplay{record}, std::invalid_argument);
+}
+
+TEST(GameReplay, bulk_stream)
+{
+    const auto path = prim::tests::scratchPath("replay_stream");
+
+    auto games = std::vector<PlayedGame>{};
+    {
+        auto writer = GameRecordWriter{path};
+        for (auto i : prim::range(30))
+        {
+            games.push_back(playRandomGame(GState::kStandard, PassOffset(i % 4)));
+            writer.append(games.back().record);
+        }
+    }
+
+    auto reader = GameRecordReader{path};
+    auto plies = size_t{};
+    const auto numGames = forEachPly(reader, [&](const GState& state, Card play) {
+        const auto& game = games.at(plies / kCardsPerDeck);
+        const auto ply = plies % kCardsPerDeck;
+        EXPECT_EQ(state.playIndex(), ply);
+        EXPECT_EQ(play, game.record.plays().at(ply));
+        expectSameState(state, game.states.at(ply));
+        ++plies;
+    });
+    EXPECT_EQ(numGames, games.size());
+    EXPECT_EQ(plies, games.size() * kCardsPerDeck);
+
+    std::filesystem::remove(path);
+}
+
+} // namespace pho::gstate::tests
@@ -0,0 +1,115 @@
+#include "gtest/gtest.h"
+
+#include "gstate/BeliefState.hpp"
+#include "gstate/KnowableState.hpp"
+#include "gstate/Policy.hpp"
+#include "prim/range.hpp"
+
+#include <unordered_set>
+
+namespace pho::gstate::tests {
+
+TEST(KnowableState, hides_what_the_seat_cannot_see)
+{
+    const auto rng = math::RandomGenerator{2};
+    for (auto passOffset : {0, 1, 2, 3})
+    {
+        for (auto plays : {0u, 9u, 26u, 50u})
+        {
+            const auto state = randomState(GState::kStandard, PassOffset(passOffset), plays, rng);
+            for (auto seat : prim::range(kNumPlayers))
+            {
+                const auto known = KnowableState{state, seat};
+                EXPECT_TRUE(known.consistent(state.hands()));
+                auto placed = known.unknownCards();
+                for (auto p : prim::range(kNumPlayers))
+                    placed += known.knownHand(p);
+                EXPECT_EQ(placed, state.unplayedCards());
+
+                // Another world the seat cannot tell from the real one has the same information set.
+                const auto sampler = WorldSampler{state, seat};
+                const auto other = known.determinize(sampler(rng), rng);
+                const auto same = KnowableState{other, seat};
+                EXPECT_EQ(same, known);
+                EXPECT_EQ(same.hash(), known.hash());
+                EXPECT_EQ(other.playersHand(seat), state.playersHand(seat));
+                EXPECT_EQ(other.playIndex(), state.playIndex());
+                EXPECT_EQ(other.currentPlayer(), state.currentPlayer());
+                EXPECT_EQ(other.tally().points, state.tally().points);
+                EXPECT_EQ(other.tally().tricks, state.tally().tricks);
+                if (seat == state.currentPlayer())
+                {
+                    EXPECT_EQ(other.legalPlays(), state.legalPlays());
+                }
+            }
+        }
+    }
+}
+
+TEST(KnowableState, tells_information_sets_apart)
+{
+    const auto rng = math::RandomGenerator{4};
+    auto hashes = std::unordered_set<uint64_t>{};
+    auto sets = std::unordered_set<KnowableState>{};
+    auto state = randomState(GState::kStandard, 1, 0, rng);
+    const auto policy = policies::random();
+    while (!state.done())
+    {
+        for (auto seat : prim::range(kNumPlayers))
+        {
+            hashes.insert(KnowableState{state, seat}.hash());
+            sets.insert(KnowableState{state, seat});
+        }
+        state.playCard(policy(state, rng));
+    }
+    EXPECT_EQ(hashes.size(), kCardsPerDeck * kNumPlayers);
+    EXPECT_EQ(sets.size(), kCardsPerDeck * kNumPlayers);
+
+    // The same position with other hands for the seat is a different information set.
+    const auto first = randomState(GState::kStandard, 0, 0, math::RandomGenerator{5});
+    const auto second = randomState(GState::kStandard, 0, 0, math::RandomGenerator{6});
+    EXPECT_NE(KnowableState(first, 0).hash(), KnowableState(second, 0).hash());
+}
+
+TEST(KnowableState, determinizes)
+{
+    const auto rng = math::RandomGenerator{8};
+    const auto policy = policies::random();
+    for (auto passOffset : {1, 2, 3})
+    {
+        const auto state = randomState(GState::kStandard, PassOffset(passOffset), 17, rng);
+        const auto known = KnowableState{state, 3};
+        for (auto trial : prim::range(20))
+        {
+            (void)trial;
+            auto world = known.determinize(rng);
+            EXPECT_TRUE(known.consistent(world.hands()));
+            EXPECT_EQ(world.passedBy(3), state.passedBy(3));
+            EXPECT_EQ(world.dealIndex(), ~DealIndex{0});
+            while (!world.done())
+                world.playCard(policy(world, rng));
+        }
+
+        // With the actual hands the game plays out as the original does.
+        auto original = state;
+        auto rebuilt = known.determinize(state.hands(), rng);
+        while (!original.done())
+        {
+            ASSERT_EQ(rebuilt.legalPlays(), original.legalPlays());
+            const auto card = policy(original, rng);
+            original.playCard(card);
+            rebuilt.playCard(card);
+        }
+        EXPECT_EQ(rebuilt.getPlayerScores(), original.getPlayerScores());
+
+        // Hands that contradict what the seat knows are refused.
+        auto swapped = state.hands();
+        std::swap(swapped.at(0), swapped.at(3));
+        EXPECT_FALSE(known.consistent(swapped));
+        EXPECT_THROW(known.determinize(swapped, rng), std::invalid_argument);
+    }
+
+    EXPECT_THROW(KnowableState(GState{}, 0), std::invalid_argument);
+}
+
+} // namespace pho::gstate::tests
@@ -0,0 +1,143 @@
+#include "gtest/gtest.h"
+
+#include "gstate/Sprt.hpp"
+#include "math/elo.hpp"
+#include "math/random.hpp"
+#include "prim/range.hpp"
+
+#include <cmath>
+#include <limits>
+
+namespace pho::gstate {
+
+namespace {
+// Run the test on games won with the probability of the given Elo delta, until it decides or gives up.
+auto runSprt(const Sprt& sprt, double elo, const math::RandomGenerator& rng) -> Sprt::Decision
+{
+    const auto p = math::inverseEloDelta(elo);
+    auto samples = stats::RunningStats{};
+    for (auto i : prim::range(100000))
+    {
+        (void)i;
+        samples.accumulate(rng.randNorm() < p ? 1.0 : 0.0);
+        const auto decision = sprt.decide(samples);
+        if (decision != Sprt::eContinue)
+            return decision;
+    }
+    return Sprt::eContinue;
+}
+} // namespace
+
+TEST(Sprt, rejects_bad_hypotheses)
+{
+    EXPECT_THROW(Sprt(SprtConfig{10.0, 10.0, 0.05, 0.05}), std::invalid_argument);
+    EXPECT_THROW(Sprt(SprtConfig{0.0, 10.0, 0.0, 0.05}), std::invalid_argument);
+    EXPECT_THROW(Sprt(SprtConfig{0.0, 10.0, 0.05, 0.5}), std::invalid_argument);
+    EXPECT_NO_THROW(Sprt(SprtConfig{10.0, 0.0, 0.05, 0.05}));
+}
+
+TEST(Sprt, weighs_the_evidence)
+{
+    const auto sprt = Sprt{SprtConfig{0.0, 50.0, 0.05, 0.05}};
+    EXPECT_NEAR(sprt.upperBound(), std::log(19.0), 1e-12);
+    EXPECT_NEAR(sprt.lowerBound(), -std::log(19.0), 1e-12);
+
+    auto samples = stats::RunningStats{};
+    samples.accumulate(1.0);
+    EXPECT_EQ(sprt.llr(samples), 0.0);
+    samples.accumulate(1.0);
+    EXPECT_EQ(sprt.llr(samples), 0.0) << "identical samples carry no evidence";
+
+    // Halfway between the hypotheses the evidence is balanced; above it favours H1, below it H0.
+    const auto middle = (math::inverseEloDelta(0.0) + math::inverseEloDelta(50.0)) / 2;
+    samples = stats::RunningStats{};
+    samples.accumulate(middle - 0.25);
+    samples.accumulate(middle + 0.25);
+    EXPECT_NEAR(sprt.llr(samples), 0.0, 1e-12);
+    samples.accumulate(1.0);
+    EXPECT_GT(sprt.llr(samples), 0.0);
+    samples.accumulate(0.0);
+    samples.accumulate(0.0);
+    EXPECT_LT(sprt.llr(samples), 0.0);
+}
+
+TEST(Sprt, keeps_its_error_rates)
+{
+    const auto config = SprtConfig{0.0, 50.0, 0.05, 0.05};
+    const auto sprt = Sprt{config};
+    const auto rng = math::RandomGenerator{2024};
+    constexpr auto kRuns = 1000;
+
+    auto falseH1 = 0;
+    auto falseH0 = 0;
+    for (auto run : prim::range(kRuns))
+    {
+        (void)run;
+        const auto underH0 = runSprt(sprt, config.elo0, rng);
+        const auto underH1 = runSprt(sprt, config.elo1, rng);
+        ASSERT_NE(underH0, Sprt::eContinue);
+        ASSERT_NE(underH1, Sprt::eContinue);
+        falseH1 += underH0 == Sprt::eAcceptH1;
+        falseH0 += underH1 == Sprt::eAcceptH0;
+    }
+    // The normal approximation overshoots the nominal rates a little (about 6% for 5%); twice them leaves room for
+    // that and for the sampling noise of the runs.
+    EXPECT_LE(falseH1, 2 * config.alpha * kRuns);
+    EXPECT_LE(falseH0, 2 * config.beta * kRuns);
+}
+
+TEST(Sprt, confidence_sequence_covers_the_mean_at_every_step)
+{
+    constexpr auto kAlpha = 0.1;
+    constexpr auto kRuns = 200;
+    const auto rng = math::RandomGenerator{7};
+    const auto p = math::inverseEloDelta(30.0);
+
+    auto misses = 0;
+    for (auto run : prim::range(kRuns))
+    {
+        (void)run;
+        auto samples = stats::RunningStats{};
+        auto missed = false;
+        for (auto i : prim::range(2000))
+        {
+            samples.accumulate(rng.randNorm() < p ? 1.0 : 0.0);
+            if (i < 30)
+                continue;
+            const auto [low, high] = confidenceSequence(samples, kAlpha, 200.0);
+            missed = missed || p < low || p > high;
+        }
+        misses += missed;
+    }
+    // Ever missing the mean, at any of the steps, is what the sequence bounds.
+    EXPECT_LE(misses, 1.5 * kAlpha * kRuns);
+
+    auto samples = stats::RunningStats{};
+    EXPECT_TRUE(std::isinf(confidenceSequence(samples, kAlpha).first));
+    EXPECT_THROW(confidenceSequence(samples, 0.0), std::invalid_argument);
+    EXPECT_THROW(confidenceSequence(samples, kAlpha, 0.0), std::invalid_argument);
+}
+
+TEST(Sprt, elo_confidence_sequence_narrows)
+{
+    const auto rng = math::RandomGenerator{11};
+    const auto p = math::inverseEloDelta(100.0);
+    auto samples = stats::RunningStats{};
+    auto previous = std::numeric_limits<double>::infinity();
+    for (auto i : prim::range(1, 20001))
+    {
+        samples.accumulate(rng.randNorm() < p ? 1.0 : 0.0);
+        if (i % 5000 == 0)
+        {
+            const auto [low, high] = eloConfidenceSequence(samples, 0.05);
+            const auto elo = math::eloDelta(samples.mean());
+            EXPECT_LT(low, elo);
+            EXPECT_GT(high, elo);
+            EXPECT_LT(high - low, previous);
+            previous = high - low;
+        }
+    }
+    EXPECT_LT(previous, 40.0);
+}
+
+} // namespace pho::gstate
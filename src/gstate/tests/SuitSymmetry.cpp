@@ -0,0 +1,151 @@
+#include "gtest/gtest.h"
+
+#include "gstate/Policy.hpp"
+#include "gstate/SuitSymmetry.hpp"
+#include "prim/range.hpp"
+
+namespace pho::gstate::tests {
+
+namespace {
+const auto kSwapClubsDiamonds = SuitPermutation{{kDiamonds, kClubs, kSpades, kHearts}};
+
+// The six permutations of clubs, diamonds and hearts.
+auto plainSuitPermutations() -> std::vector<SuitPermutation>
+{
+    auto result = std::vector<SuitPermutation>{};
+    auto plain = std::array<Suit, 3>{kClubs, kDiamonds, kHearts};
+    do
+        result.push_back(SuitPermutation{{plain[0], plain[1], kSpades, plain[2]}});
+    while (std::next_permutation(plain.begin(), plain.end()));
+    return result;
+}
+
+auto expectSameState(const GState& actual, const GState& expected)
+{
+    ASSERT_EQ(actual.playIndex(), expected.playIndex());
+    EXPECT_EQ(actual.currentPlayer(), expected.currentPlayer());
+    EXPECT_EQ(actual.unplayedCards(), expected.unplayedCards());
+    EXPECT_EQ(actual.allTaken(), expected.allTaken());
+    EXPECT_EQ(actual.currentTrick().rep(), expected.currentTrick().rep());
+    EXPECT_EQ(actual.priorTrick().rep(), expected.priorTrick().rep());
+    EXPECT_EQ(actual.playerVoids().bits(), expected.playerVoids().bits());
+    for (auto p : prim::range(kNumPlayers))
+    {
+        EXPECT_EQ(actual.playersHand(p), expected.playersHand(p));
+        EXPECT_EQ(actual.playedBy(p), expected.playedBy(p));
+        EXPECT_EQ(actual.takenBy(p), expected.takenBy(p));
+        EXPECT_EQ(actual.passedBy(p), expected.passedBy(p));
+    }
+}
+
+// Play both states to the end, the permuted one mirroring the other's plays, and check that the permutation stays
+// a symmetry: the same legal plays up to the permutation, and the same outcome.
+auto expectSymmetricPlayout(GState state, GState permuted, const SuitPermutation& permutation)
+{
+    const auto rng = math::RandomGenerator{5};
+    while (!state.done())
+    {
+        ASSERT_EQ(permutation(state.legalPlays()), permuted.legalPlays());
+        const auto card = state.legalPlays().nthCard(unsigned(rng.range64(state.legalPlays().size())));
+        state.playCard(card);
+        permuted.playCard(permutation(card));
+        ASSERT_EQ(state.currentPlayer(), permuted.currentPlayer());
+    }
+    EXPECT_EQ(state.outcome().scores, permuted.outcome().scores);
+}
+} // namespace
+
+TEST(SuitPermutation, maps_cards_and_sets)
+{
+    const auto permutation = SuitPermutation{{kHearts, kClubs, kSpades, kDiamonds}};
+    EXPECT_EQ(permutation(Card::cardFor(kClubs, kTen)), Card::cardFor(kHearts, kTen));
+    EXPECT_EQ(permutation(Card::cardFor(kSpades, kQueen)), Card::cardFor(kSpades, kQueen));
+    EXPECT_EQ(permutation(Card{}), Card{});
+
+    const auto cards = CardSet::make({Card::cardFor(kClubs, kTwo), Card::cardFor(kDiamonds, kAce)});
+    EXPECT_EQ(permutation(cards), CardSet::make({Card::cardFor(kHearts, kTwo), Card::cardFor(kClubs, kAce)}));
+    EXPECT_EQ(permutation(CardSet::fullDeck()), CardSet::fullDeck());
+    EXPECT_EQ(permutation.inverse()(permutation(cards)), cards);
+    EXPECT_TRUE(permutation.then(permutation.inverse()).isIdentity());
+    EXPECT_EQ(permutation.then(kSwapClubsDiamonds)(Card::cardFor(kClubs, kTen)), Card::cardFor(kHearts, kTen));
+    EXPECT_EQ(permutation.then(kSwapClubsDiamonds)(Card::cardFor(kDiamonds, kTen)), Card::cardFor(kDiamonds, kTen));
+}
+
+TEST(SuitSymmetry, canonical_hand)
+{
+    const auto rng = math::RandomGenerator{11};
+    for (auto trial : prim::range(50))
+    {
+        (void)trial;
+        const auto hand = Deal{Deal::randomDealIndex(rng)}.dealFor(0);
+        const auto canonical = canonicalHand(hand, spades);
+        EXPECT_EQ(canonical.permutation(hand), canonical.hand);
+        EXPECT_EQ(canonical.hand.cardsWithSuit(kSpades), hand.cardsWithSuit(kSpades));
+        for (const auto& permutation : plainSuitPermutations())
+            EXPECT_EQ(canonicalHand(permutation(hand), spades).hand, canonical.hand);
+
+        // Before the first lead clubs are special in the Hearts variants.
+        EXPECT_EQ(canonicalHand(hand, standard).hand, hand);
+        EXPECT_TRUE(canonicalHand(hand, jack).permutation.isIdentity());
+    }
+}
+
+TEST(SuitSymmetry, interchangeable_suits)
+{
+    const auto rng = math::RandomGenerator{3};
+    EXPECT_EQ(interchangeableSuitsAtDeal(standard), 0u);
+    EXPECT_EQ(interchangeableSuitsAtDeal(spades), 0b1011u);
+    EXPECT_EQ(interchangeableSuits(randomState(GState::kStandard, 1, 0, rng)), 0u);
+    EXPECT_EQ(interchangeableSuits(randomState(GState::kStandard, 1, 1, rng)), 0b0011u);
+    EXPECT_EQ(interchangeableSuits(randomState(GState::kSpades, 1, 0, rng)), 0b1011u);
+    EXPECT_EQ(interchangeableSuits(randomState(GState::kJackDiamonds, 1, 1, rng)), 0u);
+}
+
+TEST(SuitSymmetry, canonical_state_spades)
+{
+    const auto rng = math::RandomGenerator{17};
+    for (auto plays : {0u, 5u, 16u, 30u, 47u})
+    {
+        const auto state = randomState(GState::kSpades, 1, plays, rng);
+        const auto canonical = canonicalState(state);
+        expectSameState(canonical.state, state.permuteSuits(canonical.permutation));
+        for (const auto& permutation : plainSuitPermutations())
+        {
+            const auto permuted = state.permuteSuits(permutation);
+            expectSameState(canonicalState(permuted).state, canonical.state);
+            expectSymmetricPlayout(state, permuted, permutation);
+        }
+    }
+}
+
+TEST(SuitSymmetry, canonical_state_hearts)
+{
+    const auto rng = math::RandomGenerator{23};
+    for (auto plays : {1u, 4u, 22u, 41u})
+    {
+        const auto state = randomState(GState::kStandard, 1, plays, rng);
+        const auto permuted = state.permuteSuits(kSwapClubsDiamonds);
+        expectSameState(canonicalState(permuted).state, canonicalState(state).state);
+        expectSymmetricPlayout(state, permuted, kSwapClubsDiamonds);
+    }
+
+    // In the jack variant, only once both jacks are taken.
+    auto found = 0;
+    for (auto trial : prim::range(20))
+    {
+        (void)trial;
+        const auto state = randomState(GState::kJackDiamonds, 1, 40, rng);
+        if (interchangeableSuits(state) == 0)
+        {
+            EXPECT_TRUE(canonicalState(state).permutation.isIdentity());
+            continue;
+        }
+        ++found;
+        const auto permuted = state.permuteSuits(kSwapClubsDiamonds);
+        expectSameState(canonicalState(permuted).state, canonicalState(state).state);
+        expectSymmetricPlayout(state, permuted, kSwapClubsDiamonds);
+    }
+    EXPECT_GT(found, 0);
+}
+
+} // namespace pho::gstate::tests
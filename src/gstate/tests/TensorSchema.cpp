@@ -0,0 +1,171 @@
+#include "gtest/gtest.h"
+
+#include "cards/utils.hpp"
+#include "gstate/GState.hpp"
+#include "gstate/TensorSchema.hpp"
+#include "prim/range.hpp"
+
+#include <cstring>
+
+namespace pho::gstate {
+
+namespace {
+
+// The hand-written min2022 encoder that the schema replaced, kept verbatim as the reference implementation.
+// It requires that the output is zero-filled before it is called.
+auto legacyMin2022InputTensor(const GState& self, float* data) -> void
+{
+    using namespace min2022;
+
+    const auto mainToState = [&](unsigned pMain) -> unsigned {
+        assert(pMain < kNumPlayers);
+        return (self.currentPlayer() + pMain) % kNumPlayers;
+    };
+
+    float(*rowAccessor)[kNumInFeatures] = reinterpret_cast<float(*)[kNumInFeatures]>(data);
+
+    for (auto card : self.legalPlays())
+    {
+        auto cardAccessor = rowAccessor[card.ord()];
+        cardAccessor[eLegalPlay] = 1.0;
+    }
+
+    GState::ProbArray prob = self.asProbabilities();
+    for (auto pMain : prim::range(kNumPlayers))
+    {
+        auto pState = mainToState(pMain);
+        for (Card card : CardSet::fullDeck())
+        {
+            rowAccessor[card.ord()][eP0ProbHasCard + pMain] = prob[card.ord()][pState];
+        }
+    }
+
+    for (auto pMain : prim::range(kNumPlayers))
+    {
+        auto pState = mainToState(pMain);
+        for (Card card : self.takenBy(pState))
+        {
+            rowAccessor[card.ord()][eP0TakenCard + pMain] = 1.0;
+        }
+    }
+
+    if (self.playInTrick() > 0)
+    {
+        rowAccessor[self.getTrickPlay(0).ord()][eCardLeadingTrick] = 1.0;
+        rowAccessor[self.highCardInTrick().ord()][eHighCardInTrick] = 1.0;
+
+        for (auto pTrick : prim::range(self.playInTrick()))
+        {
+            Card card = self.getTrickPlay(pTrick);
+            rowAccessor[card.ord()][eCardOnTable] = 1.0;
+        }
+    }
+}
+
+auto passingSetup(GState& gameState)
+{
+    for (auto p : prim::range(kNumPlayers))
+    {
+        auto hand = gameState.playersHand(p);
+        gameState.setPassFor(p, chooseThreeAtRandom(hand));
+    }
+}
+
+template <typename Visitor>
+auto forEachPlayInRandomGames(GameVariant variant, unsigned numGames, Visitor visit)
+{
+    for (auto i : prim::range(numGames))
+    {
+        GState gameState{GState::Init{Deal::randomDealIndex(), PassOffset(i % 4)}, GameBehavior::make(variant)};
+        if (gameState.passOffset() != 0)
+            passingSetup(gameState);
+        gameState.startGame();
+
+        while (!gameState.done())
+        {
+            visit(gameState);
+            gameState.playCard(aCardAtRandom(gameState.legalPlays()));
+        }
+    }
+}
+
+using Tensor = std::array<float, min2022::Schema::kFloats>;
+
+} // namespace
+
+TEST(TensorSchema, min2022_bit_for_bit)
+{
+    for (auto variant : {GameVariant::standard, GameVariant::jack, GameVariant::spades})
+    {
+        forEachPlayInRandomGames(variant, 20, [](const GState& gameState) {
+            auto expected = Tensor{};
+            legacyMin2022InputTensor(gameState, expected.data());
+
+            auto actual = Tensor{};
+            actual.fill(-1.0f); // The schema encoder must overwrite every element
+            gameState.asMin2022InputTensor(actual.data());
+
+            ASSERT_EQ(0, std::memcmp(expected.data(), actual.data(), sizeof(Tensor)));
+        });
+    }
+}
+
+TEST(TensorSchema, layout)
+{
+    using namespace tensor;
+    using S = Schema<LegalPlays, TrickPosition, ProbHasCard, PointCards>;
+
+    EXPECT_EQ(S::kWidth, 9u);
+    EXPECT_EQ(S::kFloats, 9u * 52u);
+    EXPECT_EQ(S::offsetOf<LegalPlays>(), 0u);
+    EXPECT_EQ(S::offsetOf<TrickPosition>(), 1u);
+    EXPECT_EQ(S::offsetOf<ProbHasCard>(), 4u);
+    EXPECT_EQ(S::offsetOf<PointCards>(), 8u);
+
+    constexpr auto scaled = S::scaledColumns();
+    EXPECT_EQ(std::count(scaled.begin(), scaled.end(), true), 4);
+    EXPECT_TRUE(scaled[4] && scaled[7]);
+    EXPECT_FALSE(scaled[3] || scaled[8]);
+}
+
+TEST(TensorSchema, extra_features)
+{
+    using namespace tensor;
+    using S = Schema<PlayedBySeat, PointsTakenBySeat, VoidsBySeat, TrickPosition, PointCards>;
+
+    forEachPlayInRandomGames(GameVariant::standard, 10, [](const GState& gameState) {
+        auto tensor = std::array<float, S::kFloats>{};
+        S::encode(gameState, tensor.data());
+
+        const auto at = [&](Card card, unsigned col) { return tensor[card.ord() * S::kWidth + col]; };
+        const auto carl = gameState.currentPlayer();
+
+        for (auto pMain : prim::range(kNumPlayers))
+        {
+            const auto pState = (carl + pMain) % kNumPlayers;
+            for (Card card : CardSet::fullDeck())
+            {
+                const auto played = gameState.playedBy(pState).hasCard(card);
+                EXPECT_EQ(at(card, S::offsetOf<PlayedBySeat>() + pMain), played ? 1.0f : 0.0f);
+
+                const auto pointTaken = gameState.takenBy(pState).hasCard(card) && kPointCards.hasCard(card);
+                EXPECT_EQ(at(card, S::offsetOf<PointsTakenBySeat>() + pMain), pointTaken ? 1.0f : 0.0f);
+            }
+        }
+
+        // Carl is void exactly in the suits missing from his hand
+        for (Suit suit : allSuits)
+        {
+            const auto isVoid = gameState.currentPlayersHand().cardsWithSuit(suit).empty();
+            EXPECT_EQ(at(cardFor(suit, kAce), S::offsetOf<VoidsBySeat>()), isVoid ? 1.0f : 0.0f);
+        }
+
+        for (auto pTrick : prim::range(gameState.playInTrick()))
+            EXPECT_EQ(at(gameState.getTrickPlay(pTrick), S::offsetOf<TrickPosition>() + pTrick), 1.0f);
+
+        EXPECT_EQ(at(cardFor(kSpades, kQueen), S::offsetOf<PointCards>()), 1.0f);
+        EXPECT_EQ(at(cardFor(kSpades, kKing), S::offsetOf<PointCards>()), 0.0f);
+    });
+}
+
+} // namespace pho::gstate
@@ -0,0 +1,82 @@
+#include "math/MixedRadix.hpp"
+
+#include <assert.h>
+#include <cmath>
+
+namespace pho::math {
+
+void MixedRadixEncoder::push(uint32_t digit, uint64_t radix)
+{
+    assert(radix > 0 && radix <= kMaxRadix);
+    assert(digit < radix);
+    if (radix > 1)
+        mDigits.push_back(Digit{digit, radix});
+}
+
+std::vector<uint8_t> MixedRadixEncoder::bytes() const
+{
+    // Horner's rule from the most significant (last) digit: value = value * radix + digit.
+    auto limbs = std::vector<uint32_t>{};
+    for (auto it = mDigits.rbegin(); it != mDigits.rend(); ++it)
+    {
+        uint64_t carry = it->digit;
+        for (auto& limb : limbs)
+        {
+            const uint64_t product = limb * it->radix + carry; // < 2^64 as radix <= 2^32
+            limb = uint32_t(product);
+            carry = product >> 32;
+        }
+        if (carry != 0)
+            limbs.push_back(uint32_t(carry));
+    }
+
+    auto result = std::vector<uint8_t>{};
+    result.reserve(limbs.size() * sizeof(uint32_t));
+    for (auto limb : limbs)
+    {
+        for (unsigned i = 0; i < sizeof(uint32_t); ++i)
+            result.push_back(uint8_t(limb >> (8 * i)));
+    }
+    while (!result.empty() && result.back() == 0)
+        result.pop_back();
+    return result;
+}
+
+unsigned MixedRadixEncoder::bits() const
+{
+    double bits = 0.0;
+    for (const auto& digit : mDigits)
+        bits += std::log2(double(digit.radix));
+    return unsigned(std::ceil(bits));
+}
+
+MixedRadixDecoder::MixedRadixDecoder(const uint8_t* data, size_t size)
+: mLimbs((size + sizeof(uint32_t) - 1) / sizeof(uint32_t))
+{
+    for (size_t i = 0; i < size; ++i)
+        mLimbs[i / sizeof(uint32_t)] |= uint32_t{data[i]} << (8 * (i % sizeof(uint32_t)));
+    while (!mLimbs.empty() && mLimbs.back() == 0)
+        mLimbs.pop_back();
+}
+
+uint32_t MixedRadixDecoder::pop(uint64_t radix)
+{
+    assert(radix > 0 && radix <= kMaxRadix);
+    if (radix == 1)
+        return 0;
+
+    uint64_t remainder = 0;
+    for (auto it = mLimbs.rbegin(); it != mLimbs.rend(); ++it)
+    {
+        const uint64_t dividend = (remainder << 32) | *it;
+        *it = uint32_t(dividend / radix);
+        remainder = dividend % radix;
+    }
+    while (!mLimbs.empty() && mLimbs.back() == 0)
+        mLimbs.pop_back();
+    return uint32_t(remainder);
+}
+
+bool MixedRadixDecoder::empty() const { return mLimbs.empty(); }
+
+} // namespace pho::math
@@ -3,6 +3,10 @@
 #include "math/math.hpp"
 #include <stdint.h>
 
+#ifdef __BMI2__
+#include <immintrin.h>
+#endif
+
 namespace pho::math {
 
 inline int leastSetBitIndex(uint64_t x) { return x == 0 ? 64 : __builtin_ctzll(x); }
@@ -21,6 +25,38 @@ inline uint64_t isolateLeastBit(uint64_t x) { return uint64_t{1} << leastSetBitI
 
 inline uint64_t isolateGreatestBit(uint64_t x) { return uint64_t{1} << greatestSetBitIndex(x); }
 
+// Scatter the low bits of x to the set positions of mask, lowest first (PDEP).
+inline uint64_t depositBits(uint64_t x, uint64_t mask)
+{
+#ifdef __BMI2__
+    return _pdep_u64(x, mask);
+#else
+    uint64_t result = 0;
+    for (uint64_t bit = 1; mask != 0; bit <<= 1, mask &= mask - 1)
+    {
+        if (x & bit)
+            result |= mask & -mask;
+    }
+    return result;
+#endif
+}
+
+// Gather the bits of x at the set positions of mask into the low bits, lowest first (PEXT).
+inline uint64_t extractBits(uint64_t x, uint64_t mask)
+{
+#ifdef __BMI2__
+    return _pext_u64(x, mask);
+#else
+    uint64_t result = 0;
+    for (uint64_t bit = 1; mask != 0; bit <<= 1, mask &= mask - 1)
+    {
+        if (x & mask & -mask)
+            result |= bit;
+    }
+    return result;
+#endif
+}
+
 inline uint64_t roundUpToPowerOfTwo(uint64_t n)
 {
     uint64_t b = uint64_t{1} << greatestSetBitIndex(n);
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "math/random.hpp"
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+namespace pho::math {
+
+// The number of 64-bit lanes of the widest vector registers of the target: 8 with AVX-512, 4 with AVX2, and 2
+// otherwise (SSE2, NEON and WASM SIMD128).
+#if defined(__AVX512F__)
+constexpr size_t kSimdLanes = 8;
+#elif defined(__AVX2__)
+constexpr size_t kSimdLanes = 4;
+#else
+constexpr size_t kSimdLanes = 2;
+#endif
+
+/// @brief kLanes independent xoshiro256** generators stepped together, for filling buffers of random numbers.
+///
+/// The state is kept as four arrays of kLanes words, so one step of all lanes is a handful of loops over the
+/// lanes with no dependency between them, which the compiler turns into vector instructions for the target
+/// (given e.g. -mavx2). Lane j is the base generator advanced by j jumps of 2^128 draws, so the lanes never
+/// overlap, and lane j of LaneGenerator{seed} produces exactly the values of RandomGenerator::forWorker(seed, j).
+///
+/// Values are returned lane-interleaved: step k of lane j is value k * kLanes + j of the concatenation of all
+/// fills, whatever the sizes of the individual fills.
+template <size_t kLanes>
+class LaneGenerator
+{
+public:
+    static_assert(kLanes > 0);
+
+    explicit LaneGenerator(uint64_t seed)
+    : LaneGenerator{RandomGenerator{seed}}
+    { }
+
+    explicit LaneGenerator(RandomGenerator base)
+    {
+        for (size_t j = 0; j < kLanes; ++j)
+        {
+            for (int w = 0; w < RandomGenerator::kStateWords; ++w)
+                mState[w][j] = base.s[w];
+            base.jump();
+        }
+    }
+
+    /// @brief Fill `out` with the next n values.
+    void fill(uint64_t* out, size_t n) const
+    {
+        for (; n > 0 && mUsed < kLanes; --n)
+            *out++ = mBuffer[mUsed++];
+        for (; n >= kLanes; n -= kLanes, out += kLanes)
+            step(out);
+        if (n > 0)
+        {
+            step(mBuffer.data());
+            for (mUsed = 0; mUsed < n; ++mUsed)
+                *out++ = mBuffer[mUsed];
+        }
+    }
+
+    /// @brief Fill `out` with n values uniform over [0, range), range > 0.
+    /// This is Lemire's method as in RandomGenerator::range64(), but the rejection threshold is computed once
+    /// per call and rejected values are replaced from later raw values, so the bounded values are not the same
+    /// as range64() of the individual lanes would produce.
+    void fillRange(uint64_t* out, size_t n, uint64_t range) const
+    {
+        assert(range > 0);
+        const uint64_t threshold = -range % range;
+        size_t produced = 0;
+        while (produced < n)
+        {
+            fill(out + produced, n - produced);
+            auto accepted = produced;
+            for (auto i = produced; i < n; ++i)
+            {
+                const auto m = uint128_t{out[i]} * range;
+                if (uint64_t(m) >= threshold)
+                    out[accepted++] = uint64_t(m >> 64);
+            }
+            produced = accepted;
+        }
+    }
+
+private:
+    static inline uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+    // Advance every lane one step, writing one value per lane.
+    void step(uint64_t* out) const
+    {
+        auto& [s0, s1, s2, s3] = mState;
+        for (size_t j = 0; j < kLanes; ++j)
+        {
+            out[j] = rotl(s1[j] * 5, 7) * 9;
+            const uint64_t t = s1[j] << 17;
+            s2[j] ^= s0[j];
+            s3[j] ^= s1[j];
+            s1[j] ^= s2[j];
+            s0[j] ^= s3[j];
+            s2[j] ^= t;
+            s3[j] = rotl(s3[j], 45);
+        }
+    }
+
+    alignas(64) mutable std::array<std::array<uint64_t, kLanes>, RandomGenerator::kStateWords> mState;
+    mutable std::array<uint64_t, kLanes> mBuffer{};
+    mutable size_t mUsed{kLanes}; // the number of values of mBuffer already returned
+};
+
+using SimdRandomGenerator = LaneGenerator<kSimdLanes>;
+
+} // namespace pho::math
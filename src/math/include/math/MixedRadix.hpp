@@ -0,0 +1,55 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace pho::math {
+
+// Mixed-radix coding packs a sequence of digits, each with its own radix, into one arbitrary precision integer:
+//   value = d0 + r0 * (d1 + r1 * (d2 + r2 * ...))
+// which takes ceil(log2(r0 * r1 * r2 * ...)) bits: within one bit of the information content of the sequence when
+// every digit is equally likely. A digit with radix 1 costs nothing.
+// The decoder needs the radices in the same order as the encoder, but each radix may depend on the digits decoded
+// before it, which is how game records code each play as an index into the legal plays of the state it follows.
+
+// The largest supported radix.
+constexpr uint64_t kMaxRadix = uint64_t{1} << 32;
+
+class MixedRadixEncoder
+{
+public:
+    // Append a digit, 0 <= digit < radix <= kMaxRadix.
+    void push(uint32_t digit, uint64_t radix);
+
+    // Return the value of all digits pushed so far as a little endian byte string without trailing zero bytes.
+    std::vector<uint8_t> bytes() const;
+
+    // The number of bits needed for the digits pushed so far, i.e. ceil(log2(product of the radices)).
+    unsigned bits() const;
+
+private:
+    struct Digit
+    {
+        uint32_t digit;
+        uint64_t radix;
+    };
+    std::vector<Digit> mDigits;
+};
+
+class MixedRadixDecoder
+{
+public:
+    MixedRadixDecoder(const uint8_t* data, size_t size);
+
+    // Remove and return the next digit, which the encoder pushed with the same radix.
+    uint32_t pop(uint64_t radix);
+
+    // True when all remaining digits are zero, i.e. when there were no more digits than those popped.
+    bool empty() const;
+
+private:
+    std::vector<uint32_t> mLimbs; // little endian
+};
+
+} // namespace pho::math
@@ -3,17 +3,111 @@
 #include "math/Bits.hpp"
 #include "math/math.hpp"
 
+#include <array>
 #include <assert.h>
+#include <cstdint>
+#include <initializer_list>
 #include <string>
 
 namespace pho::math {
 
-uint128_t combinations128(unsigned n, unsigned k);
-// Returns n things taken k at a time.
-// No attempt is made to detect overflow, but 128 bits is big enough for Hearts.
+// Binomial coefficients C(n, k) for 0 <= n, k <= kMaxBinomialN, as Pascal's triangle computed at compile time.
+// Entries with k > n are zero. Every coefficient of a 52-card deck fits in 64 bits (the largest, C(52, 26), is
+// about 2^49); the 128-bit table is for callers that go on to multiply them.
+constexpr unsigned kMaxBinomialN = 52;
+
+template <typename T>
+using BinomialTable = std::array<std::array<T, kMaxBinomialN + 1>, kMaxBinomialN + 1>;
+
+template <typename T>
+constexpr BinomialTable<T> makeBinomialTable()
+{
+    auto table = BinomialTable<T>{};
+    for (unsigned n = 0; n <= kMaxBinomialN; ++n)
+    {
+        table[n][0] = 1;
+        for (unsigned k = 1; k <= n; ++k)
+            table[n][k] = table[n - 1][k - 1] + table[n - 1][k];
+    }
+    return table;
+}
+
+inline constexpr auto kBinomial64 = makeBinomialTable<uint64_t>();
+inline constexpr auto kBinomial128 = makeBinomialTable<uint128_t>();
+
+// Returns n things taken k at a time, or zero when k > n. Requires n <= kMaxBinomialN.
+constexpr uint64_t binomial(unsigned n, unsigned k)
+{
+    assert(n <= kMaxBinomialN);
+    return k > n ? 0 : kBinomial64[n][k];
+}
+
+// Returns n things taken k at a time. Requires k <= n <= kMaxBinomialN.
+constexpr uint128_t combinations128(unsigned n, unsigned k)
+{
+    assert(k <= n);
+    assert(n <= kMaxBinomialN);
+    return kBinomial128[n][k];
+}
+
+// The multinomial coefficient (sum of parts)! / (part_0! part_1! ...): the number of ways to split a set of that
+// many items into subsets of the given sizes, e.g. to deal unknown cards into hands of given capacities.
+// Requires the sum of the parts to be at most kMaxBinomialN.
+template <typename Parts>
+constexpr uint128_t multinomial(const Parts& parts)
+{
+    unsigned total = 0;
+    for (unsigned part : parts)
+        total += part;
+    assert(total <= kMaxBinomialN);
+
+    uint128_t result = 1;
+    for (unsigned part : parts)
+    {
+        result *= kBinomial128[total][part];
+        total -= part;
+    }
+    return result;
+}
+
+constexpr uint128_t multinomial(std::initializer_list<unsigned> parts) { return multinomial<>(parts); }
+
+// The rank of a set of k bits among all sets of k bits in colex order: sum of C(i_j, j) for the bit positions
+// i_1 < i_2 < ... < i_k. Sets with the same highest bit are contiguous, so the rank of a k-subset of the low n bits
+// is less than C(n, k). Requires bits < 2^kMaxBinomialN.
+constexpr uint64_t rankCombination(uint64_t bits)
+{
+    assert(bits >> kMaxBinomialN == 0);
+    uint64_t rank = 0;
+    for (unsigned k = 1; bits != 0; ++k, bits &= bits - 1)
+        rank += kBinomial64[__builtin_ctzll(bits)][k];
+    return rank;
+}
+
+// The inverse of rankCombination(): the k-subset of the low n bits with the given colex rank.
+// Requires rank < C(n, k) and n <= kMaxBinomialN.
+constexpr uint64_t unrankCombination(uint64_t rank, unsigned k, unsigned n = kMaxBinomialN)
+{
+    assert(k <= n && n <= kMaxBinomialN && rank < kBinomial64[n][k]);
+    uint64_t bits = 0;
+    unsigned i = n;
+    for (; k > 0; --k)
+    {
+        // The highest remaining bit is the largest i with C(i, k) <= rank.
+        do
+            --i;
+        while (kBinomial64[i][k] > rank);
+        rank -= kBinomial64[i][k];
+        bits |= uint64_t{1} << i;
+    }
+    return bits;
+}
 
-uint128_t possibleDistinguishableDeals();
 // Returns 52! / 13!^4
+constexpr uint128_t possibleDistinguishableDeals()
+{
+    return multinomial({13, 13, 13, 13});
+}
 
 template <unsigned N>
 constexpr uint64_t constFactorial()
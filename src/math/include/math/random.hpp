@@ -2,8 +2,15 @@
 
 #include "math/math.hpp"
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
 namespace pho::math {
 
+template <size_t kLanes>
+class LaneGenerator;
+
 class RandomGenerator
 {
 public:
@@ -14,6 +21,14 @@ public:
     /// @param seed
     RandomGenerator(uint64_t seed);
 
+    /// @brief Create the PRNG for one of many independent streams sharing a seed, e.g. one per game of a
+    /// simulation, so that each stream is reproducible from (seed, stream) alone.
+    static RandomGenerator forStream(uint64_t seed, uint64_t stream);
+
+    /// @brief Create the PRNG for worker `worker` of a pool sharing `baseSeed`: the generator seeded with baseSeed,
+    /// advanced by `worker` jumps. The workers' streams are disjoint for the first 2^128 draws of each.
+    static RandomGenerator forWorker(uint64_t baseSeed, unsigned worker);
+
     RandomGenerator(const RandomGenerator&) = default;
 
     bool operator==(const RandomGenerator& o) const
@@ -33,6 +48,13 @@ public:
 
     double randNorm() const;
 
+    /// @brief Advance the generator by 2^128 draws, e.g. to split one sequence into 2^128 disjoint streams.
+    void jump();
+
+    /// @brief Advance the generator by 2^192 draws, e.g. to create 2^64 starting points that can each be split
+    /// further with jump().
+    void longJump();
+
 public:
     static const RandomGenerator& ThreadSpecific() { return gRandomGenerator; }
 
@@ -54,6 +76,9 @@ public:
     static constexpr uint128_t kMax128 = ~kZero128;
 
 private:
+    template <size_t kLanes>
+    friend class LaneGenerator;
+
     // The state must be seeded so that it is not everywhere zero.
     static constexpr int kStateWords{4};
     mutable uint64_t s[kStateWords];
@@ -62,8 +87,69 @@ private:
 
     void seedFrom64BitValue(uint64_t seed) const;
 
+    void jumpBy(const uint64_t (&polynomial)[kStateWords]);
+
 private:
     static thread_local RandomGenerator gRandomGenerator;
 };
 
+/// @brief A counter-based generator: Philox4x32-10 (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3").
+///
+/// Every output is a pure function of the 64-bit key and a 128-bit counter, so any game or sample of a parallel
+/// sweep can be regenerated on its own, and workers need no coordination beyond agreeing on the key: giving each
+/// game its own stream (the high 64 bits of the counter) is enough. The interface matches RandomGenerator, with
+/// the same algorithms for the bounded draws.
+class PhiloxGenerator
+{
+public:
+    using Block = std::array<uint32_t, 4>;
+
+    /// @brief The Philox4x32-10 bijection: four 32-bit outputs for the counter under the key.
+    static Block block(uint64_t key, uint128_t counter);
+
+    /// @brief A generator for stream `stream` of `key`, positioned at the first block of the stream.
+    PhiloxGenerator(uint64_t key, uint64_t stream = 0);
+
+    PhiloxGenerator(const PhiloxGenerator&) = default;
+
+    bool operator==(const PhiloxGenerator& o) const
+    {
+        return mKey == o.mKey && mCounter == o.mCounter && mUsed == o.mUsed;
+    }
+
+    bool operator!=(const PhiloxGenerator& o) const { return !this->operator==(o); }
+
+    uint64_t key() const { return mKey; }
+
+    /// @brief The counter of the next block to be generated.
+    uint128_t counter() const { return mCounter; }
+
+    /// @brief Position the generator at the start of the given block.
+    void seek(uint128_t counter) const;
+
+    uint64_t random64() const;
+
+    uint64_t range64(uint64_t range) const;
+
+    uint128_t random128() const;
+
+    uint128_t range128(uint128_t range) const;
+
+    double randNorm() const;
+
+    /// @brief Fill `out` with the next `n` values of random64(). Whole blocks are generated several at a time with
+    /// no dependency between them, which the compiler vectorizes.
+    void fill(uint64_t* out, size_t n) const;
+
+private:
+    static constexpr unsigned kOutputsPerBlock = 2;
+
+    void nextBlock() const;
+
+    uint64_t mKey;
+    mutable uint128_t mCounter;
+    mutable std::array<uint64_t, kOutputsPerBlock> mBuffer;
+    mutable unsigned mUsed; // the number of values of mBuffer already returned
+};
+
 } // namespace pho::math
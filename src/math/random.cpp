@@ -1,5 +1,6 @@
 #include "math/random.hpp"
 #include "prim/dlog.hpp"
+#include "prim/hash.hpp"
 #include "prim/range.hpp"
 
 #include <assert.h>
@@ -52,6 +53,12 @@ RandomGenerator::RandomGenerator() { seedFromRandomDevice(); }
 
 RandomGenerator::RandomGenerator(uint64_t seed) { seedFrom64BitValue(seed); }
 
+RandomGenerator RandomGenerator::forStream(uint64_t seed, uint64_t stream)
+{
+    // Mixing the seed before combining keeps nearby (seed, stream) pairs such as (1, 0) and (0, 1) apart.
+    return RandomGenerator{prim::mix64(SplitMix64{seed}.next() ^ stream)};
+}
+
 void RandomGenerator::seedFrom64BitValue(uint64_t seed) const
 {
     SplitMix64 mix{seed};
@@ -84,46 +91,255 @@ uint64_t RandomGenerator::random64() const
     return result;
 }
 
+void RandomGenerator::jumpBy(const uint64_t (&polynomial)[kStateWords])
+{
+    // http://prng.di.unimi.it/xoshiro256starstar.c
+    uint64_t t[kStateWords] = {0, 0, 0, 0};
+    for (auto word : polynomial)
+    {
+        for (int b = 0; b < 64; b++)
+        {
+            if (word & uint64_t{1} << b)
+            {
+                for (auto i : prim::range(kStateWords))
+                    t[i] ^= s[i];
+            }
+            random64();
+        }
+    }
+    for (auto i : prim::range(kStateWords))
+        s[i] = t[i];
+}
+
+void RandomGenerator::jump()
+{
+    static constexpr uint64_t kJump[kStateWords]
+        = {0x180ec6d33cfd0aba, 0xd5a61266f0c9392c, 0xa9582618e03fc9aa, 0x39abdc4529b1661c};
+    jumpBy(kJump);
+}
+
+void RandomGenerator::longJump()
+{
+    static constexpr uint64_t kLongJump[kStateWords]
+        = {0x76e15d3efefdcbbf, 0xc5004e441c522fb3, 0x77710069854ee241, 0x39109bb02acbe635};
+    jumpBy(kLongJump);
+}
+
+RandomGenerator RandomGenerator::forWorker(uint64_t baseSeed, unsigned worker)
+{
+    auto gen = RandomGenerator{baseSeed};
+    for (unsigned i = 0; i < worker; ++i)
+        gen.jump();
+    return gen;
+}
+
 uint128_t RandomGenerator::random128() const
 {
     uint128_t result = random64();
     return (result << 64) + random64();
 }
 
-uint64_t RandomGenerator::range64(uint64_t range) const
+namespace {
+// The bounded draws are shared by all generators with random64() and random128(), so that they produce the same
+// distributions from their raw streams.
+//
+// They use Lemire's multiply-shift with rejection ("Fast Random Integer Generation in an Interval", 2019):
+// r * range is split into a high part, the result, and a low part, which is uniform over [0, 2^w). Rejecting
+// low parts below 2^w mod range makes every result equally likely. The modulus is only computed when the low part
+// is below range, which is rare unless range is close to 2^w, so a draw normally needs no division at all.
+// This replaced a division-based method in which each result came from the high bits of r / (2^w / range), so
+// the streams of bounded values differ from those of earlier versions for the same seed.
+
+template <typename Generator>
+uint64_t boundedRandom64(const Generator& gen, uint64_t range)
 {
-    const uint64_t buckets = kMax64 / range;
-    const uint64_t limit = buckets * range;
-    uint64_t r = random64();
-    while (r >= limit)
-        r = random64();
-    return r / buckets;
+    assert(range > 0);
+    uint128_t m = uint128_t{gen.random64()} * range;
+    uint64_t low = uint64_t(m);
+    if (low < range)
+    {
+        const uint64_t threshold = -range % range;
+        while (low < threshold)
+        {
+            m = uint128_t{gen.random64()} * range;
+            low = uint64_t(m);
+        }
+    }
+    return uint64_t(m >> 64);
 }
 
-uint128_t RandomGenerator::range128(uint128_t range) const
+struct Product256
+{
+    uint128_t high;
+    uint128_t low;
+};
+
+inline Product256 multiply128(uint128_t a, uint128_t b)
 {
-    const uint128_t buckets = kMax128 / range;
-    const uint128_t limit = buckets * range;
-    uint128_t r = random128();
-    while (r >= limit)
-        r = random128();
-    return r / buckets;
+    const auto a0 = uint64_t(a), a1 = uint64_t(a >> 64);
+    const auto b0 = uint64_t(b), b1 = uint64_t(b >> 64);
+    const auto p00 = uint128_t{a0} * b0;
+    const auto p01 = uint128_t{a0} * b1;
+    const auto p10 = uint128_t{a1} * b0;
+    const auto p11 = uint128_t{a1} * b1;
+    const auto middle = (p00 >> 64) + uint64_t(p01) + uint64_t(p10);
+    return Product256{
+        .high = p11 + (p01 >> 64) + (p10 >> 64) + (middle >> 64),
+        .low = (middle << 64) | uint64_t(p00),
+    };
 }
 
-double RandomGenerator::randNorm() const
+template <typename Generator>
+uint128_t boundedRandom128(const Generator& gen, uint128_t range)
+{
+    assert(range > 0);
+    auto m = multiply128(gen.random128(), range);
+    if (m.low < range)
+    {
+        const uint128_t threshold = -range % range;
+        while (m.low < threshold)
+            m = multiply128(gen.random128(), range);
+    }
+    return m.high;
+}
+
+template <typename Generator>
+double unitRandom(const Generator& gen)
 {
     constexpr uint64_t kMaxMantissa{0x0010'0000'0000'0000ull};
     constexpr uint64_t kExponent{0x3ff0'0000'0000'0000ull};
-    auto n = range64(kMaxMantissa) | kExponent;
+    auto n = gen.range64(kMaxMantissa) | kExponent;
 #pragma GCC diagnostic ignored "-Wstrict-aliasing"
     double d = *reinterpret_cast<double*>(&n);
     assert(d >= 1.0);
     assert(d < 2.0);
     return d - 1.0;
 }
+} // namespace
+
+uint64_t RandomGenerator::range64(uint64_t range) const { return boundedRandom64(*this, range); }
+
+uint128_t RandomGenerator::range128(uint128_t range) const { return boundedRandom128(*this, range); }
+
+double RandomGenerator::randNorm() const { return unitRandom(*this); }
 
 thread_local RandomGenerator RandomGenerator::gRandomGenerator;
 
+namespace {
+// https://github.com/DEShawResearch/random123 philox.h
+constexpr uint32_t kPhiloxM0 = 0xD2511F53;
+constexpr uint32_t kPhiloxM1 = 0xCD9E8D57;
+constexpr uint32_t kPhiloxW0 = 0x9E3779B9;
+constexpr uint32_t kPhiloxW1 = 0xBB67AE85;
+constexpr unsigned kPhiloxRounds = 10;
+
+// Philox4x32-10 of the kLanes counters starting at `counter`, written as two 64-bit values per block.
+// The lanes are independent and the rounds are unrolled, so the compiler vectorizes the loop over the lanes.
+template <size_t kLanes>
+inline void philoxLanes(uint64_t key, uint128_t counter, uint64_t* out)
+{
+    uint32_t c0[kLanes], c1[kLanes], c2[kLanes], c3[kLanes];
+    for (size_t i = 0; i < kLanes; ++i)
+    {
+        const auto c = counter + i;
+        c0[i] = uint32_t(c);
+        c1[i] = uint32_t(c >> 32);
+        c2[i] = uint32_t(c >> 64);
+        c3[i] = uint32_t(c >> 96);
+    }
+
+    for (size_t i = 0; i < kLanes; ++i)
+    {
+        auto k0 = uint32_t(key);
+        auto k1 = uint32_t(key >> 32);
+        auto x0 = c0[i], x1 = c1[i], x2 = c2[i], x3 = c3[i];
+#pragma GCC unroll 10
+        for (unsigned round = 0; round < kPhiloxRounds; ++round)
+        {
+            const auto p0 = uint64_t{kPhiloxM0} * x0;
+            const auto p1 = uint64_t{kPhiloxM1} * x2;
+            x0 = uint32_t(p1 >> 32) ^ x1 ^ k0;
+            x2 = uint32_t(p0 >> 32) ^ x3 ^ k1;
+            x1 = uint32_t(p1);
+            x3 = uint32_t(p0);
+            k0 += kPhiloxW0;
+            k1 += kPhiloxW1;
+        }
+        out[2 * i] = (uint64_t(x1) << 32) | x0;
+        out[2 * i + 1] = (uint64_t(x3) << 32) | x2;
+    }
+}
+
+constexpr size_t kPhiloxBulkLanes = 16;
+} // namespace
+
+PhiloxGenerator::Block PhiloxGenerator::block(uint64_t key, uint128_t counter)
+{
+    uint64_t out[kOutputsPerBlock];
+    philoxLanes<1>(key, counter, out);
+    return Block{uint32_t(out[0]), uint32_t(out[0] >> 32), uint32_t(out[1]), uint32_t(out[1] >> 32)};
+}
+
+PhiloxGenerator::PhiloxGenerator(uint64_t key, uint64_t stream)
+: mKey{key}
+, mCounter{uint128_t{stream} << 64}
+, mBuffer{}
+, mUsed{kOutputsPerBlock}
+{ }
+
+void PhiloxGenerator::seek(uint128_t counter) const
+{
+    mCounter = counter;
+    mUsed = kOutputsPerBlock;
+}
+
+void PhiloxGenerator::nextBlock() const
+{
+    philoxLanes<1>(mKey, mCounter, mBuffer.data());
+    ++mCounter;
+    mUsed = 0;
+}
+
+uint64_t PhiloxGenerator::random64() const
+{
+    if (mUsed == kOutputsPerBlock)
+        nextBlock();
+    return mBuffer[mUsed++];
+}
+
+uint128_t PhiloxGenerator::random128() const
+{
+    uint128_t result = random64();
+    return (result << 64) + random64();
+}
+
+uint64_t PhiloxGenerator::range64(uint64_t range) const { return boundedRandom64(*this, range); }
+
+uint128_t PhiloxGenerator::range128(uint128_t range) const { return boundedRandom128(*this, range); }
+
+double PhiloxGenerator::randNorm() const { return unitRandom(*this); }
+
+void PhiloxGenerator::fill(uint64_t* out, size_t n) const
+{
+    // First what is left of the current block, then whole blocks, then the start of one more block.
+    for (; n > 0 && mUsed < kOutputsPerBlock; --n)
+        *out++ = mBuffer[mUsed++];
+
+    constexpr auto kBulk = kPhiloxBulkLanes * kOutputsPerBlock;
+    for (; n >= kBulk; n -= kBulk, out += kBulk)
+    {
+        philoxLanes<kPhiloxBulkLanes>(mKey, mCounter, out);
+        mCounter += kPhiloxBulkLanes;
+    }
+    for (; n >= kOutputsPerBlock; n -= kOutputsPerBlock, out += kOutputsPerBlock)
+    {
+        philoxLanes<1>(mKey, mCounter, out);
+        ++mCounter;
+    }
+    for (; n > 0; --n)
+        *out++ = random64();
+}
+
 #if __EMSCRIPTEN__
 using namespace emscripten;
 EMSCRIPTEN_BINDINGS(cards)
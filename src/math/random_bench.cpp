@@ -0,0 +1,121 @@
+// random_bench: measure draws per second of the random generators.
+//
+// Usage: random_bench [--draws=N]
+//
+// Each row times one kind of draw for RandomGenerator (xoshiro256**) and PhiloxGenerator. The division rows are
+// the bounded draw method used before Lemire's multiply-shift, for comparison.
+
+#include "math/LaneGenerator.hpp"
+#include "math/combinatorics.hpp"
+#include "math/random.hpp"
+
+#include <chrono>
+#include <fmt/format.h>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace pho::math;
+
+namespace {
+
+// The previous bounded draws, which divide on every call.
+template <typename Generator>
+uint64_t divisionRange64(const Generator& gen, uint64_t range)
+{
+    const uint64_t buckets = RandomGenerator::kMax64 / range;
+    const uint64_t limit = buckets * range;
+    uint64_t r = gen.random64();
+    while (r >= limit)
+        r = gen.random64();
+    return r / buckets;
+}
+
+template <typename Generator>
+uint128_t divisionRange128(const Generator& gen, uint128_t range)
+{
+    const uint128_t buckets = RandomGenerator::kMax128 / range;
+    const uint128_t limit = buckets * range;
+    uint128_t r = gen.random128();
+    while (r >= limit)
+        r = gen.random128();
+    return r / buckets;
+}
+
+// Time `draws` calls of draw(), returning draws per second. The xor of all results is printed so that the
+// compiler cannot discard the draws.
+template <typename Draw>
+auto timeDraws(const std::string& name, uint64_t draws, Draw draw) -> void
+{
+    auto sink = uint128_t{};
+    const auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < draws; ++i)
+        sink ^= draw();
+    const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    fmt::print("{:<36} {:>10.1f} M draws/sec  (checksum {:x})\n", name, draws / seconds / 1e6, uint64_t(sink));
+}
+
+// Like timeDraws(), for a bulk fill of buffers of 4096 values.
+template <typename Fill>
+auto timeFills(const std::string& name, uint64_t draws, Fill fill) -> void
+{
+    auto buffer = std::vector<uint64_t>(4096);
+    auto sink = uint64_t{};
+    const auto start = std::chrono::steady_clock::now();
+    for (uint64_t done = 0; done < draws; done += buffer.size())
+    {
+        fill(buffer.data(), buffer.size());
+        sink ^= buffer[done % buffer.size()];
+    }
+    const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    fmt::print("{:<36} {:>10.1f} M draws/sec  (checksum {:x})\n", name, draws / seconds / 1e6, sink);
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        auto draws = uint64_t{20'000'000};
+        for (int i = 1; i < argc; ++i)
+        {
+            const auto arg = std::string{argv[i]};
+            if (arg.starts_with("--draws="))
+                draws = std::stoull(arg.substr(8));
+            else
+                throw std::invalid_argument(fmt::format("Unrecognized argument: {}", arg));
+        }
+
+        // The ranges are read through volatiles, as ranges normally vary between calls. A constant range would let
+        // the compiler hoist the divisions of the division method out of the timing loop.
+        volatile uint64_t cards = 52;
+        volatile uint128_t deals = possibleDistinguishableDeals();
+        const auto xoshiro = RandomGenerator{1};
+        const auto philox = PhiloxGenerator{1};
+
+        timeDraws("xoshiro random64", draws, [&] { return xoshiro.random64(); });
+        timeDraws("xoshiro range64(52)", draws, [&] { return xoshiro.range64(cards); });
+        timeDraws("xoshiro range64(52) division", draws, [&] { return divisionRange64(xoshiro, cards); });
+        timeDraws("xoshiro range128(deals)", draws, [&] { return xoshiro.range128(deals); });
+        timeDraws("xoshiro range128(deals) division", draws, [&] { return divisionRange128(xoshiro, deals); });
+        timeDraws("xoshiro randNorm", draws, [&] { return uint64_t(xoshiro.randNorm() * 1e9); });
+
+        timeDraws("philox random64", draws, [&] { return philox.random64(); });
+        timeDraws("philox range64(52)", draws, [&] { return philox.range64(cards); });
+        timeDraws("philox range128(deals)", draws, [&] { return philox.range128(deals); });
+
+        const auto lanes = SimdRandomGenerator{1};
+        timeFills("philox fill", draws, [&](uint64_t* out, size_t n) { philox.fill(out, n); });
+        timeFills(fmt::format("{}-lane xoshiro fill", kSimdLanes), draws,
+            [&](uint64_t* out, size_t n) { lanes.fill(out, n); });
+        timeFills(fmt::format("{}-lane xoshiro fillRange(52)", kSimdLanes), draws,
+            [&](uint64_t* out, size_t n) { lanes.fillRange(out, n, cards); });
+    }
+    catch (const std::exception& e)
+    {
+        fmt::print(stderr, "random_bench: {}\n", e.what());
+        return 1;
+    }
+    return 0;
+}
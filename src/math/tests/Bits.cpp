@@ -105,4 +105,28 @@ TEST(roundUpToPowerOfTwo, RoundUp2)
     }
 }
 
+TEST(depositBits, examples)
+{
+    EXPECT_EQ(depositBits(0b101, 0b11100), 0b10100u);
+    EXPECT_EQ(depositBits(~kZero, 0b1010), 0b1010u);
+    EXPECT_EQ(depositBits(0b11, 0), 0u);
+    EXPECT_EQ(extractBits(0b10100, 0b11100), 0b101u);
+    EXPECT_EQ(extractBits(~kZero, kOne << 63), 1u);
+    EXPECT_EQ(extractBits(0b1111, 0), 0u);
+}
+
+TEST(depositBits, inverse_of_extract)
+{
+    auto x = uint64_t{0x9e3779b97f4a7c15};
+    for (int i = 0; i < 1000; ++i)
+    {
+        x = x * 6364136223846793005u + 1442695040888963407u;
+        const uint64_t mask = x ^ (x >> 29);
+        const uint64_t bits = x * 0xbf58476d1ce4e5b9u;
+        const uint64_t low = countBits(mask) == 64 ? ~kZero : (kOne << countBits(mask)) - 1;
+        EXPECT_EQ(depositBits(extractBits(bits, mask), mask), bits & mask);
+        EXPECT_EQ(extractBits(depositBits(bits, mask), mask), bits & low);
+    }
+}
+
 } // namespace pho::math::tests
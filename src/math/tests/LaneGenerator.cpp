@@ -0,0 +1,75 @@
+#include "math/LaneGenerator.hpp"
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <vector>
+
+namespace pho::math::tests {
+
+template <size_t kLanes>
+auto expectLanesAreJumpedStreams()
+{
+    constexpr uint64_t kSeed = 2024;
+    const auto lanes = LaneGenerator<kLanes>{kSeed};
+
+    // Fill in awkward pieces to cross step boundaries in every way.
+    constexpr size_t kSteps = 50;
+    auto values = std::vector<uint64_t>(kSteps * kLanes);
+    size_t done = 0;
+    for (size_t piece = 1; done < values.size(); ++piece)
+    {
+        const auto n = std::min(piece % (2 * kLanes + 1), values.size() - done);
+        lanes.fill(values.data() + done, n);
+        done += n;
+    }
+
+    for (size_t j = 0; j < kLanes; ++j)
+    {
+        const auto expected = RandomGenerator::forWorker(kSeed, unsigned(j));
+        for (size_t k = 0; k < kSteps; ++k)
+            ASSERT_EQ(values[k * kLanes + j], expected.random64()) << "lane " << j << " step " << k;
+    }
+}
+
+TEST(LaneGenerator, lanes_are_jumped_streams)
+{
+    expectLanesAreJumpedStreams<1>();
+    expectLanesAreJumpedStreams<2>();
+    expectLanesAreJumpedStreams<4>();
+    expectLanesAreJumpedStreams<8>();
+    expectLanesAreJumpedStreams<kSimdLanes>();
+}
+
+TEST(LaneGenerator, fill_range)
+{
+    const auto lanes = SimdRandomGenerator{7};
+    for (uint64_t range : {1u, 2u, 13u, 52u})
+    {
+        constexpr size_t kPerValue = 20'000;
+        auto values = std::vector<uint64_t>(range * kPerValue);
+        lanes.fillRange(values.data(), values.size(), range);
+
+        auto counts = std::vector<size_t>(range);
+        for (auto v : values)
+        {
+            ASSERT_LT(v, range);
+            ++counts[v];
+        }
+        for (auto count : counts)
+            EXPECT_NEAR(double(count), double(kPerValue), 5 * std::sqrt(double(kPerValue)));
+    }
+
+    // A range just above 2^63 rejects nearly half of the raw values.
+    const uint64_t half = (uint64_t{1} << 63) + 1;
+    auto values = std::vector<uint64_t>(10'000);
+    lanes.fillRange(values.data(), values.size(), half);
+    auto upper = 0;
+    for (auto v : values)
+    {
+        ASSERT_LT(v, half);
+        upper += v >= half / 2;
+    }
+    EXPECT_NEAR(upper / double(values.size()), 0.5, 0.03);
+}
+
+} // namespace pho::math::tests
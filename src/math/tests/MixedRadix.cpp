@@ -0,0 +1,68 @@
+#include "math/MixedRadix.hpp"
+#include "math/random.hpp"
+#include "gtest/gtest.h"
+
+namespace pho::math::tests {
+
+TEST(MixedRadix, empty)
+{
+    auto encoder = MixedRadixEncoder{};
+    EXPECT_TRUE(encoder.bytes().empty());
+    EXPECT_EQ(encoder.bits(), 0u);
+
+    auto decoder = MixedRadixDecoder{nullptr, 0};
+    EXPECT_TRUE(decoder.empty());
+    EXPECT_EQ(decoder.pop(7), 0u);
+}
+
+TEST(MixedRadix, small)
+{
+    // 1 + 3 * (2 + 5 * 4) = 67
+    auto encoder = MixedRadixEncoder{};
+    encoder.push(1, 3);
+    encoder.push(0, 1);
+    encoder.push(2, 5);
+    encoder.push(4, 7);
+    EXPECT_EQ(encoder.bytes(), std::vector<uint8_t>{67});
+    EXPECT_EQ(encoder.bits(), 7u); // log2(105)
+
+    const auto bytes = encoder.bytes();
+    auto decoder = MixedRadixDecoder{bytes.data(), bytes.size()};
+    EXPECT_EQ(decoder.pop(3), 1u);
+    EXPECT_EQ(decoder.pop(1), 0u);
+    EXPECT_EQ(decoder.pop(5), 2u);
+    EXPECT_FALSE(decoder.empty());
+    EXPECT_EQ(decoder.pop(7), 4u);
+    EXPECT_TRUE(decoder.empty());
+}
+
+TEST(MixedRadix, round_trip)
+{
+    const auto rng = RandomGenerator{17};
+    for (int trial = 0; trial < 200; ++trial)
+    {
+        const auto count = rng.range64(100);
+        auto radices = std::vector<uint64_t>{};
+        auto digits = std::vector<uint32_t>{};
+        auto encoder = MixedRadixEncoder{};
+        for (uint64_t i = 0; i < count; ++i)
+        {
+            // Mostly small radices, like legal play counts, and some as large as possible.
+            const auto radix = rng.range64(4) == 0 ? kMaxRadix - rng.range64(3) : 1 + rng.range64(14);
+            const auto digit = uint32_t(rng.range64(radix));
+            radices.push_back(radix);
+            digits.push_back(digit);
+            encoder.push(digit, radix);
+        }
+
+        const auto bytes = encoder.bytes();
+        EXPECT_LE(bytes.size() * 8, encoder.bits() + 7);
+
+        auto decoder = MixedRadixDecoder{bytes.data(), bytes.size()};
+        for (uint64_t i = 0; i < count; ++i)
+            ASSERT_EQ(decoder.pop(radices[i]), digits[i]);
+        EXPECT_TRUE(decoder.empty());
+    }
+}
+
+} // namespace pho::math::tests
@@ -61,6 +61,74 @@ TEST(combinations128, possibleDistinguishableDealsHighBit)
     EXPECT_EQ(topBit, 95);
 }
 
+TEST(binomial, table_matches_multiplicative_formula)
+{
+    for (unsigned n = 0; n <= kMaxBinomialN; ++n)
+    {
+        // C(n, k) = C(n, k - 1) * (n - k + 1) / k, which is exact at every step.
+        uint128_t expected = 1;
+        for (unsigned k = 0; k <= n; ++k)
+        {
+            if (k > 0)
+                expected = expected * (n - k + 1) / k;
+            ASSERT_EQ(kBinomial128[n][k], expected) << n << " " << k;
+            ASSERT_EQ(uint128_t{binomial(n, k)}, expected);
+            ASSERT_EQ(binomial(n, k), binomial(n, n - k));
+        }
+        for (unsigned k = n + 1; k <= kMaxBinomialN; ++k)
+            ASSERT_EQ(binomial(n, k), 0u);
+    }
+    static_assert(binomial(52, 26) == 495918532948104ull);
+}
+
+TEST(multinomial, splits)
+{
+    EXPECT_EQ(multinomial({}), 1u);
+    EXPECT_EQ(multinomial({5}), 1u);
+    EXPECT_EQ(multinomial({2, 2, 1, 1}), 180u);
+    EXPECT_EQ(multinomial({0, 3, 0, 0}), 1u);
+    EXPECT_EQ(multinomial({13, 13, 13, 0}), combinations128(39, 13) * combinations128(26, 13));
+    EXPECT_EQ(multinomial(std::array<unsigned, 4>{13, 13, 13, 13}), possibleDistinguishableDeals());
+    static_assert(multinomial({13, 13, 13, 13}) == (uint128_t{0xad55e315634dda65} << 32 | 0x8bf49200));
+}
+
+TEST(rankCombination, colex_order_is_dense)
+{
+    // Every 3-subset of 8 bits, enumerated in colex order, has consecutive ranks.
+    auto expected = uint64_t{};
+    for (unsigned c = 2; c < 8; ++c)
+    {
+        for (unsigned b = 1; b < c; ++b)
+        {
+            for (unsigned a = 0; a < b; ++a)
+            {
+                const uint64_t bits = 1u << a | 1u << b | 1u << c;
+                EXPECT_EQ(rankCombination(bits), expected);
+                EXPECT_EQ(unrankCombination(expected, 3, 8), bits);
+                EXPECT_EQ(unrankCombination(expected, 3), bits);
+                ++expected;
+            }
+        }
+    }
+    EXPECT_EQ(expected, binomial(8, 3));
+    EXPECT_EQ(rankCombination(0), 0u);
+    EXPECT_EQ(unrankCombination(0, 0), 0u);
+}
+
+TEST(rankCombination, round_trip_large)
+{
+    for (unsigned k : {1u, 13u, 26u, 39u, 52u})
+    {
+        const auto count = binomial(kMaxBinomialN, k);
+        for (uint64_t rank : {uint64_t{0}, count / 3, count / 2, count - 1})
+        {
+            const auto bits = unrankCombination(rank, k);
+            EXPECT_EQ(countBits(bits), k);
+            EXPECT_EQ(rankCombination(bits), rank);
+        }
+    }
+}
+
 TEST(asHexString, fill)
 {
     uint128_t N = possibleDistinguishableDeals();
@@ -3,6 +3,8 @@
 #include "gtest/gtest.h"
 
 #include <algorithm>
+#include <cmath>
+#include <vector>
 
 namespace pho::math::tests {
 
@@ -99,4 +101,186 @@ TEST(random, normal_deviates)
     EXPECT_GT(max, 0.9999);
 }
 
+TEST(random, bounded_draws_at_extreme_ranges)
+{
+    RandomGenerator gen{8};
+    for (int i = 0; i < 1000; i++)
+    {
+        EXPECT_EQ(gen.range64(1), 0u);
+        EXPECT_EQ(gen.range128(1), 0u);
+        EXPECT_LT(gen.range64(RandomGenerator::kMax64), RandomGenerator::kMax64);
+        EXPECT_LT(gen.range128(RandomGenerator::kMax128), RandomGenerator::kMax128);
+    }
+
+    // With range just above half of 2^w nearly half of all raw values are rejected. The accepted ones must still
+    // cover both halves of the range equally.
+    const uint64_t half64 = (uint64_t{1} << 63) + 1;
+    const uint128_t half128 = (uint128_t{1} << 127) + 1;
+    auto upper64 = 0;
+    auto upper128 = 0;
+    const int kIterations = 100'000;
+    for (int i = 0; i < kIterations; i++)
+    {
+        const auto r64 = gen.range64(half64);
+        const auto r128 = gen.range128(half128);
+        ASSERT_LT(r64, half64);
+        ASSERT_LT(r128, half128);
+        upper64 += r64 >= half64 / 2;
+        upper128 += r128 >= half128 / 2;
+    }
+    EXPECT_NEAR(double(upper64) / kIterations, 0.5, 0.01);
+    EXPECT_NEAR(double(upper128) / kIterations, 0.5, 0.01);
+}
+
+TEST(random, small_ranges_are_unbiased)
+{
+    RandomGenerator gen{9};
+    for (uint64_t range : {2u, 3u, 7u, 13u, 52u})
+    {
+        auto counts64 = std::vector<int>(range);
+        auto counts128 = std::vector<int>(range);
+        const int kPerValue = 20'000;
+        for (uint64_t i = 0; i < range * kPerValue; i++)
+        {
+            ++counts64.at(gen.range64(range));
+            ++counts128.at(size_t(gen.range128(range)));
+        }
+        for (uint64_t v = 0; v < range; ++v)
+        {
+            EXPECT_NEAR(counts64[v], kPerValue, 5 * std::sqrt(kPerValue));
+            EXPECT_NEAR(counts128[v], kPerValue, 5 * std::sqrt(kPerValue));
+        }
+    }
+}
+
+TEST(random, jumps_commute_with_draws)
+{
+    // A jump is multiplication by a fixed polynomial of the xoshiro transition, so it commutes with a draw.
+    for (auto longJump : {false, true})
+    {
+        auto a = RandomGenerator{31};
+        auto b = RandomGenerator{31};
+        for (int i = 0; i < 5; ++i)
+            (void)a.random64();
+        longJump ? a.longJump() : a.jump();
+        longJump ? b.longJump() : b.jump();
+        for (int i = 0; i < 5; ++i)
+            (void)b.random64();
+        EXPECT_EQ(a, b);
+        EXPECT_EQ(a.random64(), b.random64());
+    }
+
+    auto jumped = RandomGenerator{31};
+    auto longJumped = RandomGenerator{31};
+    jumped.jump();
+    longJumped.longJump();
+    EXPECT_NE(jumped, RandomGenerator{31});
+    EXPECT_NE(jumped, longJumped);
+}
+
+TEST(random, for_worker)
+{
+    auto expected = RandomGenerator{1234};
+    auto firsts = std::vector<uint64_t>{};
+    for (unsigned worker = 0; worker < 8; ++worker)
+    {
+        const auto gen = RandomGenerator::forWorker(1234, worker);
+        EXPECT_EQ(gen, expected);
+        firsts.push_back(gen.random64());
+        expected.jump();
+    }
+    std::sort(firsts.begin(), firsts.end());
+    EXPECT_EQ(std::unique(firsts.begin(), firsts.end()), firsts.end());
+}
+
+TEST(philox, known_answers)
+{
+    // The philox4x32-10 known-answer vectors of the Random123 distribution (kat_vectors). Random123 lists the
+    // counter and key words in order, so word 0 is the low word of our counter and key.
+    using Block = PhiloxGenerator::Block;
+    auto counterOf = [](uint32_t c0, uint32_t c1, uint32_t c2, uint32_t c3) {
+        return (uint128_t(c3) << 96) | (uint128_t(c2) << 64) | (uint128_t(c1) << 32) | c0;
+    };
+    auto keyOf = [](uint32_t k0, uint32_t k1) { return (uint64_t(k1) << 32) | k0; };
+
+    EXPECT_EQ(PhiloxGenerator::block(0, 0), (Block{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}));
+    EXPECT_EQ(PhiloxGenerator::block(keyOf(0xffffffff, 0xffffffff), RandomGenerator::kMax128),
+        (Block{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}));
+    EXPECT_EQ(PhiloxGenerator::block(
+                  keyOf(0xa4093822, 0x299f31d0), counterOf(0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344)),
+        (Block{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}));
+}
+
+TEST(philox, pure_function_of_key_and_counter)
+{
+    constexpr uint64_t kKey = 0x0123456789abcdefull;
+    constexpr uint64_t kStream = 77;
+    const auto gen = PhiloxGenerator{kKey, kStream};
+    EXPECT_EQ(gen.counter(), uint128_t{kStream} << 64);
+
+    for (uint64_t i = 0; i < 10; ++i)
+    {
+        const auto block = PhiloxGenerator::block(kKey, (uint128_t{kStream} << 64) + i);
+        EXPECT_EQ(gen.random64(), (uint64_t(block[1]) << 32) | block[0]);
+        EXPECT_EQ(gen.random64(), (uint64_t(block[3]) << 32) | block[2]);
+    }
+
+    // Seeking anywhere regenerates the same values.
+    const auto other = PhiloxGenerator{kKey};
+    other.seek((uint128_t{kStream} << 64) + 3);
+    const auto block = PhiloxGenerator::block(kKey, (uint128_t{kStream} << 64) + 3);
+    EXPECT_EQ(other.random64(), (uint64_t(block[1]) << 32) | block[0]);
+
+    // Neighbouring streams and keys differ.
+    EXPECT_NE(PhiloxGenerator(kKey, kStream).random64(), PhiloxGenerator(kKey, kStream + 1).random64());
+    EXPECT_NE(PhiloxGenerator(kKey, kStream).random64(), PhiloxGenerator(kKey + 1, kStream).random64());
+}
+
+TEST(philox, bulk_fill_matches_single_draws)
+{
+    for (size_t n : {0u, 1u, 2u, 3u, 15u, 16u, 17u, 100u, 1001u})
+    {
+        for (unsigned skip : {0u, 1u})
+        {
+            const auto single = PhiloxGenerator{99, n};
+            const auto bulk = PhiloxGenerator{99, n};
+            for (unsigned i = 0; i < skip; ++i)
+                EXPECT_EQ(single.random64(), bulk.random64());
+
+            auto values = std::vector<uint64_t>(n);
+            bulk.fill(values.data(), n);
+            for (auto v : values)
+                ASSERT_EQ(v, single.random64());
+            EXPECT_EQ(bulk.random64(), single.random64());
+            EXPECT_EQ(bulk, single);
+        }
+    }
+}
+
+TEST(philox, bounded_draws)
+{
+    const auto gen = PhiloxGenerator{5};
+
+    const unsigned kBins = 8;
+    unsigned bins[kBins] = {0, 0, 0, 0, 0, 0, 0, 0};
+    const uint128_t D = possibleDistinguishableDeals();
+    const uint128_t B = D / kBins;
+    const int kIterations = 200'000;
+    for (int i = 0; i < kIterations; i++)
+    {
+        uint128_t r = gen.range128(D);
+        ASSERT_LT(r, D);
+        ++bins[unsigned(r / B)];
+        ASSERT_LT(gen.range64(13), 13u);
+        const double d = gen.randNorm();
+        ASSERT_GE(d, 0.0);
+        ASSERT_LT(d, 1.0);
+    }
+
+    std::sort(bins, bins + kBins);
+    const double kScale = double(kBins) / double(kIterations);
+    EXPECT_GT(double(bins[0]) * kScale, 0.95);
+    EXPECT_LT(double(bins[kBins - 1]) * kScale, 1.05);
+}
+
 } // namespace pho::math::tests
@@ -0,0 +1,95 @@
+#include "prim/MappedFile.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+namespace pho::prim {
+
+MappedFile::MappedFile(const std::string& path, Access access)
+: mPath{path}
+, mBase{nullptr}
+, mSize{0}
+{
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error(fmt::format("Cannot open {}", path));
+
+    struct stat status = {};
+    if (::fstat(fd, &status) != 0)
+    {
+        ::close(fd);
+        throw std::runtime_error(fmt::format("Cannot stat {}", path));
+    }
+    mSize = size_t(status.st_size);
+    if (mSize > 0)
+        mBase = ::mmap(nullptr, mSize, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mBase == MAP_FAILED)
+        throw std::runtime_error(fmt::format("Cannot map {}", path));
+
+    if (mBase != nullptr && access != eNormal)
+        ::madvise(mBase, mSize, access == eRandom ? MADV_RANDOM : MADV_SEQUENTIAL);
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+: mPath{std::move(other.mPath)}
+, mBase{std::exchange(other.mBase, nullptr)}
+, mSize{std::exchange(other.mSize, 0)}
+{ }
+
+MappedFile::~MappedFile()
+{
+    if (mBase != nullptr)
+        ::munmap(mBase, mSize);
+}
+
+void MappedFile::expectSize(uint64_t expected) const
+{
+    if (mSize != expected)
+        throw std::runtime_error(fmt::format("{} should have {} bytes, not {}", mPath, expected, mSize));
+}
+
+AtomicFileWriter::AtomicFileWriter(const std::string& path)
+: mPath{path}
+, mTemporary{path + ".tmp"}
+, mFile{std::fopen(mTemporary.c_str(), "wb")}
+{
+    if (mFile == nullptr)
+        throw std::runtime_error(fmt::format("Cannot create {}", mTemporary));
+}
+
+AtomicFileWriter::~AtomicFileWriter()
+{
+    if (mFile != nullptr)
+    {
+        std::fclose(mFile);
+        std::remove(mTemporary.c_str());
+    }
+}
+
+void AtomicFileWriter::write(const void* data, size_t size)
+{
+    if (size > 0 && std::fwrite(data, size, 1, mFile) != 1)
+        throw std::runtime_error(fmt::format("Write to {} failed", mTemporary));
+}
+
+void AtomicFileWriter::commit()
+{
+    const auto flushed = std::fflush(mFile) == 0;
+    const auto closed = std::fclose(std::exchange(mFile, nullptr)) == 0;
+    if (!flushed || !closed)
+    {
+        std::remove(mTemporary.c_str());
+        throw std::runtime_error(fmt::format("Write to {} failed", mTemporary));
+    }
+    if (std::rename(mTemporary.c_str(), mPath.c_str()) != 0)
+    {
+        std::remove(mTemporary.c_str());
+        throw std::runtime_error(fmt::format("Cannot rename {} to {}", mTemporary, mPath));
+    }
+}
+
+} // namespace pho::prim
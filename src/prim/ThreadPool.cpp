@@ -0,0 +1,201 @@
+#include "prim/ThreadPool.hpp"
+
+#include <cassert>
+#include <utility>
+
+namespace pho::prim {
+
+namespace {
+// The pool and index of the calling worker thread.
+struct WorkerIdentity
+{
+    const ThreadPool* pool;
+    unsigned index;
+};
+
+thread_local WorkerIdentity tWorker{nullptr, ThreadPool::kNotAWorker};
+
+// A worker steals from this many victims before it considers parking.
+constexpr unsigned kStealRounds = 4;
+} // namespace
+
+ThreadPool::ThreadPool(unsigned workers)
+{
+    if (workers == 0)
+        workers = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned i = 0; i < workers; ++i)
+        mWorkers.push_back(std::make_unique<Worker>());
+    for (unsigned i = 0; i < workers; ++i)
+        mThreads.emplace_back([this, i] { workerLoop(i); });
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard lock{mParkMutex};
+        mStop.store(true);
+    }
+    mParked.notify_all();
+    for (auto& thread : mThreads)
+        thread.join();
+    assert(mShared.empty());
+}
+
+unsigned ThreadPool::currentWorker() const { return tWorker.pool == this ? tWorker.index : kNotAWorker; }
+
+void ThreadPool::spawn(Task* task)
+{
+    const auto worker = currentWorker();
+    if (worker != kNotAWorker)
+        mWorkers[worker]->deque.push(task);
+    else
+    {
+        std::lock_guard lock{mSharedMutex};
+        mShared.push_back(task);
+    }
+    wake();
+}
+
+void ThreadPool::wake()
+{
+    // Paired with the check of mSpawned in workerLoop(): either the parking worker sees this spawn, or this sees the
+    // worker counted in mSleeping and notifies it.
+    mSpawned.fetch_add(1, std::memory_order_seq_cst);
+    if (mSleeping.load(std::memory_order_seq_cst) == 0)
+        return;
+    {
+        std::lock_guard lock{mParkMutex};
+    }
+    mParked.notify_one();
+}
+
+void ThreadPool::execute(Task* task)
+{
+    auto error = std::exception_ptr{};
+    try
+    {
+        task->run();
+    }
+    catch (...)
+    {
+        error = std::current_exception();
+    }
+    auto* group = task->group;
+    delete task;
+    group->finish(error);
+}
+
+ThreadPool::Task* ThreadPool::find(unsigned worker)
+{
+    if (auto* task = mWorkers[worker]->deque.pop())
+        return task;
+    {
+        std::lock_guard lock{mSharedMutex};
+        if (!mShared.empty())
+        {
+            auto* task = mShared.front();
+            mShared.pop_front();
+            return task;
+        }
+    }
+    return steal(worker);
+}
+
+ThreadPool::Task* ThreadPool::steal(unsigned thief)
+{
+    const auto count = size();
+    for (unsigned round = 0; round < kStealRounds; ++round)
+    {
+        for (unsigned i = 1; i < count; ++i)
+        {
+            if (auto* task = mWorkers[(thief + i) % count]->deque.steal())
+                return task;
+        }
+    }
+    return nullptr;
+}
+
+void ThreadPool::workerLoop(unsigned worker)
+{
+    tWorker = WorkerIdentity{this, worker};
+    while (true)
+    {
+        const auto spawned = mSpawned.load(std::memory_order_seq_cst);
+        if (auto* task = find(worker))
+        {
+            execute(task);
+            continue;
+        }
+
+        std::unique_lock lock{mParkMutex};
+        mSleeping.fetch_add(1, std::memory_order_seq_cst);
+        mParked.wait(lock, [&] { return mStop.load() || mSpawned.load(std::memory_order_seq_cst) != spawned; });
+        mSleeping.fetch_sub(1, std::memory_order_seq_cst);
+        if (mStop.load())
+            return;
+    }
+}
+
+void ThreadPool::helpUntilDone(unsigned worker, const TaskGroup& group)
+{
+    while (!group.done())
+    {
+        if (auto* task = find(worker))
+            execute(task);
+        else
+            std::this_thread::yield();
+    }
+}
+
+TaskGroup::~TaskGroup()
+{
+    try
+    {
+        wait();
+    }
+    catch (...)
+    {
+    }
+}
+
+void TaskGroup::run(std::function<void()> task)
+{
+    mPending.fetch_add(1, std::memory_order_relaxed);
+    mPool.spawn(new ThreadPool::Task{std::move(task), this});
+}
+
+void TaskGroup::finish(std::exception_ptr error)
+{
+    if (error)
+    {
+        std::lock_guard lock{mMutex};
+        if (!mError)
+            mError = error;
+    }
+
+    // Any but the last task to finish just counts down. The last one counts down to zero under the lock: wait()
+    // takes the lock before it returns, so the group cannot be destroyed while this is still notifying it.
+    auto pending = mPending.load(std::memory_order_relaxed);
+    while (pending > 1)
+    {
+        if (mPending.compare_exchange_weak(pending, pending - 1, std::memory_order_acq_rel))
+            return;
+    }
+    std::lock_guard lock{mMutex};
+    if (mPending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        mDone.notify_all();
+}
+
+void TaskGroup::wait()
+{
+    const auto worker = mPool.currentWorker();
+    if (worker != ThreadPool::kNotAWorker)
+        mPool.helpUntilDone(worker, *this);
+
+    std::unique_lock lock{mMutex};
+    mDone.wait(lock, [this] { return done(); });
+    if (mError)
+        std::rethrow_exception(std::exchange(mError, nullptr));
+}
+
+} // namespace pho::prim
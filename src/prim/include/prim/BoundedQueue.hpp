@@ -0,0 +1,113 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace pho::prim {
+
+// A bounded multi-producer multi-consumer lock-free queue (Dmitry Vyukov's array queue).
+// Each cell carries a sequence number that tells producers and consumers whether it is free or full for the
+// current lap of the ring, so a push or a pop is one CAS on the shared index plus a release store on the cell.
+// tryPush() fails when the queue is full and tryPop() fails when it is empty; neither ever blocks.
+// T must be default constructible and movable.
+template <typename T>
+class BoundedQueue
+{
+public:
+    // The capacity is rounded up to a power of two.
+    explicit BoundedQueue(size_t capacity)
+    : mCapacity{roundUp(capacity)}
+    , mMask{mCapacity - 1}
+    , mCells{std::make_unique<Cell[]>(mCapacity)}
+    {
+        for (size_t i = 0; i < mCapacity; ++i)
+            mCells[i].sequence.store(i, std::memory_order_relaxed);
+        mEnqueuePos.store(0, std::memory_order_relaxed);
+        mDequeuePos.store(0, std::memory_order_relaxed);
+    }
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    size_t capacity() const { return mCapacity; }
+
+    bool tryPush(T value)
+    {
+        Cell* cell;
+        size_t pos = mEnqueuePos.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            cell = &mCells[pos & mMask];
+            const size_t seq = cell->sequence.load(std::memory_order_acquire);
+            const auto diff = intptr_t(seq) - intptr_t(pos);
+            if (diff == 0)
+            {
+                if (mEnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+                return false; // full
+            else
+                pos = mEnqueuePos.load(std::memory_order_relaxed);
+        }
+        cell->value = std::move(value);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPop(T& value)
+    {
+        Cell* cell;
+        size_t pos = mDequeuePos.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            cell = &mCells[pos & mMask];
+            const size_t seq = cell->sequence.load(std::memory_order_acquire);
+            const auto diff = intptr_t(seq) - intptr_t(pos + 1);
+            if (diff == 0)
+            {
+                if (mDequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+                return false; // empty
+            else
+                pos = mDequeuePos.load(std::memory_order_relaxed);
+        }
+        value = std::move(cell->value);
+        cell->sequence.store(pos + mMask + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    static constexpr size_t kCacheLine = 64;
+
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        T value{};
+    };
+
+    static size_t roundUp(size_t capacity)
+    {
+        assert(capacity > 0);
+        size_t result = 1;
+        while (result < capacity)
+            result <<= 1;
+        return result;
+    }
+
+    const size_t mCapacity;
+    const size_t mMask;
+    const std::unique_ptr<Cell[]> mCells;
+
+    // The two indices are on their own cache lines so that producers and consumers do not false-share.
+    alignas(kCacheLine) std::atomic<size_t> mEnqueuePos;
+    alignas(kCacheLine) std::atomic<size_t> mDequeuePos;
+};
+
+} // namespace pho::prim
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fmt/format.h>
+#include <stdexcept>
+#include <string>
+
+namespace pho::prim {
+
+// A read-only memory mapping of a whole file.
+// The size is that of the file actually mapped (fstat of the descriptor passed to mmap), so a file replaced by a
+// rename while it is being opened is either mapped whole or not at all, and never read past its end.
+class MappedFile
+{
+public:
+    // How the mapping will be read, passed on to madvise().
+    enum Access
+    {
+        eNormal,
+        eSequential,
+        eRandom
+    };
+
+    // Throws std::runtime_error if the file cannot be opened or mapped. An empty file has no mapping.
+    explicit MappedFile(const std::string& path, Access access = eNormal);
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile& operator=(MappedFile&&) = delete;
+
+    const std::string& path() const { return mPath; }
+    const std::byte* data() const { return static_cast<const std::byte*>(mBase); }
+    size_t size() const { return mSize; }
+
+    // The Header at the start of the file, after checking that the file is big enough for it and that it has
+    // Header::kMagic, Header::kVersion and a headerSize of sizeof(Header). `kind` names the file in the errors, e.g.
+    // "a pass table". Throws std::runtime_error.
+    template <typename Header>
+    const Header& header(const char* kind) const;
+
+    // Throws std::runtime_error unless the file has exactly `expected` bytes.
+    void expectSize(uint64_t expected) const;
+
+private:
+    std::string mPath;
+    void* mBase;
+    size_t mSize;
+};
+
+// Writes a file atomically: the data goes to a temporary file next to it, which commit() renames into place, so that
+// readers (and MappedFile) only ever see the old file or the complete new one.
+class AtomicFileWriter
+{
+public:
+    // Throws std::runtime_error if the temporary file cannot be created.
+    explicit AtomicFileWriter(const std::string& path);
+
+    // Removes the temporary file unless commit() succeeded.
+    ~AtomicFileWriter();
+
+    AtomicFileWriter(const AtomicFileWriter&) = delete;
+    AtomicFileWriter& operator=(const AtomicFileWriter&) = delete;
+
+    // Throws std::runtime_error on failure.
+    void write(const void* data, size_t size);
+
+    // Flush the temporary file and rename it to the path. Throws std::runtime_error on failure.
+    void commit();
+
+private:
+    std::string mPath;
+    std::string mTemporary;
+    FILE* mFile;
+};
+
+template <typename Header>
+const Header& MappedFile::header(const char* kind) const
+{
+    if (mSize < sizeof(Header))
+        throw std::runtime_error(fmt::format("{} is too short to be {}", mPath, kind));
+    const auto& header = *reinterpret_cast<const Header*>(mBase);
+    if (std::memcmp(header.magic, Header::kMagic, sizeof(header.magic)) != 0)
+        throw std::runtime_error(fmt::format("{} is not {}", mPath, kind));
+    if (header.version != Header::kVersion)
+        throw std::runtime_error(fmt::format("{} has unsupported version {}", mPath, header.version));
+    if (header.headerSize != sizeof(Header))
+        throw std::runtime_error(fmt::format(
+            "{} has an unsupported layout: a header of {} bytes, not {}", mPath, header.headerSize, sizeof(Header)));
+    return header;
+}
+
+} // namespace pho::prim
@@ -0,0 +1,186 @@
+#pragma once
+
+#include "prim/WorkStealingDeque.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace pho::prim {
+
+class TaskGroup;
+
+// A work-stealing task scheduler.
+//
+// Each worker thread has its own deque (see WorkStealingDeque.hpp). Tasks spawned by a worker go on its own deque,
+// where it takes the newest first; tasks spawned from other threads go on a shared queue. A worker that runs out of
+// work takes from the shared queue, then steals the oldest task of another worker, and parks on a condition variable
+// when there is nothing to steal, so an idle pool costs no CPU.
+//
+// Work is expressed with TaskGroup (fork/join) or parallelFor(). A worker waiting for a group runs other tasks while
+// it waits, so tasks may spawn and wait for tasks of their own without deadlock.
+class ThreadPool
+{
+public:
+    static constexpr unsigned kNotAWorker = ~0u;
+
+    // Zero workers means one per hardware thread.
+    explicit ThreadPool(unsigned workers = 0);
+
+    // Stops and joins the workers. Every TaskGroup of the pool must have been waited for.
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned size() const { return unsigned(mWorkers.size()); }
+
+    // The index in [0, size()) of the calling thread when it is one of this pool's workers, else kNotAWorker.
+    unsigned currentWorker() const;
+
+    // Call body(i) for every i in [first, last), in chunks of at most `grain` consecutive indices, and return when all
+    // calls have returned. The range is split in halves until the pieces are no longer than the grain, so idle workers
+    // steal large pieces. The first exception thrown by a call is rethrown once the other pieces are done; the rest of
+    // the piece that threw is skipped.
+    template <typename Body>
+    void parallelFor(size_t first, size_t last, size_t grain, const Body& body);
+
+private:
+    friend TaskGroup;
+
+    struct Task
+    {
+        std::function<void()> run;
+        TaskGroup* group;
+    };
+
+    struct Worker
+    {
+        WorkStealingDeque<Task> deque;
+    };
+
+    void spawn(Task* task);
+    void execute(Task* task);
+
+    // Take a task: from the worker's own deque, then the shared queue, then by stealing.
+    Task* find(unsigned worker);
+    Task* steal(unsigned thief);
+    void workerLoop(unsigned worker);
+
+    // Run tasks on the calling worker until the group is done.
+    void helpUntilDone(unsigned worker, const TaskGroup& group);
+
+    void wake();
+
+    std::vector<std::unique_ptr<Worker>> mWorkers;
+    std::vector<std::thread> mThreads;
+
+    std::mutex mSharedMutex;
+    std::deque<Task*> mShared; // tasks spawned from threads that are not workers
+
+    // Parking: a worker parks only if no task was spawned since it last looked for one.
+    std::mutex mParkMutex;
+    std::condition_variable mParked;
+    std::atomic<uint64_t> mSpawned{0};
+    std::atomic<unsigned> mSleeping{0};
+    std::atomic<bool> mStop{false};
+};
+
+// A fork/join group: run() spawns tasks on the pool and wait() returns once they, and any tasks they ran in the
+// group, have finished. The first exception thrown by a task is rethrown by wait(); later tasks still run.
+class TaskGroup
+{
+public:
+    explicit TaskGroup(ThreadPool& pool)
+    : mPool{pool}
+    { }
+
+    // Waits for the tasks still running, discarding any exception.
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    void run(std::function<void()> task);
+
+    void wait();
+
+private:
+    friend ThreadPool;
+
+    void finish(std::exception_ptr error);
+    bool done() const { return mPending.load(std::memory_order_acquire) == 0; }
+
+    ThreadPool& mPool;
+    std::atomic<size_t> mPending{0};
+
+    std::mutex mMutex;
+    std::condition_variable mDone; // for waiters that are not workers
+    std::exception_ptr mError;
+};
+
+// One T per worker of a pool, plus one for other threads, each on its own cache line: scratch buffers and partial
+// results that tasks use without locking. local() is only safe for one non-worker thread at a time.
+template <typename T>
+class PerWorker
+{
+public:
+    explicit PerWorker(const ThreadPool& pool, const T& initial = T{})
+    : mPool{pool}
+    , mSlots(pool.size() + 1, Slot{initial})
+    { }
+
+    T& local()
+    {
+        const auto worker = mPool.currentWorker();
+        return mSlots[worker == ThreadPool::kNotAWorker ? mSlots.size() - 1 : worker].value;
+    }
+
+    // The slots, for combining the results once the work is done.
+    size_t size() const { return mSlots.size(); }
+    T& operator[](size_t i) { return mSlots[i].value; }
+    const T& operator[](size_t i) const { return mSlots[i].value; }
+
+private:
+    struct alignas(64) Slot
+    {
+        T value;
+    };
+
+    const ThreadPool& mPool;
+    std::vector<Slot> mSlots;
+};
+
+template <typename Body>
+void ThreadPool::parallelFor(size_t first, size_t last, size_t grain, const Body& body)
+{
+    if (first >= last)
+        return;
+    grain = std::max<size_t>(grain, 1);
+
+    TaskGroup group{*this};
+    // Keep the right half of the range for others and go on with the left, so the oldest tasks, the ones thieves
+    // take, are the largest.
+    std::function<void(size_t, size_t)> split = [&](size_t begin, size_t end) {
+        while (end - begin > grain)
+        {
+            const auto middle = begin + (end - begin) / 2;
+            group.run([&split, middle, end] { split(middle, end); });
+            end = middle;
+        }
+        for (auto i = begin; i < end; ++i)
+            body(i);
+    };
+    group.run([&split, first, last] { split(first, last); });
+    group.wait();
+}
+
+} // namespace pho::prim
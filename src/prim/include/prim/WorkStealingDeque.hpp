@@ -0,0 +1,131 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace pho::prim {
+
+// A Chase-Lev work-stealing deque of pointers, with the memory orderings of Lê, Pop, Cohen and Zappa Nardelli,
+// "Correct and Efficient Work-Stealing for Weak Memory Models" (PPoPP 2013).
+// Only the owning thread may push() and pop(), which work at the bottom like a stack; any thread may steal(), which
+// takes from the top, so thieves take the oldest (typically largest) tasks and rarely contend with the owner.
+// The ring grows when full. The rings it outgrows are kept until the deque is destroyed, because a thief may still
+// be reading one.
+template <typename T>
+class WorkStealingDeque
+{
+public:
+    // The capacity is rounded up to a power of two.
+    explicit WorkStealingDeque(size_t capacity = 256)
+    {
+        size_t size = 1;
+        while (size < capacity)
+            size <<= 1;
+        mRings.push_back(std::make_unique<Ring>(size));
+        mRing.store(mRings.back().get(), std::memory_order_relaxed);
+    }
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    // Owner only.
+    void push(T* item)
+    {
+        const auto bottom = mBottom.load(std::memory_order_relaxed);
+        const auto top = mTop.load(std::memory_order_acquire);
+        auto* ring = mRing.load(std::memory_order_relaxed);
+        if (bottom - top > int64_t(ring->mask))
+            ring = grow(ring, top, bottom);
+        ring->put(bottom, item);
+        // A release store in place of the paper's release fence and relaxed store: it orders the same writes, and TSan
+        // understands it.
+        mBottom.store(bottom + 1, std::memory_order_release);
+    }
+
+    // Owner only. The most recently pushed item, or nullptr when empty.
+    T* pop()
+    {
+        const auto bottom = mBottom.load(std::memory_order_relaxed) - 1;
+        auto* ring = mRing.load(std::memory_order_relaxed);
+        mBottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto top = mTop.load(std::memory_order_relaxed);
+
+        if (top > bottom)
+        {
+            mBottom.store(bottom + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        T* item = ring->get(bottom);
+        if (top == bottom)
+        {
+            // The last item: race any thief for it.
+            if (!mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                item = nullptr;
+            mBottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    // Any thread. The oldest item, or nullptr when empty or when another thread took it first.
+    T* steal()
+    {
+        auto top = mTop.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const auto bottom = mBottom.load(std::memory_order_acquire);
+        if (top >= bottom)
+            return nullptr;
+
+        auto* ring = mRing.load(std::memory_order_acquire);
+        T* item = ring->get(top);
+        if (!mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return nullptr;
+        return item;
+    }
+
+    // A snapshot, exact only when no other thread is using the deque.
+    bool empty() const
+    {
+        return mBottom.load(std::memory_order_relaxed) <= mTop.load(std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr size_t kCacheLine = 64;
+
+    struct Ring
+    {
+        explicit Ring(size_t size)
+        : mask{size - 1}
+        , items{std::make_unique<std::atomic<T*>[]>(size)}
+        { }
+
+        T* get(int64_t i) const { return items[size_t(i) & mask].load(std::memory_order_relaxed); }
+        void put(int64_t i, T* item) { items[size_t(i) & mask].store(item, std::memory_order_relaxed); }
+
+        const size_t mask;
+        const std::unique_ptr<std::atomic<T*>[]> items;
+    };
+
+    Ring* grow(Ring* ring, int64_t top, int64_t bottom)
+    {
+        mRings.push_back(std::make_unique<Ring>(2 * (ring->mask + 1)));
+        auto* bigger = mRings.back().get();
+        for (auto i = top; i < bottom; ++i)
+            bigger->put(i, ring->get(i));
+        mRing.store(bigger, std::memory_order_release);
+        return bigger;
+    }
+
+    // The indices are on their own cache lines so that the owner and the thieves do not false-share.
+    alignas(kCacheLine) std::atomic<int64_t> mTop{0};
+    alignas(kCacheLine) std::atomic<int64_t> mBottom{0};
+    alignas(kCacheLine) std::atomic<Ring*> mRing{nullptr};
+    std::vector<std::unique_ptr<Ring>> mRings; // owner only
+};
+
+} // namespace pho::prim
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace pho::prim {
+
+// The SplitMix64 finalizer: a fast bijective mix of all 64 bits.
+inline uint64_t mix64(uint64_t x)
+{
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+// A fast non-cryptographic 64-bit hash of a block of memory.
+// It is used for checksums of files we write ourselves and for hashing compact state encodings, so it only needs
+// to be stable across runs and platforms of the same endianness, and to detect accidental corruption.
+// Pass the previous result as the seed to hash a sequence of blocks incrementally.
+inline uint64_t hash64(const void* data, size_t size, uint64_t seed = 0)
+{
+    constexpr uint64_t kGolden = 0x9e3779b97f4a7c15ull;
+
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    uint64_t h = mix64(seed ^ (size * kGolden));
+
+    for (; size >= sizeof(uint64_t); size -= sizeof(uint64_t), bytes += sizeof(uint64_t))
+    {
+        uint64_t word;
+        std::memcpy(&word, bytes, sizeof(word));
+        h = mix64(h ^ word) + kGolden;
+    }
+
+    if (size > 0)
+    {
+        uint64_t word = 0;
+        std::memcpy(&word, bytes, size);
+        h = mix64(h ^ word ^ (uint64_t(size) << 56));
+    }
+
+    return mix64(h);
+}
+
+} // namespace pho::prim
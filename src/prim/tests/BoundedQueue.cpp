@@ -0,0 +1,87 @@
+#include "gtest/gtest.h"
+
+#include "prim/BoundedQueue.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace pho::prim::tests {
+
+TEST(BoundedQueue, fifo_until_full)
+{
+    BoundedQueue<int> queue{5};
+    EXPECT_EQ(queue.capacity(), 8u);
+
+    int value = -1;
+    EXPECT_FALSE(queue.tryPop(value));
+
+    for (int i = 0; i < 8; ++i)
+        EXPECT_TRUE(queue.tryPush(i));
+    EXPECT_FALSE(queue.tryPush(8));
+
+    for (int i = 0; i < 8; ++i)
+    {
+        EXPECT_TRUE(queue.tryPop(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(queue.tryPop(value));
+}
+
+TEST(BoundedQueue, wraps_around)
+{
+    BoundedQueue<int> queue{4};
+    int value = -1;
+    for (int i = 0; i < 100; ++i)
+    {
+        EXPECT_TRUE(queue.tryPush(i));
+        EXPECT_TRUE(queue.tryPush(i + 1000));
+        EXPECT_TRUE(queue.tryPop(value));
+        EXPECT_EQ(value, i);
+        EXPECT_TRUE(queue.tryPop(value));
+        EXPECT_EQ(value, i + 1000);
+    }
+}
+
+TEST(BoundedQueue, many_producers_many_consumers)
+{
+    constexpr int kThreads = 4;
+    constexpr int kPerProducer = 20000;
+
+    BoundedQueue<int> queue{64};
+    std::atomic<int> consumed{0};
+    std::atomic<int64_t> sum{0};
+
+    auto threads = std::vector<std::thread>{};
+    for (int t = 0; t < kThreads; ++t)
+    {
+        threads.emplace_back([&queue, t]() {
+            for (int i = 0; i < kPerProducer; ++i)
+            {
+                while (!queue.tryPush(t * kPerProducer + i))
+                    std::this_thread::yield();
+            }
+        });
+        threads.emplace_back([&]() {
+            int value;
+            while (consumed < kThreads * kPerProducer)
+            {
+                if (queue.tryPop(value))
+                {
+                    sum += value;
+                    ++consumed;
+                }
+                else
+                    std::this_thread::yield();
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    constexpr int64_t kTotal = kThreads * kPerProducer;
+    EXPECT_EQ(consumed, kTotal);
+    EXPECT_EQ(sum, kTotal * (kTotal - 1) / 2);
+}
+
+} // namespace pho::prim::tests
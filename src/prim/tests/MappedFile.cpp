@@ -0,0 +1,142 @@
+#include "gtest/gtest.h"
+
+#include "prim/MappedFile.hpp"
+#include "prim/tests/scratch.hpp"
+
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+
+namespace pho::prim::tests {
+
+namespace fs = std::filesystem;
+
+namespace {
+struct TestHeader
+{
+    static constexpr char kMagic[8] = {'P', 'H', 'O', 'T', 'E', 'S', 'T', 'H'};
+    static constexpr uint32_t kVersion = 3;
+
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint64_t payload;
+};
+
+auto makeHeader(uint64_t payload) -> TestHeader
+{
+    auto header = TestHeader{};
+    std::memcpy(header.magic, TestHeader::kMagic, sizeof(header.magic));
+    header.version = TestHeader::kVersion;
+    header.headerSize = sizeof(TestHeader);
+    header.payload = payload;
+    return header;
+}
+
+auto writeFile(const std::string& path, const void* data, size_t size) -> void
+{
+    auto writer = AtomicFileWriter{path};
+    writer.write(data, size);
+    writer.commit();
+}
+} // namespace
+
+TEST(MappedFile, maps_the_whole_file)
+{
+    const auto path = scratchPath("whole");
+    const auto text = std::string{"hello, mapping"};
+    writeFile(path, text.data(), text.size());
+
+    auto file = MappedFile{path, MappedFile::eSequential};
+    EXPECT_EQ(file.size(), text.size());
+    EXPECT_EQ(std::string(reinterpret_cast<const char*>(file.data()), file.size()), text);
+    EXPECT_NO_THROW(file.expectSize(text.size()));
+    EXPECT_THROW(file.expectSize(text.size() + 1), std::runtime_error);
+
+    // The mapping moves with the object.
+    const auto moved = MappedFile{std::move(file)};
+    EXPECT_EQ(moved.size(), text.size());
+    EXPECT_EQ(std::string(reinterpret_cast<const char*>(moved.data()), moved.size()), text);
+    fs::remove(path);
+}
+
+TEST(MappedFile, maps_an_empty_file)
+{
+    const auto path = scratchPath("empty");
+    writeFile(path, nullptr, 0);
+    const auto file = MappedFile{path};
+    EXPECT_EQ(file.size(), 0u);
+    EXPECT_THROW(file.header<TestHeader>("a test file"), std::runtime_error);
+    fs::remove(path);
+}
+
+TEST(MappedFile, rejects_a_missing_file) { EXPECT_THROW(MappedFile{scratchPath("missing")}, std::runtime_error); }
+
+TEST(MappedFile, validates_the_header)
+{
+    const auto path = scratchPath("header");
+    auto header = makeHeader(42);
+    writeFile(path, &header, sizeof(header));
+    EXPECT_EQ(MappedFile{path}.header<TestHeader>("a test file").payload, 42u);
+
+    // Too short.
+    writeFile(path, &header, sizeof(header) - 1);
+    EXPECT_THROW(MappedFile{path}.header<TestHeader>("a test file"), std::runtime_error);
+
+    header = makeHeader(42);
+    header.magic[0] = 'X';
+    writeFile(path, &header, sizeof(header));
+    EXPECT_THROW(MappedFile{path}.header<TestHeader>("a test file"), std::runtime_error);
+
+    header = makeHeader(42);
+    header.version = TestHeader::kVersion + 1;
+    writeFile(path, &header, sizeof(header));
+    EXPECT_THROW(MappedFile{path}.header<TestHeader>("a test file"), std::runtime_error);
+
+    header = makeHeader(42);
+    header.headerSize = sizeof(TestHeader) + 8;
+    writeFile(path, &header, sizeof(header));
+    EXPECT_THROW(MappedFile{path}.header<TestHeader>("a test file"), std::runtime_error);
+    fs::remove(path);
+}
+
+TEST(MappedFile, keeps_the_file_it_mapped_when_it_is_replaced)
+{
+    const auto path = scratchPath("replaced");
+    const auto before = makeHeader(1);
+    writeFile(path, &before, sizeof(before));
+    const auto file = MappedFile{path};
+
+    const auto after = std::string(1000, 'x');
+    writeFile(path, after.data(), after.size());
+    EXPECT_EQ(file.size(), sizeof(before));
+    EXPECT_EQ(file.header<TestHeader>("a test file").payload, 1u);
+    EXPECT_EQ(MappedFile{path}.size(), after.size());
+    fs::remove(path);
+}
+
+TEST(AtomicFileWriter, leaves_the_old_file_until_commit)
+{
+    const auto path = scratchPath("atomic");
+    writeFile(path, "old", 3);
+    {
+        auto writer = AtomicFileWriter{path};
+        writer.write("new contents", 12);
+        EXPECT_EQ(fs::file_size(path), 3u);
+        // Destroyed without commit().
+    }
+    EXPECT_EQ(fs::file_size(path), 3u);
+    EXPECT_FALSE(fs::exists(path + ".tmp"));
+
+    writeFile(path, "new contents", 12);
+    EXPECT_EQ(fs::file_size(path), 12u);
+    EXPECT_FALSE(fs::exists(path + ".tmp"));
+    fs::remove(path);
+}
+
+TEST(AtomicFileWriter, rejects_a_path_it_cannot_create)
+{
+    EXPECT_THROW(AtomicFileWriter{scratchPath("no_such_dir") + "/file"}, std::runtime_error);
+}
+
+} // namespace pho::prim::tests
@@ -0,0 +1,131 @@
+#include "gtest/gtest.h"
+
+#include "prim/ThreadPool.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace pho::prim::tests {
+
+namespace {
+// The naive recursive Fibonacci, forking both calls, to exercise nested fork/join.
+uint64_t fib(ThreadPool& pool, unsigned n)
+{
+    if (n < 12)
+        return n < 2 ? n : fib(pool, n - 1) + fib(pool, n - 2);
+    uint64_t a = 0;
+    uint64_t b = 0;
+    TaskGroup group{pool};
+    group.run([&] { a = fib(pool, n - 1); });
+    b = fib(pool, n - 2);
+    group.wait();
+    return a + b;
+}
+} // namespace
+
+TEST(ThreadPool, parallel_for_visits_each_index_once)
+{
+    ThreadPool pool{4};
+    EXPECT_EQ(pool.size(), 4u);
+    EXPECT_EQ(pool.currentWorker(), ThreadPool::kNotAWorker);
+
+    for (size_t count : {0, 1, 7, 1000, 100003})
+    {
+        for (size_t grain : {0, 1, 16, 5000})
+        {
+            auto visits = std::vector<std::atomic<int>>(count);
+            pool.parallelFor(0, count, grain, [&](size_t i) { ++visits[i]; });
+            for (size_t i = 0; i < count; ++i)
+                ASSERT_EQ(visits[i], 1) << count << " " << grain << " " << i;
+        }
+    }
+
+    auto sum = std::atomic<size_t>{};
+    pool.parallelFor(10, 20, 3, [&](size_t i) { sum += i; });
+    EXPECT_EQ(sum, 145u);
+}
+
+TEST(ThreadPool, nested_fork_join)
+{
+    ThreadPool pool{4};
+    EXPECT_EQ(fib(pool, 27), 196418u);
+
+    // parallelFor inside parallelFor.
+    auto total = std::atomic<size_t>{};
+    pool.parallelFor(0, 20, 1, [&](size_t) { pool.parallelFor(0, 100, 10, [&](size_t j) { total += j; }); });
+    EXPECT_EQ(total, 20u * 4950u);
+}
+
+TEST(ThreadPool, per_worker_scratch)
+{
+    ThreadPool pool{3};
+    auto partial = PerWorker<uint64_t>{pool};
+    EXPECT_EQ(partial.size(), 4u);
+    auto workers = PerWorker<std::vector<unsigned>>{pool};
+
+    pool.parallelFor(0, 100000, 64, [&](size_t i) {
+        partial.local() += i;
+        const auto worker = pool.currentWorker();
+        ASSERT_LT(worker, pool.size());
+        workers.local().push_back(worker);
+    });
+
+    auto total = uint64_t{};
+    for (size_t i = 0; i < partial.size(); ++i)
+    {
+        total += partial[i];
+        for (auto worker : workers[i])
+            EXPECT_EQ(worker, i);
+    }
+    EXPECT_EQ(total, 99999ull * 100000 / 2);
+    EXPECT_TRUE(workers[partial.size() - 1].empty()); // all calls ran on workers
+}
+
+TEST(ThreadPool, propagates_exceptions)
+{
+    ThreadPool pool{2};
+    auto calls = std::atomic<int>{};
+    EXPECT_THROW(pool.parallelFor(0, 1000, 1,
+                     [&](size_t i) {
+                         ++calls;
+                         if (i == 500)
+                             throw std::runtime_error("failed");
+                     }),
+        std::runtime_error);
+    EXPECT_EQ(calls, 1000);
+
+    TaskGroup group{pool};
+    group.run([] { throw std::invalid_argument("bad"); });
+    group.run([] {});
+    EXPECT_THROW(group.wait(), std::invalid_argument);
+    EXPECT_NO_THROW(group.wait());
+}
+
+TEST(ThreadPool, wakes_after_parking_and_serves_many_threads)
+{
+    ThreadPool pool{4};
+    // Let the workers park, then give them work from several threads at once.
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    auto sums = std::vector<uint64_t>(4);
+    auto callers = std::vector<std::thread>{};
+    for (size_t t = 0; t < sums.size(); ++t)
+    {
+        callers.emplace_back([&, t]() {
+            auto sum = std::atomic<uint64_t>{};
+            for (int round = 0; round < 20; ++round)
+                pool.parallelFor(0, 1000, 8, [&](size_t i) { sum += i; });
+            sums[t] = sum;
+        });
+    }
+    for (auto& caller : callers)
+        caller.join();
+    for (auto sum : sums)
+        EXPECT_EQ(sum, 20u * 999 * 1000 / 2);
+}
+
+} // namespace pho::prim::tests
@@ -0,0 +1,77 @@
+#include "gtest/gtest.h"
+
+#include "prim/WorkStealingDeque.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace pho::prim::tests {
+
+TEST(WorkStealingDeque, owner_lifo_thief_fifo)
+{
+    auto items = std::vector<int>(10);
+    WorkStealingDeque<int> deque{4};
+    EXPECT_EQ(deque.pop(), nullptr);
+    EXPECT_EQ(deque.steal(), nullptr);
+
+    // Pushing more than the capacity grows the ring.
+    for (auto& item : items)
+        deque.push(&item);
+    EXPECT_EQ(deque.steal(), &items[0]);
+    EXPECT_EQ(deque.steal(), &items[1]);
+    EXPECT_EQ(deque.pop(), &items[9]);
+    EXPECT_EQ(deque.pop(), &items[8]);
+    for (int i = 2; i < 8; ++i)
+        EXPECT_EQ(deque.steal(), &items[i]);
+    EXPECT_EQ(deque.pop(), nullptr);
+    EXPECT_TRUE(deque.empty());
+}
+
+TEST(WorkStealingDeque, every_item_taken_once)
+{
+    constexpr int kItems = 200000;
+    constexpr int kThieves = 3;
+
+    auto items = std::vector<int>(kItems);
+    auto taken = std::vector<std::atomic<int>>(kItems);
+    WorkStealingDeque<int> deque{16};
+    std::atomic<bool> pushing{true};
+
+    const auto take = [&](int* item) { ++taken[item - items.data()]; };
+
+    auto thieves = std::vector<std::thread>{};
+    for (int t = 0; t < kThieves; ++t)
+    {
+        thieves.emplace_back([&]() {
+            while (pushing || !deque.empty())
+            {
+                if (auto* item = deque.steal())
+                    take(item);
+                else
+                    std::this_thread::yield();
+            }
+        });
+    }
+
+    // The owner pushes in bursts and pops some back, racing the thieves for the last items.
+    for (int i = 0; i < kItems; ++i)
+    {
+        deque.push(&items[i]);
+        if (i % 3 == 0)
+        {
+            if (auto* item = deque.pop())
+                take(item);
+        }
+    }
+    while (auto* item = deque.pop())
+        take(item);
+    pushing = false;
+    for (auto& thief : thieves)
+        thief.join();
+
+    for (int i = 0; i < kItems; ++i)
+        ASSERT_EQ(taken[i], 1) << i;
+}
+
+} // namespace pho::prim::tests
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <filesystem>
+#include <fmt/format.h>
+#include <string>
+#include <unistd.h>
+
+// Scratch files for the tests of all the components. Names include the process id, so tests running in parallel do
+// not collide.
+namespace pho::prim::tests {
+
+// A path in the temporary directory for a file named after `name`, with nothing at it yet.
+inline std::string scratchPath(const std::string& name)
+{
+    auto path = std::filesystem::temp_directory_path() / fmt::format("pho_test_{}_{}", name, ::getpid());
+    std::filesystem::remove_all(path);
+    return path.string();
+}
+
+// An empty directory in the temporary directory, named after `name`.
+inline std::filesystem::path scratchDir(const std::string& name)
+{
+    auto dir = std::filesystem::path{scratchPath(name)};
+    std::filesystem::create_directories(dir);
+    return dir;
+}
+
+} // namespace pho::prim::tests
@@ -0,0 +1,241 @@
+#include "selfplay/Loader.hpp"
+#include "prim/dlog.hpp"
+#include "prim/hash.hpp"
+#include "prim/range.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <fmt/format.h>
+#include <stdexcept>
+
+namespace pho::selfplay {
+
+using cards::kNumPlayers;
+
+namespace {
+DLog dlog("loader");
+
+constexpr uint64_t kForever = ~uint64_t{0};
+
+// Back off from spinning to sleeping while waiting for the other side of a queue.
+class Waiter
+{
+public:
+    auto wait() -> void
+    {
+        if (++mSpins < kYields)
+            std::this_thread::yield();
+        else
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+
+private:
+    static constexpr unsigned kYields = 64;
+    unsigned mSpins{};
+};
+
+auto numThreadsFor(const LoaderConfig& config) -> unsigned
+{
+    return config.threads > 0 ? config.threads : std::max(1u, std::thread::hardware_concurrency());
+}
+
+auto layoutOf(const std::vector<std::string>& paths) -> RecordLayout
+{
+    if (paths.empty())
+        throw std::invalid_argument("BatchLoader needs at least one shard");
+    return readShardHeader(paths.front()).layout();
+}
+} // namespace
+
+MappedShard::MappedShard(const std::string& path, bool verifyChecksum)
+: mFile{path, prim::MappedFile::eRandom} // records are sampled in random order, so read-ahead would not help
+, mHeader{readShardHeader(mFile, verifyChecksum)}
+, mRecords{mFile.data() + sizeof(ShardHeader)}
+{ }
+
+ShuffledIndex::ShuffledIndex(uint64_t size, uint64_t seed)
+: mSize{size}
+, mHalfBits{1}
+{
+    while (mHalfBits < 32 && (uint64_t{1} << (2 * mHalfBits)) < size)
+        ++mHalfBits;
+    mHalfMask = (uint64_t{1} << mHalfBits) - 1;
+    for (auto round : prim::range(kRounds))
+        mKeys[round] = prim::mix64(seed + prim::mix64(round + 1));
+}
+
+auto ShuffledIndex::encrypt(uint64_t x) const -> uint64_t
+{
+    uint64_t left = x >> mHalfBits;
+    uint64_t right = x & mHalfMask;
+    for (auto key : mKeys)
+    {
+        const uint64_t next = left ^ (prim::mix64(right ^ key) & mHalfMask);
+        left = right;
+        right = next;
+    }
+    return (left << mHalfBits) | right;
+}
+
+auto ShuffledIndex::operator()(uint64_t i) const -> uint64_t
+{
+    assert(i < mSize);
+    do
+        i = encrypt(i);
+    while (i >= mSize);
+    return i;
+}
+
+BatchLoader::BatchLoader(const std::vector<std::string>& paths, const LoaderConfig& config)
+: mConfig{config}
+, mShards{}
+, mShardStart{}
+, mLayout{layoutOf(paths)}
+, mNumRecords{}
+, mNumBatches{}
+, mBatches{}
+, mFree{size_t{config.queueDepth} + numThreadsFor(config) + 1}
+, mReady{mFree.capacity()}
+, mCurrent{nullptr}
+, mNextBatch{0}
+, mRunning{0}
+, mStop{false}
+{
+    if (config.batchSize == 0)
+        throw std::invalid_argument("LoaderConfig.batchSize must be positive");
+
+    mShards.reserve(paths.size());
+    for (const auto& path : paths)
+    {
+        auto shard = MappedShard{path, config.verifyChecksums};
+        if (!(shard.header().layout() == mLayout))
+            throw std::runtime_error(fmt::format("Shard {} has a different record layout", path));
+        if (shard.count() == 0)
+            continue;
+        mShardStart.push_back(mNumRecords);
+        mNumRecords += shard.count();
+        mShards.push_back(std::move(shard));
+    }
+    if (mNumRecords == 0)
+        throw std::runtime_error("The shards contain no records");
+
+    mNumBatches = config.epochs == 0 ? kForever
+                                     : (config.epochs * mNumRecords + config.batchSize - 1) / config.batchSize;
+
+    const auto numThreads = numThreadsFor(config);
+    dlog("{} records in {} shards, {} batches, {} threads", mNumRecords, mShards.size(), mNumBatches, numThreads);
+
+    // Every batch is always in exactly one place: the free queue, a worker, the ready queue or the consumer,
+    // so neither queue can overflow.
+    mBatches.resize(mFree.capacity());
+    for (auto& batch : mBatches)
+    {
+        batch.tensors.resize(size_t{config.batchSize} * mLayout.tensorFloats());
+        batch.legal.resize(config.batchSize);
+        batch.chosen.resize(config.batchSize);
+        batch.player.resize(config.batchSize);
+        batch.scores.resize(size_t{config.batchSize} * kNumPlayers);
+        batch.records.resize(config.batchSize);
+        mFree.tryPush(&batch);
+    }
+
+    mRunning = numThreads;
+    for (unsigned t = 0; t < numThreads; ++t)
+        mThreads.emplace_back([this]() { work(); });
+}
+
+BatchLoader::~BatchLoader()
+{
+    mStop = true;
+    for (auto& thread : mThreads)
+        thread.join();
+}
+
+auto BatchLoader::locate(uint64_t record) const -> const std::byte*
+{
+    const auto it = std::upper_bound(mShardStart.begin(), mShardStart.end(), record) - 1;
+    const auto shard = size_t(it - mShardStart.begin());
+    return mShards[shard].record(record - *it);
+}
+
+auto BatchLoader::recordAt(uint64_t position) const -> uint64_t
+{
+    const auto offset = position % mNumRecords;
+    if (!mConfig.shuffle)
+        return offset;
+    const auto epoch = position / mNumRecords;
+    return ShuffledIndex{mNumRecords, prim::mix64(mConfig.seed) + epoch}(offset);
+}
+
+auto BatchLoader::decode(uint64_t record, RecordHead& head, float* tensor) const -> void
+{
+    mLayout.unpack(locate(record), head, tensor);
+}
+
+auto BatchLoader::fill(Batch& batch, uint64_t index) const -> void
+{
+    const auto first = index * mConfig.batchSize;
+    const auto last = mConfig.epochs == 0 ? first + mConfig.batchSize
+                                          : std::min(first + mConfig.batchSize, mConfig.epochs * mNumRecords);
+    batch.index = index;
+    batch.size = unsigned(last - first);
+
+    const auto tensorFloats = mLayout.tensorFloats();
+    for (auto row : prim::range(batch.size))
+    {
+        const auto record = recordAt(first + row);
+        auto head = RecordHead{};
+        decode(record, head, batch.tensors.data() + row * tensorFloats);
+        batch.legal[row] = head.legal;
+        batch.chosen[row] = head.chosen;
+        batch.player[row] = head.player;
+        std::copy(head.scores.begin(), head.scores.end(), batch.scores.begin() + row * kNumPlayers);
+        batch.records[row] = record;
+    }
+}
+
+auto BatchLoader::work() -> void
+{
+    while (!mStop)
+    {
+        Batch* batch = nullptr;
+        for (auto waiter = Waiter{}; !mFree.tryPop(batch); waiter.wait())
+        {
+            if (mStop)
+                break;
+        }
+        if (batch == nullptr)
+            break;
+
+        const auto index = mNextBatch.fetch_add(1);
+        if (index >= mNumBatches)
+        {
+            mFree.tryPush(batch);
+            break;
+        }
+        fill(*batch, index);
+        mReady.tryPush(batch);
+    }
+    --mRunning;
+}
+
+auto BatchLoader::next() -> const Batch*
+{
+    if (mCurrent != nullptr)
+    {
+        mFree.tryPush(mCurrent);
+        mCurrent = nullptr;
+    }
+
+    for (auto waiter = Waiter{};; waiter.wait())
+    {
+        if (mReady.tryPop(mCurrent))
+            return mCurrent;
+        // Workers publish their last batch before they stop running, so check the queue once more.
+        if (mRunning == 0)
+            return mReady.tryPop(mCurrent) ? mCurrent : nullptr;
+    }
+}
+
+} // namespace pho::selfplay
@@ -0,0 +1,251 @@
+#include "selfplay/PassEvaluator.hpp"
+#include "cards/Deal.hpp"
+#include "gstate/GState.hpp"
+#include "prim/dlog.hpp"
+#include "prim/range.hpp"
+#include "stats/RunningStats.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <fmt/format.h>
+#include <stdexcept>
+#include <thread>
+
+namespace pho::selfplay {
+
+using namespace pho::gstate;
+
+namespace {
+DLog dlog("passeval");
+
+constexpr unsigned kCardsPassed = 3;
+
+auto candidatesFor(CardSet hand, const PassEvalConfig& config) -> std::vector<CardSet>
+{
+    if (!config.candidates.empty())
+    {
+        for (auto pass : config.candidates)
+        {
+            if (pass.size() != kCardsPassed || (pass & hand) != pass)
+                throw std::invalid_argument(fmt::format("{} is not a pass from {}", to_string(pass), to_string(hand)));
+        }
+        return config.candidates;
+    }
+
+    const auto numPasses = math::binomial(kCardsPerHand, kCardsPassed);
+    auto passes = std::vector<CardSet>{};
+    passes.reserve(numPasses);
+    for (auto i : prim::range(numPasses))
+        passes.push_back(unrankSubset(i, kCardsPassed, hand));
+    return passes;
+}
+
+// The scores of every pass on every sample, and which passes are still being evaluated.
+class ScoreTable
+{
+public:
+    ScoreTable(size_t numPasses, uint64_t numSamples)
+    : mNumPasses{numPasses}
+    , mScores(numPasses * numSamples)
+    , mSamples(numPasses)
+    , mActive(numPasses, true)
+    { }
+
+    auto numPasses() const -> size_t { return mNumPasses; }
+    auto active(size_t pass) const -> bool { return mActive[pass]; }
+    auto samples(size_t pass) const -> uint64_t { return mSamples[pass]; }
+    auto score(uint64_t sample, size_t pass) const -> float { return mScores[sample * mNumPasses + pass]; }
+    auto score(uint64_t sample, size_t pass) -> float& { return mScores[sample * mNumPasses + pass]; }
+
+    auto finishBatch(uint64_t end) -> void
+    {
+        for (auto i : prim::range(mNumPasses))
+        {
+            if (mActive[i])
+                mSamples[i] = end;
+        }
+    }
+
+    auto deactivate(size_t pass) -> void { mActive[pass] = false; }
+
+    auto meanStats(size_t pass) const -> stats::RunningStats
+    {
+        auto result = stats::RunningStats{};
+        for (auto s : prim::range(mSamples[pass]))
+            result += score(s, pass);
+        return result;
+    }
+
+    // The paired differences of `pass` to `other` over the samples of `pass`, which `other` must also have.
+    auto deltaStats(size_t pass, size_t other) const -> stats::RunningStats
+    {
+        assert(mSamples[pass] <= mSamples[other]);
+        auto result = stats::RunningStats{};
+        for (auto s : prim::range(mSamples[pass]))
+            result += double(score(s, pass)) - score(s, other);
+        return result;
+    }
+
+    // The active pass with the lowest mean score.
+    auto leader() const -> size_t
+    {
+        auto best = size_t{};
+        auto bestMean = INFINITY;
+        for (auto i : prim::range(mNumPasses))
+        {
+            if (!mActive[i])
+                continue;
+            const auto mean = meanStats(i).mean();
+            if (mean < bestMean)
+            {
+                best = i;
+                bestMean = mean;
+            }
+        }
+        return best;
+    }
+
+private:
+    size_t mNumPasses;
+    std::vector<float> mScores; // mScores[s * mNumPasses + i] is the score of pass i on sample s
+    std::vector<uint64_t> mSamples;
+    std::vector<bool> mActive;
+};
+
+auto halfWidth(const stats::RunningStats& stats, double z) -> double
+{
+    return stats.size() < 2 ? INFINITY : z * stats.stddev() / std::sqrt(double(stats.size()));
+}
+
+// Play out one sample for every active pass, writing the scores into the table.
+auto evaluateSample(CardSet hand,
+    const std::vector<CardSet>& passes,
+    const PassEvalConfig& config,
+    const GameBehavior& behavior,
+    uint64_t sample,
+    ScoreTable& table) -> void
+{
+    const auto sampleRng = math::RandomGenerator::forStream(config.seed, sample);
+    const auto deal = Deal{hand, sampleRng};
+    auto othersPasses = std::array<CardSet, kNumPlayers>{};
+    for (auto p : prim::range(1u, kNumPlayers))
+        othersPasses[p] = randomPass(deal.dealFor(p), sampleRng);
+
+    // Every pass starts its playout from a copy of this generator: the common random numbers.
+    const auto playoutRng = math::RandomGenerator{sampleRng.random64()};
+    for (auto i : prim::range(passes.size()))
+    {
+        if (!table.active(i))
+            continue;
+
+        auto rng = playoutRng;
+        GState state{deal, config.passOffset, behavior, rng};
+        state.setPassFor(0, passes[i]);
+        for (auto p : prim::range(1u, kNumPlayers))
+            state.setPassFor(p, othersPasses[p]);
+        state.startGame();
+        playout(state, config.policy, rng);
+        table.score(sample, i) = state.outcome().scores[0];
+    }
+}
+
+auto runBatch(CardSet hand,
+    const std::vector<CardSet>& passes,
+    const PassEvalConfig& config,
+    unsigned numWorkers,
+    uint64_t begin,
+    uint64_t end,
+    ScoreTable& table) -> void
+{
+    const auto behavior = GameBehavior::make(config.variant);
+    auto errors = std::vector<std::exception_ptr>(numWorkers);
+    auto threads = std::vector<std::thread>{};
+    for (auto w : prim::range(numWorkers))
+    {
+        threads.emplace_back([&, w]() {
+            try
+            {
+                for (auto sample = begin + w; sample < end; sample += numWorkers)
+                    evaluateSample(hand, passes, config, behavior, sample, table);
+            }
+            catch (...)
+            {
+                errors[w] = std::current_exception();
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+    for (auto& error : errors)
+    {
+        if (error)
+            std::rethrow_exception(error);
+    }
+    table.finishBatch(end);
+}
+
+auto prune(ScoreTable& table, double z) -> void
+{
+    const auto leader = table.leader();
+    for (auto i : prim::range(table.numPasses()))
+    {
+        if (i == leader || !table.active(i))
+            continue;
+        const auto delta = table.deltaStats(i, leader);
+        if (delta.mean() - halfWidth(delta, z) > 0.0)
+            table.deactivate(i);
+    }
+}
+} // namespace
+
+auto evaluatePasses(CardSet hand, const PassEvalConfig& config) -> std::vector<PassValue>
+{
+    if (hand.size() != kCardsPerHand)
+        throw std::invalid_argument(fmt::format("A hand must have {} cards, not {}", kCardsPerHand, hand.size()));
+    if (config.passOffset == 0 || config.passOffset >= kNumPlayers)
+        throw std::invalid_argument(fmt::format("Pass offset {} is not a passing hand", config.passOffset));
+    if (config.samples == 0)
+        throw std::invalid_argument("PassEvalConfig.samples must be positive");
+
+    const auto passes = candidatesFor(hand, config);
+    const auto numWorkers = config.threads > 0 ? config.threads : std::max(1u, std::thread::hardware_concurrency());
+    const auto batch = config.pruneBatch > 0 ? config.pruneBatch : config.samples;
+    dlog("{} passes on {} samples, {} workers", passes.size(), config.samples, numWorkers);
+
+    auto table = ScoreTable{passes.size(), config.samples};
+    for (uint64_t begin = 0; begin < config.samples; begin += batch)
+    {
+        const auto end = std::min(begin + batch, config.samples);
+        runBatch(hand, passes, config, numWorkers, begin, end, table);
+        if (config.pruneBatch > 0 && end < config.samples)
+            prune(table, config.z);
+    }
+
+    const auto best = table.leader();
+    auto result = std::vector<PassValue>{};
+    result.reserve(passes.size());
+    for (auto i : prim::range(passes.size()))
+    {
+        const auto mean = table.meanStats(i);
+        const auto delta = table.deltaStats(i, best);
+        result.push_back(PassValue{
+            .pass = passes[i],
+            .samples = table.samples(i),
+            .mean = mean.mean(),
+            .halfWidth = halfWidth(mean, config.z),
+            .delta = delta.mean(),
+            .deltaHalfWidth = i == best ? 0.0 : halfWidth(delta, config.z),
+        });
+    }
+    // A pruned pass's delta is over its early samples only, where the final best pass may have done poorly, so it can
+    // be negative: the passes played out on every sample rank first.
+    std::stable_sort(result.begin(), result.end(), [&](const PassValue& a, const PassValue& b) {
+        const auto aPruned = a.samples < config.samples;
+        const auto bPruned = b.samples < config.samples;
+        return aPruned != bPruned ? bPruned : a.delta < b.delta;
+    });
+    return result;
+}
+
+} // namespace pho::selfplay
@@ -0,0 +1,169 @@
+#include "selfplay/PassTable.hpp"
+#include "cards/Deal.hpp"
+#include "gstate/SuitSymmetry.hpp"
+#include "prim/dlog.hpp"
+#include "prim/hash.hpp"
+#include "prim/range.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fmt/format.h>
+#include <stdexcept>
+
+namespace pho::selfplay {
+
+using namespace pho::gstate;
+
+namespace {
+DLog dlog("passtable");
+
+constexpr unsigned kCardsPassed = 3;
+
+auto readHeader(const prim::MappedFile& file) -> PassTableHeader
+{
+    const auto& header = file.header<PassTableHeader>("a pass table");
+    if (header.entrySize != sizeof(PassTableEntry))
+        throw std::runtime_error(fmt::format("Pass table {} has an unsupported layout: entries of {} bytes, not {}",
+            file.path(), header.entrySize, sizeof(PassTableEntry)));
+    file.expectSize(sizeof(PassTableHeader) + header.count * sizeof(PassTableEntry));
+    return header;
+}
+} // namespace
+
+PassTable::PassTable(const std::string& path, bool verifyChecksum)
+: mFile{path, prim::MappedFile::eRandom} // each lookup touches about log2(count) entries spread over the file
+, mHeader{readHeader(mFile)}
+, mEntries{reinterpret_cast<const PassTableEntry*>(mFile.data() + sizeof(PassTableHeader))}
+{
+    if (verifyChecksum && prim::hash64(mEntries, mHeader.count * sizeof(PassTableEntry)) != mHeader.checksum)
+        throw std::runtime_error(fmt::format("Pass table {} failed checksum", path));
+}
+
+auto PassTable::keyOf(CardSet canonicalHand, PassOffset offset) -> uint64_t
+{
+    assert(canonicalHand.size() == kCardsPerHand);
+    assert(offset > 0 && offset < kNumPlayers);
+    return rankSubset(canonicalHand, CardSet::fullDeck()) << 2 | offset;
+}
+
+auto PassTable::find(CardSet hand, PassOffset offset) const -> const PassTableEntry*
+{
+    return findKey(keyOf(canonicalHand(hand, variant()).hand, offset));
+}
+
+auto PassTable::findKey(uint64_t key) const -> const PassTableEntry*
+{
+    const auto* end = mEntries + mHeader.count;
+    const auto* it = std::lower_bound(
+        mEntries, end, key, [](const PassTableEntry& entry, uint64_t k) { return entry.key < k; });
+    return it != end && it->key == key ? it : nullptr;
+}
+
+auto PassTable::bestPass(CardSet hand, PassOffset offset) const -> std::optional<CardSet>
+{
+    const auto candidates = choices(hand, offset);
+    if (candidates.empty())
+        return std::nullopt;
+    return candidates.front().pass;
+}
+
+auto PassTable::choices(CardSet hand, PassOffset offset) const -> std::vector<PassChoice>
+{
+    auto result = std::vector<PassChoice>{};
+    const auto canonical = canonicalHand(hand, variant());
+    const auto* entry = findKey(keyOf(canonical.hand, offset));
+    if (entry == nullptr)
+        return result;
+
+    const auto toHand = canonical.permutation.inverse();
+    for (auto i : prim::range(PassTableEntry::kTopPasses))
+    {
+        if (entry->passes[i] == PassTableEntry::kNoPass)
+            break;
+        const auto pass = unrankSubset(entry->passes[i], kCardsPassed, canonical.hand);
+        result.push_back(PassChoice{toHand(pass), entry->scores[i]});
+    }
+    return result;
+}
+
+PassTableWriter::PassTableWriter(GameVariant variant, uint64_t samples, uint64_t seed)
+: mVariant{variant}
+, mSamples{samples}
+, mSeed{seed}
+, mEntries{}
+{ }
+
+auto PassTableWriter::has(CardSet hand, PassOffset offset) const -> bool
+{
+    return mEntries.count(PassTable::keyOf(canonicalHand(hand, mVariant).hand, offset)) != 0;
+}
+
+auto PassTableWriter::add(CardSet hand, PassOffset offset, const std::vector<PassValue>& ranked) -> void
+{
+    const auto canonical = canonicalHand(hand, mVariant);
+    auto entry = PassTableEntry{};
+    entry.key = PassTable::keyOf(canonical.hand, offset);
+    entry.passes.fill(PassTableEntry::kNoPass);
+    entry.scores.fill(0.0f);
+    for (auto i : prim::range(std::min<size_t>(PassTableEntry::kTopPasses, ranked.size())))
+    {
+        const auto pass = canonical.permutation(ranked[i].pass);
+        entry.passes[i] = uint16_t(rankSubset(pass, canonical.hand));
+        entry.scores[i] = float(ranked[i].mean);
+    }
+    mEntries[entry.key] = entry;
+}
+
+auto PassTableWriter::write(const std::string& path) const -> void
+{
+    auto entries = std::vector<PassTableEntry>{};
+    entries.reserve(mEntries.size());
+    for (const auto& [key, entry] : mEntries)
+        entries.push_back(entry);
+
+    auto header = PassTableHeader{};
+    std::memcpy(header.magic, PassTableHeader::kMagic, sizeof(header.magic));
+    header.version = PassTableHeader::kVersion;
+    header.headerSize = sizeof(PassTableHeader);
+    header.entrySize = sizeof(PassTableEntry);
+    header.variant = uint32_t(mVariant);
+    header.count = entries.size();
+    header.samples = mSamples;
+    header.seed = mSeed;
+    header.checksum = prim::hash64(entries.data(), entries.size() * sizeof(PassTableEntry));
+
+    auto file = prim::AtomicFileWriter{path};
+    file.write(&header, sizeof(header));
+    file.write(entries.data(), entries.size() * sizeof(PassTableEntry));
+    file.commit();
+}
+
+auto buildPassTable(const PassTableConfig& config) -> uint64_t
+{
+    if (!config.eval.candidates.empty())
+        throw std::invalid_argument("A pass table evaluates every pass, so eval.candidates must be empty");
+
+    auto writer = PassTableWriter{config.eval.variant, config.eval.samples, config.eval.seed};
+    for (auto offset : config.offsets)
+    {
+        auto eval = config.eval;
+        eval.passOffset = offset;
+        auto added = uint64_t{};
+        for (uint64_t draw = 0; added < config.hands; ++draw)
+        {
+            // Hands come from their own streams, beyond those the evaluations use for their samples.
+            const auto rng = math::RandomGenerator::forStream(config.eval.seed, ~draw);
+            const auto hand = Deal{Deal::randomDealIndex(rng)}.dealFor(0);
+            if (writer.has(hand, offset))
+                continue;
+            eval.seed = prim::mix64(config.eval.seed ^ prim::mix64(draw));
+            writer.add(hand, offset, evaluatePasses(hand, eval));
+            ++added;
+            dlog("offset {} hand {}: {}", offset, added, to_string(hand));
+        }
+    }
+    writer.write(config.path);
+    return writer.size();
+}
+
+} // namespace pho::selfplay
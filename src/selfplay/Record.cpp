@@ -0,0 +1,91 @@
+#include "selfplay/Record.hpp"
+#include "math/Bits.hpp"
+
+#include <cassert>
+#include <cstring>
+
+namespace pho::selfplay {
+
+namespace {
+constexpr size_t kMaskSize = sizeof(uint64_t);
+constexpr size_t kScaleSize = sizeof(ColumnPlan::suitScale);
+
+template <typename T>
+auto put(std::byte*& out, const T& value) -> void
+{
+    std::memcpy(out, &value, sizeof(T));
+    out += sizeof(T);
+}
+
+template <typename T>
+auto get(const std::byte*& in, T& value) -> void
+{
+    std::memcpy(&value, in, sizeof(T));
+    in += sizeof(T);
+}
+} // namespace
+
+RecordLayout::RecordLayout(unsigned width, uint64_t scaledColumns)
+: mWidth{width}
+, mScaledColumns{scaledColumns}
+, mRecordSize{sizeof(RecordHead) + width * kMaskSize + math::countBits(scaledColumns) * (kMaskSize + kScaleSize)}
+{
+    assert(width > 0 && width <= kMaxColumns);
+    assert(width == kMaxColumns || (scaledColumns >> width) == 0);
+}
+
+auto RecordLayout::pack(const RecordHead& head, const ColumnPlan* plan, std::byte* out) const -> void
+{
+    [[maybe_unused]] const auto* start = out;
+    put(out, head);
+    for (unsigned col = 0; col < mWidth; ++col)
+        put(out, plan[col].ones);
+    for (unsigned col = 0; col < mWidth; ++col)
+    {
+        if (isScaled(col))
+        {
+            put(out, plan[col].scaled);
+            put(out, plan[col].suitScale);
+        }
+        else
+        {
+            assert(plan[col].scaled == 0);
+        }
+    }
+    assert(size_t(out - start) == mRecordSize);
+}
+
+auto RecordLayout::unpack(const std::byte* in, RecordHead& head, float* tensor) const -> void
+{
+    ColumnPlan plan[kMaxColumns];
+
+    get(in, head);
+    for (unsigned col = 0; col < mWidth; ++col)
+    {
+        get(in, plan[col].ones);
+        plan[col].scaled = 0;
+        plan[col].suitScale = {};
+    }
+    for (unsigned col = 0; col < mWidth; ++col)
+    {
+        if (isScaled(col))
+        {
+            get(in, plan[col].scaled);
+            get(in, plan[col].suitScale);
+        }
+    }
+
+    // This is the same fused loop as tensor::Schema::expand(), with the width known only at runtime.
+    for (unsigned c = 0; c < cards::kCardsPerDeck; ++c)
+    {
+        const auto suit = c / cards::kCardsPerSuit;
+        float* row = tensor + c * mWidth;
+        for (unsigned col = 0; col < mWidth; ++col)
+        {
+            const auto& column = plan[col];
+            row[col] = float((column.ones >> c) & 1u) + float((column.scaled >> c) & 1u) * column.suitScale[suit];
+        }
+    }
+}
+
+} // namespace pho::selfplay
@@ -0,0 +1,156 @@
+#include "selfplay/SelfPlay.hpp"
+#include "gstate/GState.hpp"
+#include "prim/dlog.hpp"
+#include "prim/range.hpp"
+#include "selfplay/Shard.hpp"
+
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <fmt/format.h>
+#include <stdexcept>
+#include <thread>
+
+namespace pho::selfplay {
+
+using namespace pho::gstate;
+
+namespace {
+DLog dlog("selfplay");
+
+struct WorkerResult
+{
+    uint64_t games{};
+    uint64_t records{};
+    std::vector<std::string> shards;
+    std::exception_ptr error;
+};
+
+class Worker
+{
+public:
+    Worker(const SelfPlayConfig& config, unsigned index, unsigned numWorkers)
+    : mConfig{config}
+    , mIndex{index}
+    , mNumWorkers{numWorkers}
+    , mBehavior{GameBehavior::make(config.variant)}
+    , mPolicies{config.policies.size() == 1 ? std::vector<Policy>(kNumPlayers, config.policies.front())
+                                            : config.policies}
+    , mLayout{RecordLayout::of<Schema>()}
+    , mWriter{fmt::format("{}-w{:03}", config.outputPrefix, index), mLayout, config.recordsPerShard}
+    , mGameRecords(kCardsPerDeck * mLayout.recordSize())
+    { }
+
+    auto run() -> WorkerResult
+    {
+        auto result = WorkerResult{};
+        for (uint64_t game = mIndex; game < mConfig.games; game += mNumWorkers)
+        {
+            playOneGame(game);
+            ++result.games;
+        }
+        mWriter.close();
+        result.records = mWriter.recordsWritten();
+        result.shards = mWriter.paths();
+        return result;
+    }
+
+private:
+    auto playOneGame(uint64_t game) -> void
+    {
+        // Every random choice of the game comes from its own stream, so the game does not depend on which worker
+        // plays it.
+        const auto rng = math::RandomGenerator::forStream(mConfig.seed, game);
+        const auto dealIndex = Deal::randomDealIndex(rng);
+        const auto passOffset = mConfig.passing ? PassOffset(rng.range64(kNumPlayers)) : PassOffset{0};
+
+        GState state{GState::Init{dealIndex, passOffset}, mBehavior, rng};
+        if (passOffset != 0)
+        {
+            for (auto p : prim::range(kNumPlayers))
+                state.setPassFor(p, randomPass(state.playersHand(p), rng));
+        }
+        state.startGame();
+
+        const auto recordSize = mLayout.recordSize();
+        while (!state.done())
+        {
+            const auto player = state.currentPlayer();
+            const auto plan = Schema::plan(state);
+            const auto card = mPolicies.at(player)(state, rng);
+
+            auto head = RecordHead{};
+            head.legal = state.legalPlays().asBits();
+            head.chosen = card.ord();
+            head.player = uint8_t(player);
+            head.playIndex = uint8_t(state.playIndex());
+            mLayout.pack(head, plan.data(), mGameRecords.data() + state.playIndex() * recordSize);
+
+            state.playCard(card);
+        }
+
+        // The scores are only known now, so we patch them into each record before writing it.
+        const auto scores = state.getPlayerScores();
+        for (auto i : prim::range(kCardsPerDeck))
+        {
+            auto* record = mGameRecords.data() + i * recordSize;
+            auto head = RecordHead{};
+            std::memcpy(&head, record, sizeof(head));
+            for (auto pMain : prim::range(kNumPlayers))
+                head.scores[pMain] = scores[(head.player + pMain) % kNumPlayers];
+            std::memcpy(record, &head, sizeof(head));
+            mWriter.append(record);
+        }
+    }
+
+    const SelfPlayConfig& mConfig;
+    const unsigned mIndex;
+    const unsigned mNumWorkers;
+    GameBehavior mBehavior;
+    std::vector<Policy> mPolicies;
+    RecordLayout mLayout;
+    ShardWriter mWriter;
+    std::vector<std::byte> mGameRecords;
+};
+} // namespace
+
+auto runSelfPlay(const SelfPlayConfig& config) -> SelfPlayStats
+{
+    if (config.policies.size() != 1 && config.policies.size() != kNumPlayers)
+        throw std::invalid_argument("SelfPlayConfig.policies must have one or four policies");
+
+    const auto numWorkers = config.threads > 0 ? config.threads : std::max(1u, std::thread::hardware_concurrency());
+    dlog("{} games on {} workers", config.games, numWorkers);
+
+    auto results = std::vector<WorkerResult>(numWorkers);
+    auto threads = std::vector<std::thread>{};
+    for (auto w : prim::range(numWorkers))
+    {
+        threads.emplace_back([&config, &results, w, numWorkers]() {
+            try
+            {
+                auto worker = Worker{config, w, numWorkers};
+                results[w] = worker.run();
+            }
+            catch (...)
+            {
+                results[w].error = std::current_exception();
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    auto stats = SelfPlayStats{};
+    for (auto& result : results)
+    {
+        if (result.error)
+            std::rethrow_exception(result.error);
+        stats.games += result.games;
+        stats.records += result.records;
+        stats.shards.insert(stats.shards.end(), result.shards.begin(), result.shards.end());
+    }
+    return stats;
+}
+
+} // namespace pho::selfplay
@@ -0,0 +1,132 @@
+#include "selfplay/Shard.hpp"
+#include "prim/hash.hpp"
+
+#include <cstring>
+#include <fmt/format.h>
+#include <stdexcept>
+
+namespace pho::selfplay {
+
+namespace {
+constexpr size_t kWriteBufferSize = size_t{1} << 20;
+
+auto makeHeader(const RecordLayout& layout, uint64_t capacity) -> ShardHeader
+{
+    auto header = ShardHeader{};
+    std::memcpy(header.magic, ShardHeader::kMagic, sizeof(header.magic));
+    header.version = ShardHeader::kVersion;
+    header.headerSize = sizeof(ShardHeader);
+    header.recordSize = uint32_t(layout.recordSize());
+    header.width = layout.width();
+    header.scaledColumns = layout.scaledColumns();
+    header.capacity = capacity;
+    return header;
+}
+} // namespace
+
+auto checksumRecord(uint64_t checksum, const std::byte* record, size_t recordSize) -> uint64_t
+{
+    return prim::hash64(record, recordSize, checksum);
+}
+
+auto readShardHeader(const prim::MappedFile& file, bool verifyChecksum) -> ShardHeader
+{
+    const auto& header = file.header<ShardHeader>("a shard");
+    if (!header.sealed)
+        throw std::runtime_error(fmt::format("Shard {} was not sealed", file.path()));
+    if (header.recordSize != header.layout().recordSize())
+        throw std::runtime_error(fmt::format("Shard {} has an inconsistent record size", file.path()));
+    file.expectSize(sizeof(ShardHeader) + header.count * header.recordSize);
+
+    if (verifyChecksum)
+    {
+        const auto* record = file.data() + sizeof(ShardHeader);
+        auto checksum = uint64_t{};
+        for (uint64_t i = 0; i < header.count; ++i, record += header.recordSize)
+            checksum = checksumRecord(checksum, record, header.recordSize);
+        if (checksum != header.checksum)
+            throw std::runtime_error(fmt::format("Shard {} failed checksum", file.path()));
+    }
+
+    return header;
+}
+
+auto readShardHeader(const std::string& path, bool verifyChecksum) -> ShardHeader
+{
+    return readShardHeader(prim::MappedFile{path, prim::MappedFile::eSequential}, verifyChecksum);
+}
+
+ShardWriter::ShardWriter(std::string prefix, RecordLayout layout, uint64_t recordsPerShard)
+: mPrefix{std::move(prefix)}
+, mLayout{layout}
+, mCapacity{recordsPerShard}
+, mFile{nullptr}
+, mHeader{}
+, mRecordsWritten{}
+, mPaths{}
+{
+    if (recordsPerShard == 0)
+        throw std::invalid_argument("recordsPerShard must be positive");
+}
+
+ShardWriter::~ShardWriter()
+{
+    try
+    {
+        close();
+    }
+    catch (const std::exception& e)
+    {
+        fmt::print(stderr, "{}\n", e.what());
+    }
+}
+
+auto ShardWriter::open() -> void
+{
+    assert(mFile == nullptr);
+    auto path = fmt::format("{}-{:06}.shard", mPrefix, mPaths.size());
+    mFile = std::fopen(path.c_str(), "wb");
+    if (mFile == nullptr)
+        throw std::runtime_error(fmt::format("Cannot create shard {}", path));
+    std::setvbuf(mFile, nullptr, _IOFBF, kWriteBufferSize);
+
+    mHeader = makeHeader(mLayout, mCapacity);
+    std::fwrite(&mHeader, sizeof(mHeader), 1, mFile);
+    mPaths.push_back(std::move(path));
+}
+
+auto ShardWriter::seal() -> void
+{
+    assert(mFile != nullptr);
+    mHeader.sealed = 1;
+    std::fseek(mFile, 0, SEEK_SET);
+    std::fwrite(&mHeader, sizeof(mHeader), 1, mFile);
+    const auto failed = std::ferror(mFile) != 0;
+    std::fclose(mFile);
+    mFile = nullptr;
+    if (failed)
+        throw std::runtime_error(fmt::format("Failed writing shard {}", mPaths.back()));
+}
+
+auto ShardWriter::append(const std::byte* record) -> void
+{
+    if (mFile == nullptr)
+        open();
+
+    const auto size = mLayout.recordSize();
+    std::fwrite(record, size, 1, mFile);
+    mHeader.checksum = checksumRecord(mHeader.checksum, record, size);
+    ++mHeader.count;
+    ++mRecordsWritten;
+
+    if (mHeader.count == mCapacity)
+        seal();
+}
+
+auto ShardWriter::close() -> void
+{
+    if (mFile != nullptr)
+        seal();
+}
+
+} // namespace pho::selfplay
@@ -0,0 +1,356 @@
+#include "selfplay/Tournament.hpp"
+#include "cards/Deal.hpp"
+#include "gstate/GState.hpp"
+#include "gstate/Policy.hpp"
+#include "prim/MappedFile.hpp"
+#include "prim/ThreadPool.hpp"
+#include "prim/dlog.hpp"
+#include "prim/hash.hpp"
+#include "prim/range.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fmt/format.h>
+#include <stdexcept>
+
+namespace pho::selfplay {
+
+using namespace pho::gstate;
+
+namespace {
+DLog dlog("tournament");
+
+// A checkpoint is a 64-byte header followed by one entry per pairing, in the order of TournamentResult::pairings.
+struct CheckpointHeader
+{
+    static constexpr char kMagic[8] = {'P', 'H', 'O', 'T', 'O', 'U', 'R', 'N'};
+    static constexpr uint32_t kVersion = 2;
+
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t entrySize;
+    uint32_t count; // the number of pairings
+    uint64_t fingerprint; // of the configuration the results belong to, see fingerprintOf()
+    uint64_t deals; // the deals played by every pairing
+    uint64_t checksum; // prim::hash64 of the entries
+    uint64_t reserved[2];
+};
+static_assert(sizeof(CheckpointHeader) == 64);
+
+struct CheckpointEntry
+{
+    double winPts;
+    double zms;
+    uint64_t count;
+    uint32_t scoreType;
+    uint32_t decision;
+    uint64_t decidedAt;
+    stats::RunningStats::Moments duplicate;
+    stats::RunningStats::Moments duplicateElo;
+};
+static_assert(sizeof(CheckpointEntry) == 152);
+
+// Everything that decides the games a pairing plays and when the run stops, except the number of deals.
+auto fingerprintOf(const TournamentConfig& config) -> uint64_t
+{
+    auto text = fmt::format("{}|{}|{}|{}", config.seed, int(config.variant), config.passing, int(config.mode));
+    for (const auto& agent : config.agents)
+        text += "|" + agent;
+    if (config.sprt)
+        text += fmt::format("|sprt {} {} {} {} {}", config.sprt->elo0, config.sprt->elo1, config.sprt->alpha,
+            config.sprt->beta, config.batch);
+    return prim::hash64(text.data(), text.size());
+}
+
+// Load the checkpoint into the pairings, returning the deals it holds, or zero when there is no checkpoint yet.
+auto loadCheckpoint(const std::string& path, uint64_t fingerprint, std::vector<Pairing>& pairings) -> uint64_t
+{
+    if (!std::filesystem::exists(path))
+        return 0;
+
+    const auto file = prim::MappedFile{path};
+    const auto& header = file.header<CheckpointHeader>("a tournament checkpoint");
+    if (header.entrySize != sizeof(CheckpointEntry))
+        throw std::runtime_error(fmt::format("Checkpoint {} has an unsupported version or layout", path));
+    if (header.fingerprint != fingerprint || header.count != pairings.size())
+        throw std::runtime_error(fmt::format("Checkpoint {} belongs to a different tournament", path));
+    file.expectSize(sizeof(CheckpointHeader) + pairings.size() * sizeof(CheckpointEntry));
+    const auto* entries = reinterpret_cast<const CheckpointEntry*>(file.data() + sizeof(CheckpointHeader));
+    if (prim::hash64(entries, pairings.size() * sizeof(CheckpointEntry)) != header.checksum)
+        throw std::runtime_error(fmt::format("Checkpoint {} is corrupt", path));
+
+    for (auto i : prim::range(pairings.size()))
+    {
+        const auto& entry = entries[i];
+        pairings[i].score = ScoreResult::fromTotals(
+            ScoreResult::Totals{entry.winPts, entry.zms, entry.count, ScoreResult::ScoreType(entry.scoreType)});
+        pairings[i].duplicate = stats::RunningStats{entry.duplicate};
+        pairings[i].duplicateElo = stats::RunningStats{entry.duplicateElo};
+        pairings[i].decision = Sprt::Decision(entry.decision);
+        pairings[i].decidedAt = entry.decidedAt;
+    }
+    return header.deals;
+}
+
+auto saveCheckpoint(const std::string& path, uint64_t fingerprint, uint64_t deals, const std::vector<Pairing>& pairings)
+    -> void
+{
+    auto entries = std::vector<CheckpointEntry>(pairings.size());
+    for (auto i : prim::range(pairings.size()))
+    {
+        const auto totals = pairings[i].score.totals();
+        auto& entry = entries[i];
+        entry.winPts = totals.winPts;
+        entry.zms = totals.zms;
+        entry.count = totals.count;
+        entry.scoreType = uint32_t(totals.scoreType);
+        entry.decision = uint32_t(pairings[i].decision);
+        entry.decidedAt = pairings[i].decidedAt;
+        entry.duplicate = pairings[i].duplicate.moments();
+        entry.duplicateElo = pairings[i].duplicateElo.moments();
+    }
+
+    auto header = CheckpointHeader{};
+    std::memcpy(header.magic, CheckpointHeader::kMagic, sizeof(header.magic));
+    header.version = CheckpointHeader::kVersion;
+    header.headerSize = sizeof(CheckpointHeader);
+    header.entrySize = sizeof(CheckpointEntry);
+    header.count = uint32_t(entries.size());
+    header.fingerprint = fingerprint;
+    header.deals = deals;
+    header.checksum = prim::hash64(entries.data(), entries.size() * sizeof(CheckpointEntry));
+
+    auto file = prim::AtomicFileWriter{path};
+    file.write(&header, sizeof(header));
+    file.write(entries.data(), entries.size() * sizeof(CheckpointEntry));
+    file.commit();
+}
+
+// The seatings of a pairing: for each distinct rotation, whether the hero sits in each seat.
+using Seating = std::array<bool, kNumPlayers>;
+
+auto seatingsFor(ScoreResult::ScoreType mode) -> std::vector<Seating>
+{
+    if (mode == ScoreResult::eSolo)
+        return {{true, false, false, false}, {false, true, false, false}, {false, false, true, false},
+            {false, false, false, true}};
+    return {{true, false, true, false}, {false, true, false, true}};
+}
+
+auto heroSeat(const Seating& seating) -> unsigned
+{
+    return unsigned(std::find(seating.begin(), seating.end(), true) - seating.begin());
+}
+
+class Player
+{
+public:
+    Player(const TournamentConfig& config, const std::vector<Pairing>& pairings)
+    : mConfig{config}
+    , mPairings{pairings}
+    , mBehavior{GameBehavior::make(config.variant)}
+    , mSeatings{seatingsFor(config.mode)}
+    {
+        for (const auto& agent : config.agents)
+            mPolicies.push_back(policies::named(agent));
+    }
+
+    // Play the deal in every pairing, storing each pairing's result for the deal in results[pairing].
+    auto playDeal(uint64_t deal, ScoreResult* results) const -> void
+    {
+        auto rng = math::RandomGenerator::forStream(mConfig.seed, deal);
+        const auto dealIndex = Deal::randomDealIndex(rng);
+        const auto passOffset = mConfig.passing ? PassOffset(rng.range64(kNumPlayers)) : PassOffset{0};
+
+        GState start{GState::Init{dealIndex, passOffset}, mBehavior, rng};
+        if (passOffset != 0)
+        {
+            for (auto p : prim::range(kNumPlayers))
+                start.setPassFor(p, randomPass(start.playersHand(p), rng));
+        }
+        start.startGame();
+
+        for (auto i : prim::range(mPairings.size()))
+        {
+            const auto& pairing = mPairings[i];
+            for (const auto& seating : mSeatings)
+            {
+                auto seats = std::array<const Policy*, kNumPlayers>{};
+                for (auto p : prim::range(kNumPlayers))
+                    seats[p] = &mPolicies[seating[p] ? pairing.hero : pairing.opponent];
+
+                auto state = start;
+                while (!state.outcomeDecided())
+                    state.playCard((*seats[state.currentPlayer()])(state, rng));
+                state.fastForward();
+
+                if (mConfig.mode == ScoreResult::eSolo)
+                    results[i].soloUpdate(state, heroSeat(seating));
+                else
+                    results[i].teamUpdate(state, seating[0] ? 0 : 1, seating[0] ? 2 : 3);
+            }
+        }
+    }
+
+private:
+    const TournamentConfig& mConfig;
+    const std::vector<Pairing>& mPairings;
+    GameBehavior mBehavior;
+    std::vector<Seating> mSeatings;
+    std::vector<Policy> mPolicies;
+};
+} // namespace
+
+auto Pairing::eloInterval() const -> std::pair<double, double>
+{
+    return eloConfidenceSequence(duplicateElo, 0.05);
+}
+
+auto TournamentResult::agentScore(unsigned agent) const -> ScoreResult
+{
+    auto result = ScoreResult{};
+    for (const auto& pairing : pairings)
+    {
+        if (pairing.hero == agent)
+            result += pairing.score;
+    }
+    return result;
+}
+
+auto runTournament(const TournamentConfig& config) -> TournamentResult
+{
+    if (config.agents.size() < 2)
+        throw std::invalid_argument("A tournament needs at least two agents");
+    if (config.mode != ScoreResult::eSolo && config.mode != ScoreResult::eTeam)
+        throw std::invalid_argument("The tournament mode must be solo or team");
+    if (config.batch == 0)
+        throw std::invalid_argument("TournamentConfig.batch must be positive");
+
+    // Throws for bad hypotheses before any deal is played.
+    const auto sprt = config.sprt ? std::optional<Sprt>{Sprt{*config.sprt}} : std::nullopt;
+
+    auto result = TournamentResult{config.agents, config.mode, {}, 0, 0, config.sprt, false};
+    for (auto hero : prim::range(unsigned(config.agents.size())))
+    {
+        for (auto opponent : prim::range(unsigned(config.agents.size())))
+        {
+            if (opponent != hero && (config.mode == ScoreResult::eSolo || hero < opponent))
+                result.pairings.push_back(Pairing{hero, opponent, {}, {}, {}, Sprt::eContinue, 0});
+        }
+    }
+    const auto player = Player{config, result.pairings};
+
+    const auto fingerprint = fingerprintOf(config);
+    if (!config.checkpoint.empty())
+        result.resumedFrom = loadCheckpoint(config.checkpoint, fingerprint, result.pairings);
+    result.deals = result.resumedFrom;
+
+    auto pool = prim::ThreadPool{config.threads};
+    dlog("{} pairings, deals {} to {} on {} workers", result.pairings.size(), result.deals, config.deals, pool.size());
+
+    const auto count = result.pairings.size();
+    const auto decided = [&] {
+        return sprt && std::all_of(result.pairings.begin(), result.pairings.end(),
+                   [](const Pairing& pairing) { return pairing.decision != Sprt::eContinue; });
+    };
+    while (result.deals < config.deals && !decided())
+    {
+        const auto first = result.deals;
+        // Batches end on multiples of the batch size, wherever the run was resumed, so the SPRT sees the same
+        // samples at every check.
+        const auto last = std::min(config.deals, (first / config.batch + 1) * config.batch);
+
+        // The deals of a batch are played in parallel, then added in order, so the totals are the same however the
+        // work was divided.
+        auto results = std::vector<ScoreResult>((last - first) * count);
+        pool.parallelFor(first, last, 1, [&](size_t deal) { player.playDeal(deal, &results[(deal - first) * count]); });
+        for (auto deal : prim::range(last - first))
+        {
+            for (auto i : prim::range(count))
+            {
+                const auto& dealResult = results[deal * count + i];
+                result.pairings[i].score += dealResult;
+                result.pairings[i].duplicate.accumulate(dealResult.scoreDelta());
+                result.pairings[i].duplicateElo.accumulate(dealResult.eloScore());
+            }
+        }
+        result.deals = last;
+
+        // The SPRT is checked once a batch, which only makes it slightly more conservative.
+        if (sprt && result.deals % config.batch == 0)
+        {
+            for (auto& pairing : result.pairings)
+            {
+                if (pairing.decision == Sprt::eContinue)
+                {
+                    pairing.decision = sprt->decide(pairing.duplicateElo);
+                    pairing.decidedAt = pairing.decision == Sprt::eContinue ? 0 : result.deals;
+                }
+            }
+        }
+
+        if (!config.checkpoint.empty())
+            saveCheckpoint(config.checkpoint, fingerprint, result.deals, result.pairings);
+    }
+    result.stoppedEarly = result.deals < config.deals;
+    if (result.stoppedEarly)
+        dlog("every pairing decided after {} deals", result.deals);
+    return result;
+}
+
+auto formatSummary(const TournamentResult& result) -> std::string
+{
+    const auto rotations = seatingsFor(result.mode).size();
+    auto text = fmt::format("{} tournament of {} deals{}, each played in {} rotations\n\n",
+        result.mode == ScoreResult::eSolo ? "Solo" : "Team", result.deals,
+        result.stoppedEarly ? " (stopped early by the SPRT)" : "", rotations);
+
+    const auto row = [](const std::string& name, const ScoreResult& score, const std::string& interval) {
+        return fmt::format("{:<24} {:>10} {:>8.4f} {:>9.4f} {:>8} {:>8.1f}\n", name, score.count(),
+            score.winFraction(), score.scoreDelta(), interval, score.eloDelta());
+    };
+    const auto columns = fmt::format(
+        "{:<24} {:>10} {:>8} {:>9} {:>8} {:>8}\n", "", "hands", "win", "zms", "+-95%", "elo");
+
+    text += columns;
+    for (const auto& pairing : result.pairings)
+    {
+        const auto& duplicate = pairing.duplicate;
+        const auto interval = duplicate.size() > 1
+            ? fmt::format("{:.4f}", 1.96 * duplicate.stddev() / std::sqrt(double(duplicate.size())))
+            : std::string{};
+        text += row(fmt::format("{} vs {}", result.agents[pairing.hero], result.agents[pairing.opponent]),
+            pairing.score, interval);
+    }
+
+    if (result.sprt)
+    {
+        const auto sprt = Sprt{*result.sprt};
+        text += fmt::format("\nSPRT of elo {} (H0) against {} (H1), alpha {} beta {}: llr bounds [{:.2f}, {:.2f}]\n",
+            result.sprt->elo0, result.sprt->elo1, result.sprt->alpha, result.sprt->beta, sprt.lowerBound(),
+            sprt.upperBound());
+        text += fmt::format("{:<24} {:>8} {:>8} {:>10} {:>18}\n", "", "llr", "decision", "at deal", "elo 95% cs");
+        for (const auto& pairing : result.pairings)
+        {
+            const auto [low, high] = pairing.eloInterval();
+            text += fmt::format("{:<24} {:>8.2f} {:>8} {:>10} {:>18}\n",
+                fmt::format("{} vs {}", result.agents[pairing.hero], result.agents[pairing.opponent]),
+                sprt.llr(pairing.duplicateElo), toString(pairing.decision),
+                pairing.decidedAt == 0 ? std::string{} : std::to_string(pairing.decidedAt),
+                fmt::format("[{:.1f}, {:.1f}]", low, high));
+        }
+    }
+
+    text += "\n" + columns;
+    for (auto agent : prim::range(unsigned(result.agents.size())))
+    {
+        if (result.agentScore(agent).count() > 0)
+            text += row(result.agents[agent], result.agentScore(agent), "");
+    }
+    return text;
+}
+
+} // namespace pho::selfplay
@@ -0,0 +1,141 @@
+#pragma once
+
+#include "prim/BoundedQueue.hpp"
+#include "selfplay/Shard.hpp"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace pho::selfplay {
+
+// A read-only memory mapping of one sealed shard.
+class MappedShard
+{
+public:
+    // Validates the shard with readShardHeader() and maps it. Throws std::runtime_error on failure.
+    explicit MappedShard(const std::string& path, bool verifyChecksum = false);
+
+    auto header() const -> const ShardHeader& { return mHeader; }
+    auto count() const -> uint64_t { return mHeader.count; }
+    auto record(uint64_t i) const -> const std::byte* { return mRecords + i * mHeader.recordSize; }
+
+private:
+    prim::MappedFile mFile;
+    ShardHeader mHeader;
+    const std::byte* mRecords;
+};
+
+// A pseudo-random permutation of [0, size), computed one element at a time so that shuffling a dataset needs
+// neither memory proportional to its size nor coordination between the threads that read it.
+// It is a 4-round Feistel network over the smallest even number of bits that covers size, cycle-walking the
+// (fewer than 3 in 4) outputs that fall outside the range.
+class ShuffledIndex
+{
+public:
+    ShuffledIndex(uint64_t size, uint64_t seed);
+
+    auto size() const -> uint64_t { return mSize; }
+    auto operator()(uint64_t i) const -> uint64_t;
+
+private:
+    static constexpr int kRounds = 4;
+
+    auto encrypt(uint64_t x) const -> uint64_t;
+
+    uint64_t mSize;
+    unsigned mHalfBits;
+    uint64_t mHalfMask;
+    uint64_t mKeys[kRounds];
+};
+
+struct LoaderConfig
+{
+    unsigned batchSize{256};
+
+    // The number of decoding threads. Zero means one per hardware thread.
+    unsigned threads{0};
+
+    // The number of decoded batches that may be waiting for the consumer.
+    unsigned queueDepth{8};
+
+    uint64_t seed{0};
+
+    // The number of passes over the records. Zero means loop forever.
+    uint64_t epochs{1};
+
+    // Visit the records of each epoch in a different random order. Otherwise visit them in shard order.
+    bool shuffle{true};
+
+    bool verifyChecksums{false};
+};
+
+// One batch of decoded records, in row-major arrays of `size` rows.
+struct Batch
+{
+    uint64_t index{}; // the position of this batch in the stream of batches
+    unsigned size{};
+    std::vector<float> tensors; // size * RecordLayout::tensorFloats()
+    std::vector<uint64_t> legal; // size
+    std::vector<int32_t> chosen; // size
+    std::vector<int32_t> player; // size
+    std::vector<float> scores; // size * kNumPlayers
+    std::vector<uint64_t> records; // size, the global index of each record
+};
+
+// Serves shuffled batches of training records from a set of shards.
+//
+// The shards are memory-mapped and addressed through a global record index, so sampling never copies a shard.
+// The stream of records is the concatenation of `epochs` permutations of all records, cut into batches of
+// batchSize (the last batch may be short). Background threads claim batch numbers from an atomic counter,
+// decode their records into a recycled Batch and publish it on a lock-free queue.
+// Each batch's content depends only on the seed and its index, but with more than one thread batches may be
+// delivered out of order; Batch::index tells which batch it is.
+class BatchLoader
+{
+public:
+    BatchLoader(const std::vector<std::string>& paths, const LoaderConfig& config);
+    ~BatchLoader();
+
+    BatchLoader(const BatchLoader&) = delete;
+    BatchLoader& operator=(const BatchLoader&) = delete;
+
+    auto layout() const -> const RecordLayout& { return mLayout; }
+    auto numRecords() const -> uint64_t { return mNumRecords; }
+
+    // The number of batches in the stream, or ~0 when the loader loops forever.
+    auto numBatches() const -> uint64_t { return mNumBatches; }
+
+    // Wait for the next decoded batch, or return nullptr at the end of the stream.
+    // Only one thread may call next(). The batch stays valid until the following call to next().
+    auto next() -> const Batch*;
+
+    // Decode one record by its global index.
+    auto decode(uint64_t record, RecordHead& head, float* tensor) const -> void;
+
+private:
+    auto locate(uint64_t record) const -> const std::byte*;
+    auto recordAt(uint64_t position) const -> uint64_t;
+    auto fill(Batch& batch, uint64_t index) const -> void;
+    auto work() -> void;
+
+    LoaderConfig mConfig;
+    std::vector<MappedShard> mShards;
+    std::vector<uint64_t> mShardStart; // the global index of the first record of each shard
+    RecordLayout mLayout;
+    uint64_t mNumRecords;
+    uint64_t mNumBatches;
+
+    std::vector<Batch> mBatches;
+    prim::BoundedQueue<Batch*> mFree;
+    prim::BoundedQueue<Batch*> mReady;
+    Batch* mCurrent;
+
+    std::atomic<uint64_t> mNextBatch;
+    std::atomic<unsigned> mRunning;
+    std::atomic<bool> mStop;
+    std::vector<std::thread> mThreads;
+};
+
+} // namespace pho::selfplay
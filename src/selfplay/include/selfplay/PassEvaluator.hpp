@@ -0,0 +1,70 @@
+#pragma once
+
+#include "gstate/GameVariant.hpp"
+#include "gstate/Policy.hpp"
+
+#include <vector>
+
+namespace pho::selfplay {
+
+struct PassEvalConfig
+{
+    gstate::GameVariant variant{gstate::standard};
+
+    // The direction of the pass, 1..3. A hold hand (0) has nothing to evaluate.
+    gstate::PassOffset passOffset{1};
+
+    // The number of sampled deals of the other 39 cards. Every pass is played out on the same samples.
+    uint64_t samples{1000};
+
+    // The number of worker threads. Zero means one per hardware thread.
+    unsigned threads{0};
+
+    // Sample s draws all its random choices from RandomGenerator::forStream(seed, s), so the results do not depend on
+    // the number of threads.
+    uint64_t seed{0};
+
+    // The policy used by all four seats in the playouts.
+    gstate::Policy policy{gstate::policies::random()};
+
+    // The passes to evaluate. Empty means all 286 passes of the hand.
+    std::vector<cards::CardSet> candidates;
+
+    // The confidence intervals are mean +/- z standard errors.
+    double z{1.96};
+
+    // When non-zero, evaluate the samples in batches of this size and after each batch stop evaluating the passes
+    // that are already worse than the leading pass by more than z standard errors of their paired difference.
+    // A pruned pass keeps the statistics of the samples it was played out on.
+    uint64_t pruneBatch{0};
+};
+
+struct PassValue
+{
+    cards::CardSet pass;
+
+    // The number of samples the pass was played out on, less than the configured number if it was pruned.
+    uint64_t samples{};
+
+    // The mean of the passing player's zero-mean score (GState::Outcome::scores, where lower is better), and the half
+    // width of its confidence interval.
+    double mean{};
+    double halfWidth{};
+
+    // The mean difference in score from the best pass over the samples they share, and the half width of its
+    // confidence interval. Since the samples are shared, this is much tighter than the intervals of the means.
+    // It is never negative for a pass played out on every sample; for a pruned pass it covers only the early samples,
+    // on which the best pass may have done worse.
+    double delta{};
+    double deltaHalfWidth{};
+};
+
+// Evaluate the passes of player 0's hand by simulation: for each sampled deal of the other cards (and random passes
+// by the other players), play out the hand after each candidate pass, with the playout's random generator in the
+// same state for every pass. These common random numbers make the differences between passes far less noisy than
+// independent playouts would. The samples are spread over config.threads workers.
+// Returns the passes ranked best first: those played out on every sample by delta, then the pruned ones by delta.
+// Throws std::invalid_argument for a bad hand, offset or candidate.
+auto evaluatePasses(cards::CardSet hand, const PassEvalConfig& config) -> std::vector<PassValue>;
+
+} // namespace pho::selfplay
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "prim/MappedFile.hpp"
+#include "selfplay/PassEvaluator.hpp"
+
+#include <array>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace pho::selfplay {
+
+// A pass table is a file of precomputed opening passes: a 64-byte PassTableHeader followed by `count` PassTableEntry
+// sorted by key. It is built offline with the pass evaluator and memory-mapped by PassTable, which finds the entry of
+// a hand by binary search, so a pass decision at the start of a hand is a lookup instead of thousands of playouts.
+//
+// Hands are stored by their canonical representative (see gstate/SuitSymmetry.hpp), so in Spades each entry serves
+// every hand that differs only by a permutation of the plain suits.
+struct PassTableHeader
+{
+    static constexpr char kMagic[8] = {'P', 'H', 'O', 'P', 'A', 'S', 'S', 'T'};
+    static constexpr uint32_t kVersion = 1;
+
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t entrySize;
+    uint32_t variant; // a gstate::GameVariant
+    uint64_t count; // the number of entries
+    uint64_t samples; // the samples per pass evaluation
+    uint64_t seed; // the seed of the build
+    uint64_t checksum; // prim::hash64 of the entries
+    uint64_t reserved;
+};
+static_assert(sizeof(PassTableHeader) == 64);
+
+struct PassTableEntry
+{
+    static constexpr unsigned kTopPasses = 4;
+    static constexpr uint16_t kNoPass = 0xffff;
+
+    // (rank of the canonical hand among all 13-card hands) << 2 | pass offset. See PassTable::keyOf().
+    uint64_t key;
+
+    // The best passes, best first, each as its rank among the 286 passes of the canonical hand (see
+    // cards::rankSubset), or kNoPass when fewer passes were evaluated.
+    std::array<uint16_t, kTopPasses> passes;
+
+    // The mean score of each pass (lower is better), as PassValue::mean.
+    std::array<float, kTopPasses> scores;
+};
+static_assert(sizeof(PassTableEntry) == 32);
+
+struct PassChoice
+{
+    cards::CardSet pass;
+    float score;
+};
+
+// A read-only, memory-mapped pass table. Lookups are thread-safe.
+class PassTable
+{
+public:
+    // Validates the header and maps the file. Throws std::runtime_error on failure.
+    explicit PassTable(const std::string& path, bool verifyChecksum = false);
+
+    auto header() const -> const PassTableHeader& { return mHeader; }
+    auto variant() const -> gstate::GameVariant { return gstate::GameVariant(mHeader.variant); }
+    auto size() const -> uint64_t { return mHeader.count; }
+
+    // The entry for the hand and offset, or nullptr if the table does not have it.
+    auto find(cards::CardSet hand, gstate::PassOffset offset) const -> const PassTableEntry*;
+
+    // The best pass for the hand, in the hand's own suits.
+    auto bestPass(cards::CardSet hand, gstate::PassOffset offset) const -> std::optional<cards::CardSet>;
+
+    // The stored passes for the hand, best first, in the hand's own suits. Empty if the table does not have it.
+    auto choices(cards::CardSet hand, gstate::PassOffset offset) const -> std::vector<PassChoice>;
+
+    // The key of a hand that is already canonical.
+    static auto keyOf(cards::CardSet canonicalHand, gstate::PassOffset offset) -> uint64_t;
+
+private:
+    auto findKey(uint64_t key) const -> const PassTableEntry*;
+
+    prim::MappedFile mFile;
+    PassTableHeader mHeader;
+    const PassTableEntry* mEntries;
+};
+
+// Collects evaluated hands and writes them as a pass table.
+class PassTableWriter
+{
+public:
+    PassTableWriter(gstate::GameVariant variant, uint64_t samples, uint64_t seed);
+
+    auto has(cards::CardSet hand, gstate::PassOffset offset) const -> bool;
+
+    // Add the ranked passes of a hand, best first, as returned by evaluatePasses(). An entry for a hand with the same
+    // canonical representative is replaced.
+    auto add(cards::CardSet hand, gstate::PassOffset offset, const std::vector<PassValue>& ranked) -> void;
+
+    auto size() const -> uint64_t { return mEntries.size(); }
+
+    // Write the table, replacing any file at path. Throws std::runtime_error on failure.
+    auto write(const std::string& path) const -> void;
+
+private:
+    gstate::GameVariant mVariant;
+    uint64_t mSamples;
+    uint64_t mSeed;
+    std::map<uint64_t, PassTableEntry> mEntries;
+};
+
+struct PassTableConfig
+{
+    std::string path;
+
+    // The number of distinct random hands to evaluate for each offset.
+    uint64_t hands{100};
+
+    std::vector<gstate::PassOffset> offsets{1, 2, 3};
+
+    // The evaluation of each hand. eval.seed also seeds the choice of hands, and eval.candidates must be empty.
+    PassEvalConfig eval{};
+};
+
+// Evaluate config.hands random hands per offset with evaluatePasses() and write them as a pass table.
+// Returns the number of entries written.
+auto buildPassTable(const PassTableConfig& config) -> uint64_t;
+
+} // namespace pho::selfplay
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "cards/constants.hpp"
+#include "gstate/TensorSchema.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace pho::selfplay {
+
+using ColumnPlan = gstate::tensor::ColumnPlan;
+using Scores = std::array<float, cards::kNumPlayers>;
+
+// One self-play decision. The tensor itself is not stored as floats: a record holds the schema's ColumnPlans,
+// which are a bit-packed and lossless representation of the tensor (see gstate/TensorSchema.hpp).
+// Every record of a shard has the same size, given by the RecordLayout of the shard's schema.
+struct RecordHead
+{
+    uint64_t legal; // the legal plays mask
+    Scores scores; // the final GState::getPlayerScores(), rotated so that index 0 is `player`
+    uint8_t chosen; // the ord of the card played
+    uint8_t player; // the seat of the player making the decision
+    uint8_t playIndex; // 0..51
+    uint8_t reserved[5];
+};
+static_assert(sizeof(RecordHead) == 32);
+
+// The byte layout of the records of one schema.
+// A record is a RecordHead followed by, for each column, the `ones` mask, and then for each scaled column
+// the `scaled` mask and the four suit scales.
+class RecordLayout
+{
+public:
+    static constexpr unsigned kMaxColumns = 64;
+
+    RecordLayout(unsigned width, uint64_t scaledColumns);
+
+    template <typename Schema>
+    static auto of() -> RecordLayout
+    {
+        static_assert(Schema::kWidth <= kMaxColumns);
+        auto scaled = uint64_t{};
+        constexpr auto kScaled = Schema::scaledColumns();
+        for (unsigned col = 0; col < Schema::kWidth; ++col)
+            scaled |= uint64_t{kScaled[col]} << col;
+        return RecordLayout{Schema::kWidth, scaled};
+    }
+
+    auto width() const -> unsigned { return mWidth; }
+    auto scaledColumns() const -> uint64_t { return mScaledColumns; }
+    auto isScaled(unsigned col) const -> bool { return (mScaledColumns >> col) & 1u; }
+    auto recordSize() const -> size_t { return mRecordSize; }
+
+    // The number of floats in a decoded tensor.
+    auto tensorFloats() const -> size_t { return size_t{mWidth} * cards::kCardsPerDeck; }
+
+    // Pack the head and the plan (which must have width() columns) into out, which must have recordSize() bytes.
+    auto pack(const RecordHead& head, const ColumnPlan* plan, std::byte* out) const -> void;
+
+    // Unpack the record into head and into the tensor, which must have room for tensorFloats() floats.
+    // The tensor is identical, bit for bit, to what Schema::expand() produces for the plan that was packed.
+    auto unpack(const std::byte* in, RecordHead& head, float* tensor) const -> void;
+
+    auto operator==(const RecordLayout& other) const -> bool
+    {
+        return mWidth == other.mWidth && mScaledColumns == other.mScaledColumns;
+    }
+
+private:
+    unsigned mWidth;
+    uint64_t mScaledColumns;
+    size_t mRecordSize;
+};
+
+} // namespace pho::selfplay
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "gstate/GameVariant.hpp"
+#include "gstate/Policy.hpp"
+#include "gstate/TensorSchema.hpp"
+#include "selfplay/Record.hpp"
+
+#include <string>
+#include <vector>
+
+namespace pho::selfplay {
+
+// The schema of the tensors recorded by self-play.
+using Schema = gstate::min2022::Schema;
+
+struct SelfPlayConfig
+{
+    // Worker w writes the shards `{outputPrefix}-w{w:03}-{index:06}.shard`.
+    std::string outputPrefix;
+
+    uint64_t games{1000};
+
+    // The number of worker threads. Zero means one per hardware thread.
+    unsigned threads{0};
+
+    // Game g draws all its random choices from RandomGenerator::forStream(seed, g), so the set of games played
+    // does not depend on the number of threads.
+    uint64_t seed{0};
+
+    gstate::GameVariant variant{gstate::standard};
+
+    // Either one policy used for all four seats, or one policy per seat.
+    std::vector<gstate::Policy> policies{gstate::policies::random()};
+
+    // When true each game has a random pass offset, and the players pass three random cards.
+    bool passing{true};
+
+    uint64_t recordsPerShard{uint64_t{1} << 16};
+};
+
+struct SelfPlayStats
+{
+    uint64_t games{};
+    uint64_t records{};
+    std::vector<std::string> shards;
+};
+
+// Play config.games games of self-play across config.threads workers and write one record per decision.
+// Each worker owns its game states and its ShardWriter, and each game its random generator, so workers share
+// nothing while playing. Throws if any worker fails.
+auto runSelfPlay(const SelfPlayConfig& config) -> SelfPlayStats;
+
+} // namespace pho::selfplay
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "prim/MappedFile.hpp"
+#include "selfplay/Record.hpp"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace pho::selfplay {
+
+// A shard is one file of fixed-size records: a 64-byte ShardHeader followed by `count` records.
+// Shards are written append-only and sealed when full (or when the writer is closed), at which point the header
+// is rewritten with the final count and the checksum of the record bytes. A shard whose header is not sealed was
+// interrupted and must not be read.
+// The layout is designed to be memory-mapped: records start at a fixed offset and have a fixed size.
+struct ShardHeader
+{
+    static constexpr char kMagic[8] = {'P', 'H', 'O', 'S', 'H', 'A', 'R', 'D'};
+    static constexpr uint32_t kVersion = 1;
+
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t recordSize;
+    uint32_t width; // the number of columns in the tensor schema
+    uint64_t scaledColumns; // bit per column, see RecordLayout
+    uint64_t capacity; // the number of records the shard was sized for
+    uint64_t count; // the number of records in the shard
+    uint64_t checksum; // the chained prim::hash64 of each record, in order, seeded with 0
+    uint32_t sealed;
+    uint32_t reserved;
+
+    auto layout() const -> RecordLayout { return RecordLayout{width, scaledColumns}; }
+};
+static_assert(sizeof(ShardHeader) == 64);
+
+// Update a shard checksum with the next record.
+auto checksumRecord(uint64_t checksum, const std::byte* record, size_t recordSize) -> uint64_t;
+
+// Read and validate the header of a shard file, and optionally verify the checksum of its records.
+// Throws std::runtime_error if the file is not a complete, sealed shard.
+auto readShardHeader(const std::string& path, bool verifyChecksum = false) -> ShardHeader;
+auto readShardHeader(const prim::MappedFile& file, bool verifyChecksum = false) -> ShardHeader;
+
+// Writes a sequence of shards named `{prefix}-{index:06}.shard`.
+// A ShardWriter is owned by exactly one thread; no locking is done.
+class ShardWriter
+{
+public:
+    ShardWriter(std::string prefix, RecordLayout layout, uint64_t recordsPerShard);
+    ~ShardWriter();
+
+    ShardWriter(const ShardWriter&) = delete;
+    ShardWriter& operator=(const ShardWriter&) = delete;
+
+    auto layout() const -> const RecordLayout& { return mLayout; }
+
+    // Append one record of layout().recordSize() bytes, sealing the shard when it becomes full.
+    auto append(const std::byte* record) -> void;
+
+    // Seal the current shard (if any records were appended to it). Further appends start a new shard.
+    auto close() -> void;
+
+    auto recordsWritten() const -> uint64_t { return mRecordsWritten; }
+    auto paths() const -> const std::vector<std::string>& { return mPaths; }
+
+private:
+    auto open() -> void;
+    auto seal() -> void;
+
+    std::string mPrefix;
+    RecordLayout mLayout;
+    uint64_t mCapacity;
+    FILE* mFile;
+    ShardHeader mHeader;
+    uint64_t mRecordsWritten;
+    std::vector<std::string> mPaths;
+};
+
+} // namespace pho::selfplay
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "gstate/GameVariant.hpp"
+#include "gstate/ScoreResult.hpp"
+#include "gstate/Sprt.hpp"
+#include "stats/RunningStats.hpp"
+
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace pho::selfplay {
+
+struct TournamentConfig
+{
+    // The agents, by policy name (see gstate::policies::named()). At least two.
+    std::vector<std::string> agents;
+
+    // The deals each pairing plays. Every pairing plays the same deals, each with every distinct rotation of its
+    // seating, so the luck of the cards cancels out.
+    uint64_t deals{1000};
+
+    // The number of worker threads. Zero means one per hardware thread.
+    unsigned threads{0};
+
+    // Deal d, its passes and the random choices of its games come from RandomGenerator::forStream(seed, d), so the
+    // results do not depend on the number of threads or on where a run was resumed.
+    uint64_t seed{0};
+
+    gstate::GameVariant variant{gstate::standard};
+
+    // When true each deal has a random pass offset, and the players pass three random cards.
+    bool passing{true};
+
+    // eSolo: the hero plays one seat against three copies of the opponent, for every ordered pair of agents.
+    // eTeam: the hero and the opponent each play two opposite seats, for every unordered pair.
+    gstate::ScoreResult::ScoreType mode{gstate::ScoreResult::eSolo};
+
+    // When not empty, the results are saved to this file after every batch of deals, and a run starts from the deals
+    // already saved there. An interrupted tournament is resumed, and a finished one extended, by running it again
+    // with the same agents, seed, variant, passing and mode.
+    std::string checkpoint;
+
+    // The deals played between checkpoints. Batches end on multiples of this.
+    uint64_t batch{256};
+
+    // When set, every pairing is tested for its Elo delta after each full batch, and the run stops early once every
+    // pairing has a decision; `deals` is then only the limit. The test and the batch size are part of the tournament's
+    // identity: a checkpoint only resumes with the same ones.
+    std::optional<gstate::SprtConfig> sprt;
+};
+
+struct Pairing
+{
+    unsigned hero;
+    unsigned opponent;
+
+    // Every hand, from the hero's point of view.
+    gstate::ScoreResult score;
+
+    // The hero's zero-mean score on each deal, averaged over its rotations. Duplicate play makes these samples far
+    // less noisy than single hands, so this gives the confidence interval of score.scoreDelta().
+    stats::RunningStats duplicate;
+
+    // The hero's ScoreResult::eloScore() on each deal, the samples of the SPRT and of eloInterval().
+    stats::RunningStats duplicateElo;
+
+    // The first SPRT decision, and the deals played when it was made. Later deals do not change it.
+    gstate::Sprt::Decision decision{gstate::Sprt::eContinue};
+    uint64_t decidedAt{0};
+
+    // A 95% confidence sequence of the Elo delta, valid however early the run stopped.
+    auto eloInterval() const -> std::pair<double, double>;
+};
+
+struct TournamentResult
+{
+    std::vector<std::string> agents;
+    gstate::ScoreResult::ScoreType mode;
+    std::vector<Pairing> pairings;
+
+    uint64_t deals; // the deals played by every pairing
+    uint64_t resumedFrom; // of which this many were loaded from the checkpoint
+    std::optional<gstate::SprtConfig> sprt;
+    bool stoppedEarly; // by the SPRT, before the deals of the configuration
+
+    // The agent's hands as hero in all its pairings.
+    auto agentScore(unsigned agent) const -> gstate::ScoreResult;
+};
+
+// Play the tournament on all cores. Throws std::invalid_argument for a bad configuration and std::runtime_error for
+// a checkpoint that cannot be read or belongs to a different tournament.
+auto runTournament(const TournamentConfig& config) -> TournamentResult;
+
+// A table of each pairing and each agent: hands, win fraction, zero-mean score with its 95% confidence interval, and
+// Elo delta; and, with an SPRT, each pairing's log-likelihood ratio, decision and Elo confidence sequence.
+auto formatSummary(const TournamentResult& result) -> std::string;
+
+} // namespace pho::selfplay
@@ -0,0 +1,76 @@
+/* A C interface to pho::selfplay::BatchLoader, for binding from Python (ctypes/cffi) and other languages.
+ *
+ * The shared library libpho_loader exports these functions. Every pointer in a pho_batch refers to memory owned
+ * by the loader, and stays valid until the next call to pho_loader_next() or pho_loader_close() on that loader.
+ *
+ * Typical use:
+ *
+ *     pho_loader_config config;
+ *     pho_loader_default_config(&config);
+ *     config.batch_size = 1024;
+ *     pho_loader* loader = pho_loader_open(paths, num_paths, &config);
+ *     if (!loader) fail(pho_loader_last_error());
+ *     pho_batch batch;
+ *     while (pho_loader_next(loader, &batch) == 1) train(&batch);
+ *     pho_loader_close(loader);
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct pho_loader pho_loader;
+
+typedef struct pho_loader_config
+{
+    uint32_t batch_size;
+    uint32_t threads; /* 0 means one per hardware thread */
+    uint32_t queue_depth; /* the number of decoded batches that may wait for the consumer */
+    uint32_t shuffle; /* nonzero to visit each epoch in a new random order */
+    uint64_t seed;
+    uint64_t epochs; /* 0 means loop forever */
+    uint32_t verify_checksums;
+    uint32_t reserved;
+} pho_loader_config;
+
+typedef struct pho_batch
+{
+    uint64_t index; /* the position of the batch in the stream; batches may arrive out of order */
+    uint32_t size; /* the number of rows */
+    uint32_t tensor_floats; /* the number of floats per row of tensors, 52 * tensor_width */
+    const float* tensors; /* size * tensor_floats */
+    const uint64_t* legal; /* size, bit i set when the card with ord i is a legal play */
+    const int32_t* chosen; /* size, the ord of the card played */
+    const int32_t* player; /* size, the seat of the player */
+    const float* scores; /* size * 4, the final scores rotated so that column 0 is the player */
+} pho_batch;
+
+void pho_loader_default_config(pho_loader_config* config);
+
+/* Open a loader over the given shards. Returns NULL on failure, see pho_loader_last_error(). */
+pho_loader* pho_loader_open(const char* const* paths, size_t num_paths, const pho_loader_config* config);
+
+/* The message of the last error on this thread, or an empty string. */
+const char* pho_loader_last_error(void);
+
+uint64_t pho_loader_num_records(const pho_loader* loader);
+
+/* The number of batches the loader will deliver, or UINT64_MAX when it loops forever. */
+uint64_t pho_loader_num_batches(const pho_loader* loader);
+
+/* The number of columns of the tensor schema. */
+uint32_t pho_loader_tensor_width(const pho_loader* loader);
+
+/* Wait for the next batch. Returns 1 and fills *batch, or 0 at the end of the stream, or -1 on error. */
+int pho_loader_next(pho_loader* loader, pho_batch* batch);
+
+void pho_loader_close(pho_loader* loader);
+
+#ifdef __cplusplus
+}
+#endif
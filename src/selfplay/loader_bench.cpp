@@ -0,0 +1,78 @@
+// loader_bench: measure how many records per second BatchLoader decodes.
+//
+// Usage: loader_bench [--threads=N] [--batch=N] [--epochs=N] [--games=N] [SHARD...]
+//
+// Without shard arguments it first generates --games games of random self-play into a temporary directory.
+
+#include "selfplay/Loader.hpp"
+#include "selfplay/SelfPlay.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <fmt/format.h>
+#include <stdexcept>
+#include <unistd.h>
+
+using namespace pho;
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        auto config = selfplay::LoaderConfig{};
+        auto games = uint64_t{20000};
+        auto paths = std::vector<std::string>{};
+
+        for (int i = 1; i < argc; ++i)
+        {
+            const auto arg = std::string{argv[i]};
+            const auto eq = arg.find('=');
+            const auto key = arg.substr(0, eq);
+            const auto value = eq == std::string::npos ? std::string{} : arg.substr(eq + 1);
+
+            if (key == "--threads")
+                config.threads = unsigned(std::stoul(value));
+            else if (key == "--batch")
+                config.batchSize = unsigned(std::stoul(value));
+            else if (key == "--epochs")
+                config.epochs = std::stoull(value);
+            else if (key == "--games")
+                games = std::stoull(value);
+            else if (key.starts_with("--"))
+                throw std::invalid_argument(fmt::format("Unrecognized argument: {}", arg));
+            else
+                paths.push_back(arg);
+        }
+
+        auto scratch = std::filesystem::path{};
+        if (paths.empty())
+        {
+            scratch = std::filesystem::temp_directory_path() / fmt::format("pho_loader_bench_{}", ::getpid());
+            std::filesystem::create_directories(scratch);
+            auto selfPlay = selfplay::SelfPlayConfig{};
+            selfPlay.outputPrefix = (scratch / "bench").string();
+            selfPlay.games = games;
+            paths = selfplay::runSelfPlay(selfPlay).shards;
+        }
+
+        auto records = uint64_t{};
+        const auto start = std::chrono::steady_clock::now();
+        {
+            auto loader = selfplay::BatchLoader{paths, config};
+            while (const auto* batch = loader.next())
+                records += batch->size;
+        }
+        const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        fmt::print("records: {} seconds: {:.2f} records/sec: {:.0f}\n", records, seconds, records / seconds);
+
+        if (!scratch.empty())
+            std::filesystem::remove_all(scratch);
+        return 0;
+    }
+    catch (const std::exception& e)
+    {
+        fmt::print(stderr, "loader_bench: {}\n", e.what());
+        return 1;
+    }
+}
@@ -0,0 +1,103 @@
+// pass_table: build an opening-pass table offline with the pass evaluator, then time lookups in it.
+//
+// Usage: pass_table --out=PATH [--hands=N] [--offsets=1,2,3] [--samples=N] [--prune-batch=N] [--threads=N]
+//                   [--seed=N] [--variant=standard|jack|spades] [--policy=NAME]
+//
+// Each of --hands random hands is evaluated for each offset with --samples playouts per pass, so the cost is about
+// hands * offsets * 286 * samples playouts (less with --prune-batch).
+
+#include "cards/Deal.hpp"
+#include "gstate/Policy.hpp"
+#include "prim/split.hpp"
+#include "selfplay/PassTable.hpp"
+
+#include <chrono>
+#include <fmt/format.h>
+#include <stdexcept>
+
+using namespace pho;
+
+namespace {
+
+auto parseArgs(int argc, char* argv[]) -> selfplay::PassTableConfig
+{
+    auto config = selfplay::PassTableConfig{};
+    for (int i = 1; i < argc; ++i)
+    {
+        const auto arg = std::string{argv[i]};
+        const auto eq = arg.find('=');
+        const auto key = arg.substr(0, eq);
+        const auto value = eq == std::string::npos ? std::string{} : arg.substr(eq + 1);
+
+        if (key == "--out")
+            config.path = value;
+        else if (key == "--hands")
+            config.hands = std::stoull(value);
+        else if (key == "--samples")
+            config.eval.samples = std::stoull(value);
+        else if (key == "--prune-batch")
+            config.eval.pruneBatch = std::stoull(value);
+        else if (key == "--threads")
+            config.eval.threads = unsigned(std::stoul(value));
+        else if (key == "--seed")
+            config.eval.seed = std::stoull(value);
+        else if (key == "--variant")
+            config.eval.variant = gstate::namedVariant(value);
+        else if (key == "--policy")
+            config.eval.policy = gstate::policies::named(value);
+        else if (key == "--offsets")
+        {
+            config.offsets.clear();
+            for (const auto& offset : split(value, ','))
+            {
+                const auto parsed = std::stoul(offset);
+                if (parsed < 1 || parsed >= cards::kNumPlayers)
+                    throw std::invalid_argument(fmt::format("Pass offset {} is not in 1..3", offset));
+                config.offsets.push_back(gstate::PassOffset(parsed));
+            }
+            if (config.offsets.empty())
+                throw std::invalid_argument("--offsets needs at least one offset");
+        }
+        else
+            throw std::invalid_argument(fmt::format("Unrecognized argument: {}", arg));
+    }
+    if (config.path.empty())
+        throw std::invalid_argument("--out=PATH is required");
+    return config;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        const auto config = parseArgs(argc, argv);
+
+        auto start = std::chrono::steady_clock::now();
+        const auto entries = selfplay::buildPassTable(config);
+        auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        fmt::print("entries: {} seconds: {:.2f} hands/sec: {:.2f}\n", entries, seconds, entries / seconds);
+
+        // Random hands mostly miss the table, which is the slower path of the binary search.
+        const auto table = selfplay::PassTable{config.path, true};
+        const auto rng = math::RandomGenerator{config.eval.seed};
+        constexpr auto kLookups = 100000;
+        auto hands = std::vector<cards::CardSet>{};
+        for (auto i = 0; i < kLookups; ++i)
+            hands.push_back(cards::Deal{cards::Deal::randomDealIndex(rng)}.dealFor(0));
+
+        auto found = uint64_t{};
+        start = std::chrono::steady_clock::now();
+        for (const auto& hand : hands)
+            found += table.bestPass(hand, config.offsets.front()).has_value();
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        fmt::print("lookups: {} found: {} us/lookup: {:.3f}\n", kLookups, found, 1e6 * seconds / kLookups);
+        return 0;
+    }
+    catch (const std::exception& e)
+    {
+        fmt::print(stderr, "pass_table: {}\n", e.what());
+        return 1;
+    }
+}
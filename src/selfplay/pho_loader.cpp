@@ -0,0 +1,106 @@
+#include "selfplay/pho_loader.h"
+#include "selfplay/Loader.hpp"
+
+#include <exception>
+#include <string>
+
+using namespace pho::selfplay;
+
+struct pho_loader
+{
+    BatchLoader loader;
+};
+
+namespace {
+thread_local std::string gLastError;
+
+template <typename Fn>
+auto guarded(Fn fn, decltype(fn()) onError) -> decltype(fn())
+{
+    try
+    {
+        gLastError.clear();
+        return fn();
+    }
+    catch (const std::exception& e)
+    {
+        gLastError = e.what();
+    }
+    catch (...)
+    {
+        gLastError = "unknown exception";
+    }
+    return onError;
+}
+} // namespace
+
+extern "C" {
+
+void pho_loader_default_config(pho_loader_config* config)
+{
+    const auto defaults = LoaderConfig{};
+    *config = pho_loader_config{};
+    config->batch_size = defaults.batchSize;
+    config->threads = defaults.threads;
+    config->queue_depth = defaults.queueDepth;
+    config->shuffle = defaults.shuffle;
+    config->seed = defaults.seed;
+    config->epochs = defaults.epochs;
+    config->verify_checksums = defaults.verifyChecksums;
+}
+
+pho_loader* pho_loader_open(const char* const* paths, size_t num_paths, const pho_loader_config* config)
+{
+    return guarded(
+        [&]() {
+            auto defaults = pho_loader_config{};
+            if (config == nullptr)
+            {
+                pho_loader_default_config(&defaults);
+                config = &defaults;
+            }
+            auto loaderConfig = LoaderConfig{};
+            loaderConfig.batchSize = config->batch_size;
+            loaderConfig.threads = config->threads;
+            loaderConfig.queueDepth = config->queue_depth;
+            loaderConfig.shuffle = config->shuffle != 0;
+            loaderConfig.seed = config->seed;
+            loaderConfig.epochs = config->epochs;
+            loaderConfig.verifyChecksums = config->verify_checksums != 0;
+
+            return new pho_loader{BatchLoader{std::vector<std::string>(paths, paths + num_paths), loaderConfig}};
+        },
+        static_cast<pho_loader*>(nullptr));
+}
+
+const char* pho_loader_last_error(void) { return gLastError.c_str(); }
+
+uint64_t pho_loader_num_records(const pho_loader* loader) { return loader->loader.numRecords(); }
+
+uint64_t pho_loader_num_batches(const pho_loader* loader) { return loader->loader.numBatches(); }
+
+uint32_t pho_loader_tensor_width(const pho_loader* loader) { return loader->loader.layout().width(); }
+
+int pho_loader_next(pho_loader* loader, pho_batch* batch)
+{
+    return guarded(
+        [&]() {
+            const auto* next = loader->loader.next();
+            if (next == nullptr)
+                return 0;
+            batch->index = next->index;
+            batch->size = next->size;
+            batch->tensor_floats = uint32_t(loader->loader.layout().tensorFloats());
+            batch->tensors = next->tensors.data();
+            batch->legal = next->legal.data();
+            batch->chosen = next->chosen.data();
+            batch->player = next->player.data();
+            batch->scores = next->scores.data();
+            return 1;
+        },
+        -1);
+}
+
+void pho_loader_close(pho_loader* loader) { delete loader; }
+
+} // extern "C"
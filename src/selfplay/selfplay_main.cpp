@@ -0,0 +1,77 @@
+// selfplay: generate training data by self-play on all cores.
+//
+// Usage: selfplay --out=PREFIX [--games=N] [--threads=N] [--seed=N] [--variant=standard|jack|spades]
+//                 [--policy=NAME | --policy=NAME,NAME,NAME,NAME] [--records-per-shard=N] [--no-passing]
+
+#include "gstate/Policy.hpp"
+#include "prim/split.hpp"
+#include "selfplay/SelfPlay.hpp"
+
+#include <chrono>
+#include <fmt/format.h>
+#include <stdexcept>
+
+using namespace pho;
+
+namespace {
+
+auto parseArgs(int argc, char* argv[]) -> selfplay::SelfPlayConfig
+{
+    auto config = selfplay::SelfPlayConfig{};
+    for (int i = 1; i < argc; ++i)
+    {
+        const auto arg = std::string{argv[i]};
+        const auto eq = arg.find('=');
+        const auto key = arg.substr(0, eq);
+        const auto value = eq == std::string::npos ? std::string{} : arg.substr(eq + 1);
+
+        if (key == "--out")
+            config.outputPrefix = value;
+        else if (key == "--games")
+            config.games = std::stoull(value);
+        else if (key == "--threads")
+            config.threads = unsigned(std::stoul(value));
+        else if (key == "--seed")
+            config.seed = std::stoull(value);
+        else if (key == "--variant")
+            config.variant = gstate::namedVariant(value);
+        else if (key == "--records-per-shard")
+            config.recordsPerShard = std::stoull(value);
+        else if (key == "--no-passing")
+            config.passing = false;
+        else if (key == "--policy")
+        {
+            config.policies.clear();
+            for (const auto& name : split(value, ','))
+                config.policies.push_back(gstate::policies::named(name));
+        }
+        else
+            throw std::invalid_argument(fmt::format("Unrecognized argument: {}", arg));
+    }
+    if (config.outputPrefix.empty())
+        throw std::invalid_argument("--out=PREFIX is required");
+    return config;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        const auto config = parseArgs(argc, argv);
+
+        const auto start = std::chrono::steady_clock::now();
+        const auto stats = selfplay::runSelfPlay(config);
+        const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        fmt::print("games: {} records: {} shards: {} seconds: {:.2f} games/sec: {:.0f}\n", stats.games, stats.records,
+            stats.shards.size(), seconds, stats.games / seconds);
+        return 0;
+    }
+    catch (const std::exception& e)
+    {
+        fmt::print(stderr, "selfplay: {}\n", e.what());
+        return 1;
+    }
+}
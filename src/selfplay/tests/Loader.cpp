@@ -0,0 +1,176 @@
+#include "gtest/gtest.h"
+
+#include "prim/range.hpp"
+#include "prim/tests/scratch.hpp"
+#include "selfplay/Loader.hpp"
+#include "selfplay/SelfPlay.hpp"
+#include "selfplay/pho_loader.h"
+
+#include <cstring>
+#include <filesystem>
+#include <set>
+
+namespace pho::selfplay::tests {
+
+namespace fs = std::filesystem;
+
+namespace {
+class LoaderTest : public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        gDir = prim::tests::scratchDir("loader");
+
+        auto config = SelfPlayConfig{};
+        config.outputPrefix = (gDir / "sp").string();
+        config.games = 12;
+        config.threads = 2;
+        config.seed = 7;
+        config.recordsPerShard = 100;
+        gPaths = runSelfPlay(config).shards;
+    }
+
+    static void TearDownTestSuite() { fs::remove_all(gDir); }
+
+    static inline fs::path gDir;
+    static inline std::vector<std::string> gPaths;
+};
+} // namespace
+
+TEST(ShuffledIndex, is_a_permutation)
+{
+    for (uint64_t size : {1, 2, 3, 5, 16, 17, 100, 1000, 4097})
+    {
+        for (uint64_t seed : {0, 1, 99})
+        {
+            const auto index = ShuffledIndex{size, seed};
+            auto seen = std::vector<bool>(size);
+            for (auto i : prim::range(size))
+            {
+                const auto j = index(i);
+                ASSERT_LT(j, size);
+                EXPECT_FALSE(seen[j]);
+                seen[j] = true;
+            }
+        }
+    }
+
+    // Different seeds give different orders
+    const auto a = ShuffledIndex{1000, 1};
+    const auto b = ShuffledIndex{1000, 2};
+    auto same = 0;
+    for (auto i : prim::range(uint64_t{1000}))
+        same += a(i) == b(i);
+    EXPECT_LT(same, 20);
+}
+
+TEST_F(LoaderTest, visits_every_record_once_per_epoch)
+{
+    auto config = LoaderConfig{};
+    config.batchSize = 50;
+    config.threads = 3;
+    config.queueDepth = 2;
+    config.epochs = 2;
+    config.verifyChecksums = true;
+
+    auto loader = BatchLoader{gPaths, config};
+    const auto numRecords = loader.numRecords();
+    ASSERT_EQ(numRecords, 12u * 52u);
+    EXPECT_EQ(loader.numBatches(), (2 * numRecords + 49) / 50);
+
+    auto positions = std::set<uint64_t>{};
+    auto perEpoch = std::vector<std::vector<int>>(2, std::vector<int>(numRecords));
+    auto tensor = std::vector<float>(loader.layout().tensorFloats());
+
+    while (const auto* batch = loader.next())
+    {
+        for (auto row : prim::range(batch->size))
+        {
+            const auto position = batch->index * config.batchSize + row;
+            EXPECT_TRUE(positions.insert(position).second);
+            const auto record = batch->records[row];
+            ++perEpoch.at(position / numRecords).at(record);
+
+            // Every row is the decoded record
+            auto head = RecordHead{};
+            loader.decode(record, head, tensor.data());
+            EXPECT_EQ(batch->legal[row], head.legal);
+            EXPECT_EQ(batch->chosen[row], head.chosen);
+            EXPECT_EQ(batch->player[row], head.player);
+            EXPECT_EQ(0, std::memcmp(batch->tensors.data() + row * tensor.size(), tensor.data(),
+                             tensor.size() * sizeof(float)));
+        }
+    }
+    EXPECT_EQ(positions.size(), 2 * numRecords);
+    for (const auto& counts : perEpoch)
+        EXPECT_EQ(std::count(counts.begin(), counts.end(), 1), int(numRecords));
+}
+
+TEST_F(LoaderTest, unshuffled_is_shard_order)
+{
+    auto config = LoaderConfig{};
+    config.batchSize = 64;
+    config.threads = 1;
+    config.shuffle = false;
+
+    auto loader = BatchLoader{gPaths, config};
+    auto expected = uint64_t{};
+    while (const auto* batch = loader.next())
+    {
+        for (auto row : prim::range(batch->size))
+            EXPECT_EQ(batch->records[row], expected++);
+    }
+    EXPECT_EQ(expected, loader.numRecords());
+}
+
+TEST_F(LoaderTest, stops_early)
+{
+    auto config = LoaderConfig{};
+    config.batchSize = 8;
+    config.threads = 2;
+    config.epochs = 0;
+
+    auto loader = BatchLoader{gPaths, config};
+    for (auto i : prim::range(100))
+    {
+        (void)i;
+        ASSERT_NE(loader.next(), nullptr);
+    }
+    // The destructor stops the workers although the stream is endless
+}
+
+TEST_F(LoaderTest, c_interface)
+{
+    auto paths = std::vector<const char*>{};
+    for (const auto& path : gPaths)
+        paths.push_back(path.c_str());
+
+    pho_loader_config config;
+    pho_loader_default_config(&config);
+    config.batch_size = 100;
+    config.threads = 2;
+
+    pho_loader* loader = pho_loader_open(paths.data(), paths.size(), &config);
+    ASSERT_NE(loader, nullptr) << pho_loader_last_error();
+    EXPECT_EQ(pho_loader_num_records(loader), 12u * 52u);
+    EXPECT_EQ(pho_loader_tensor_width(loader), Schema::kWidth);
+
+    pho_batch batch;
+    auto records = uint64_t{};
+    while (pho_loader_next(loader, &batch) == 1)
+    {
+        EXPECT_EQ(batch.tensor_floats, Schema::kFloats);
+        for (auto row : prim::range(batch.size))
+            EXPECT_TRUE((batch.legal[row] >> batch.chosen[row]) & 1u);
+        records += batch.size;
+    }
+    EXPECT_EQ(records, 12u * 52u);
+    pho_loader_close(loader);
+
+    const char* missing = "/nonexistent.shard";
+    EXPECT_EQ(pho_loader_open(&missing, 1, &config), nullptr);
+    EXPECT_NE(std::string{pho_loader_last_error()}, "");
+}
+
+} // namespace pho::selfplay::tests
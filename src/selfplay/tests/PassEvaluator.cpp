@@ -0,0 +1,142 @@
+#include "gtest/gtest.h"
+
+#include "selfplay/PassEvaluator.hpp"
+
+#include "prim/range.hpp"
+
+#include <algorithm>
+
+namespace pho::selfplay::tests {
+
+using namespace pho::cards;
+
+namespace {
+// A hand with the dangerous spades and a run of low clubs.
+const auto kHand = CardSet::make({
+    Card::cardFor(kSpades, kQueen),
+    Card::cardFor(kSpades, kKing),
+    Card::cardFor(kSpades, kAce),
+    Card::cardFor(kClubs, kTwo),
+    Card::cardFor(kClubs, kThree),
+    Card::cardFor(kClubs, kFour),
+    Card::cardFor(kClubs, kFive),
+    Card::cardFor(kDiamonds, kSix),
+    Card::cardFor(kDiamonds, kNine),
+    Card::cardFor(kDiamonds, kQueen),
+    Card::cardFor(kHearts, kThree),
+    Card::cardFor(kHearts, kSeven),
+    Card::cardFor(kHearts, kKing),
+});
+
+const auto kHighSpades
+    = CardSet::make({Card::cardFor(kSpades, kQueen), Card::cardFor(kSpades, kKing), Card::cardFor(kSpades, kAce)});
+const auto kLowClubs
+    = CardSet::make({Card::cardFor(kClubs, kTwo), Card::cardFor(kClubs, kThree), Card::cardFor(kClubs, kFour)});
+} // namespace
+
+TEST(PassEvaluator, ranks_every_pass)
+{
+    auto config = PassEvalConfig{};
+    config.samples = 20;
+    config.threads = 3;
+    config.seed = 7;
+
+    const auto ranked = evaluatePasses(kHand, config);
+    ASSERT_EQ(ranked.size(), 286u);
+    EXPECT_EQ(ranked.front().delta, 0.0);
+    EXPECT_EQ(ranked.front().deltaHalfWidth, 0.0);
+    for (const auto& value : ranked)
+    {
+        EXPECT_EQ(value.samples, 20u);
+        EXPECT_EQ(value.pass.size(), 3u);
+        EXPECT_EQ(value.pass & kHand, value.pass);
+        EXPECT_GE(value.delta, 0.0);
+    }
+    EXPECT_TRUE(std::is_sorted(ranked.begin(), ranked.end(), [](const auto& a, const auto& b) {
+        return a.delta < b.delta;
+    }));
+
+    // The samples are determined by the seed, not by which worker plays them.
+    config.threads = 1;
+    const auto serial = evaluatePasses(kHand, config);
+    ASSERT_EQ(serial.size(), ranked.size());
+    for (auto i : prim::range(ranked.size()))
+    {
+        EXPECT_EQ(serial[i].pass, ranked[i].pass);
+        EXPECT_EQ(serial[i].mean, ranked[i].mean);
+    }
+}
+
+TEST(PassEvaluator, common_random_numbers_separate_passes)
+{
+    auto config = PassEvalConfig{};
+    config.samples = 400;
+    config.threads = 4;
+    config.candidates = {kLowClubs, kHighSpades};
+
+    const auto ranked = evaluatePasses(kHand, config);
+    ASSERT_EQ(ranked.size(), 2u);
+    EXPECT_EQ(ranked[0].pass, kHighSpades);
+    EXPECT_GT(ranked[1].delta - ranked[1].deltaHalfWidth, 0.0);
+
+    // The paired interval is narrower than the intervals of the means.
+    EXPECT_LT(ranked[1].deltaHalfWidth, ranked[0].halfWidth + ranked[1].halfWidth);
+}
+
+TEST(PassEvaluator, pruning_stops_evaluating_losing_passes)
+{
+    auto config = PassEvalConfig{};
+    config.samples = 60;
+    config.threads = 4;
+    config.pruneBatch = 20;
+
+    const auto ranked = evaluatePasses(kHand, config);
+    ASSERT_EQ(ranked.size(), 286u);
+    EXPECT_EQ(ranked.front().samples, 60u);
+    const auto pruned = std::count_if(ranked.begin(), ranked.end(), [](const auto& v) { return v.samples < 60u; });
+    EXPECT_GT(pruned, 0);
+    for (const auto& value : ranked)
+        EXPECT_TRUE(value.samples == 20u || value.samples == 40u || value.samples == 60u);
+}
+
+TEST(PassEvaluator, rejects_bad_input)
+{
+    auto config = PassEvalConfig{};
+    config.samples = 1;
+    EXPECT_THROW(evaluatePasses(kHighSpades, config), std::invalid_argument);
+
+    config.candidates = {kLowClubs, kHighSpades | kLowClubs};
+    EXPECT_THROW(evaluatePasses(kHand, config), std::invalid_argument);
+
+    config.candidates = {};
+    config.passOffset = 0;
+    EXPECT_THROW(evaluatePasses(kHand, config), std::invalid_argument);
+}
+
+TEST(PassEvaluator, pruned_passes_rank_after_the_best)
+{
+    // With this seed the final best pass did poorly on the early samples, so passes pruned then did better than it
+    // over the samples they share: their delta is negative, yet they must not outrank it.
+    auto config = PassEvalConfig{};
+    config.samples = 40;
+    config.threads = 2;
+    config.pruneBatch = 10;
+    config.z = 1.0;
+    config.seed = 12;
+
+    const auto ranked = evaluatePasses(kHand, config);
+    const auto isPruned = [&](const PassValue& value) { return value.samples < config.samples; };
+    ASSERT_TRUE(std::any_of(ranked.begin(), ranked.end(), [&](const auto& v) { return isPruned(v) && v.delta < 0; }));
+
+    EXPECT_EQ(ranked.front().samples, config.samples);
+    EXPECT_EQ(ranked.front().delta, 0.0);
+    const auto firstPruned = std::find_if(ranked.begin(), ranked.end(), isPruned);
+    EXPECT_TRUE(std::none_of(firstPruned, ranked.end(), [&](const auto& v) { return !isPruned(v); }));
+    const auto byDelta = [](const auto& a, const auto& b) { return a.delta < b.delta; };
+    EXPECT_TRUE(std::is_sorted(ranked.begin(), firstPruned, byDelta));
+    EXPECT_TRUE(std::is_sorted(firstPruned, ranked.end(), byDelta));
+    for (auto it = ranked.begin(); it != firstPruned; ++it)
+        EXPECT_GE(it->delta, 0.0);
+}
+
+} // namespace pho::selfplay::tests
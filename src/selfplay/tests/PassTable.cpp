@@ -0,0 +1,143 @@
+#include "gtest/gtest.h"
+
+#include "selfplay/PassTable.hpp"
+
+#include "cards/Deal.hpp"
+#include "prim/range.hpp"
+#include "prim/tests/scratch.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <fmt/format.h>
+#include <fstream>
+
+namespace pho::selfplay::tests {
+
+using namespace pho::cards;
+namespace fs = std::filesystem;
+using prim::tests::scratchPath;
+
+namespace {
+auto evalConfig(gstate::GameVariant variant) -> PassEvalConfig
+{
+    auto config = PassEvalConfig{};
+    config.variant = variant;
+    config.samples = 4;
+    config.threads = 2;
+    config.seed = 13;
+    return config;
+}
+
+// Random hands, their ranked passes for offset 1, and a table of them written to path.
+struct Fixture
+{
+    std::vector<CardSet> hands;
+    std::vector<std::vector<PassValue>> ranked;
+};
+
+auto writeTable(const std::string& path, gstate::GameVariant variant, unsigned count) -> Fixture
+{
+    const auto rng = math::RandomGenerator{29};
+    auto fixture = Fixture{};
+    auto writer = PassTableWriter{variant, 4, 13};
+    for (auto i : prim::range(count))
+    {
+        (void)i;
+        const auto hand = Deal{Deal::randomDealIndex(rng)}.dealFor(0);
+        fixture.hands.push_back(hand);
+        fixture.ranked.push_back(evaluatePasses(hand, evalConfig(variant)));
+        writer.add(hand, 1, fixture.ranked.back());
+    }
+    EXPECT_EQ(writer.size(), count);
+    writer.write(path);
+    return fixture;
+}
+} // namespace
+
+TEST(PassTable, round_trip)
+{
+    const auto path = scratchPath("round_trip");
+    const auto fixture = writeTable(path, gstate::spades, 3);
+
+    const auto table = PassTable{path, true};
+    EXPECT_EQ(table.size(), 3u);
+    EXPECT_EQ(table.variant(), gstate::spades);
+    EXPECT_EQ(table.header().samples, 4u);
+    for (auto i : prim::range(fixture.hands.size()))
+    {
+        const auto& hand = fixture.hands[i];
+        const auto& ranked = fixture.ranked[i];
+        ASSERT_NE(table.find(hand, 1), nullptr);
+        EXPECT_EQ(table.find(hand, 2), nullptr);
+        EXPECT_EQ(table.bestPass(hand, 1), ranked.front().pass);
+
+        const auto choices = table.choices(hand, 1);
+        ASSERT_EQ(choices.size(), PassTableEntry::kTopPasses);
+        for (auto j : prim::range(choices.size()))
+        {
+            EXPECT_EQ(choices[j].pass, ranked[j].pass);
+            EXPECT_FLOAT_EQ(choices[j].score, float(ranked[j].mean));
+            EXPECT_TRUE(hand.hasCards(choices[j].pass.asBits()));
+        }
+    }
+    fs::remove(path);
+}
+
+TEST(PassTable, shares_entries_across_plain_suits)
+{
+    const auto path = scratchPath("symmetry");
+    const auto fixture = writeTable(path, gstate::spades, 1);
+    const auto table = PassTable{path};
+
+    // Exchanging the plain suits of a Spades hand finds the same entry, with the pass exchanged the same way.
+    const auto permutation = SuitPermutation{{kHearts, kClubs, kSpades, kDiamonds}};
+    const auto hand = permutation(fixture.hands.front());
+    EXPECT_EQ(table.find(hand, 1), table.find(fixture.hands.front(), 1));
+    EXPECT_EQ(table.bestPass(hand, 1), permutation(fixture.ranked.front().front().pass));
+
+    const auto other = Deal{Deal::randomDealIndex(math::RandomGenerator{99})}.dealFor(0);
+    EXPECT_EQ(table.bestPass(other, 1), std::nullopt);
+    EXPECT_TRUE(table.choices(other, 1).empty());
+    fs::remove(path);
+}
+
+TEST(PassTable, rejects_damaged_files)
+{
+    const auto path = scratchPath("damaged");
+    writeTable(path, gstate::standard, 2);
+
+    // Flip a byte of the last entry: the header still reads, but the checksum fails.
+    {
+        auto file = std::fstream{path, std::ios::in | std::ios::out | std::ios::binary};
+        file.seekp(-1, std::ios::end);
+        file.put('\x5a');
+    }
+    EXPECT_NO_THROW(PassTable{path});
+    EXPECT_THROW(PassTable(path, true), std::runtime_error);
+
+    fs::resize_file(path, fs::file_size(path) - 1);
+    EXPECT_THROW(PassTable{path}, std::runtime_error);
+    EXPECT_THROW(PassTable{path + ".missing"}, std::runtime_error);
+    fs::remove(path);
+}
+
+TEST(PassTable, build)
+{
+    auto config = PassTableConfig{};
+    config.path = scratchPath("build");
+    config.hands = 2;
+    config.offsets = {1, 3};
+    config.eval = evalConfig(gstate::standard);
+    config.eval.samples = 2;
+
+    EXPECT_EQ(buildPassTable(config), 4u);
+    const auto table = PassTable{config.path, true};
+    EXPECT_EQ(table.size(), 4u);
+    EXPECT_EQ(table.header().seed, 13u);
+
+    config.eval.candidates = {CardSet{}};
+    EXPECT_THROW(buildPassTable(config), std::invalid_argument);
+    fs::remove(config.path);
+}
+
+} // namespace pho::selfplay::tests
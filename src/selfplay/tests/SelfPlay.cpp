@@ -0,0 +1,116 @@
+#include "gtest/gtest.h"
+
+#include "prim/range.hpp"
+#include "prim/tests/scratch.hpp"
+#include "selfplay/SelfPlay.hpp"
+#include "selfplay/Shard.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <numeric>
+
+namespace pho::selfplay::tests {
+
+namespace fs = std::filesystem;
+using prim::tests::scratchDir;
+
+namespace {
+// Read every record of a shard, calling visit(head, tensor) for each
+template <typename Visitor>
+auto forEachRecord(const std::string& path, Visitor visit)
+{
+    const auto header = readShardHeader(path, true);
+    const auto layout = header.layout();
+
+    FILE* file = std::fopen(path.c_str(), "rb");
+    std::fseek(file, sizeof(ShardHeader), SEEK_SET);
+    auto record = std::vector<std::byte>(layout.recordSize());
+    auto tensor = std::vector<float>(layout.tensorFloats());
+    for (uint64_t i = 0; i < header.count; ++i)
+    {
+        ASSERT_EQ(std::fread(record.data(), record.size(), 1, file), 1u);
+        auto head = RecordHead{};
+        layout.unpack(record.data(), head, tensor.data());
+        visit(head, tensor);
+    }
+    std::fclose(file);
+}
+} // namespace
+
+TEST(SelfPlay, writes_one_record_per_decision)
+{
+    const auto dir = scratchDir("records");
+
+    auto config = SelfPlayConfig{};
+    config.outputPrefix = (dir / "sp").string();
+    config.games = 25;
+    config.threads = 3;
+    config.seed = 42;
+    config.recordsPerShard = 500;
+
+    const auto stats = runSelfPlay(config);
+    EXPECT_EQ(stats.games, 25u);
+    EXPECT_EQ(stats.records, 25u * 52u);
+
+    auto records = uint64_t{};
+    for (const auto& path : stats.shards)
+    {
+        forEachRecord(path, [&](const RecordHead& head, const std::vector<float>& tensor) {
+            ++records;
+            EXPECT_TRUE((head.legal >> head.chosen) & 1u);
+            EXPECT_LT(head.player, 4u);
+            EXPECT_LT(head.playIndex, 52u);
+
+            // The legal plays column of the tensor agrees with the legal mask
+            for (auto c : prim::range(52u))
+                EXPECT_EQ(tensor[c * Schema::kWidth + gstate::min2022::eLegalPlay], float((head.legal >> c) & 1u));
+
+            // Normalized scores are zero-sum
+            EXPECT_NEAR(std::accumulate(head.scores.begin(), head.scores.end(), 0.0), 0.0, 1e-5);
+        });
+    }
+    EXPECT_EQ(records, stats.records);
+
+    fs::remove_all(dir);
+}
+
+TEST(SelfPlay, games_do_not_depend_on_threads)
+{
+    const auto dir = scratchDir("threads");
+
+    // Collect the decisions of all games as comparable tuples, in a canonical order.
+    using Decision = std::tuple<uint64_t, uint8_t, uint8_t, uint8_t, Scores>;
+    auto decisions = [&dir](unsigned threads) {
+        auto config = SelfPlayConfig{};
+        config.outputPrefix = (dir / fmt::format("t{}", threads)).string();
+        config.games = 12;
+        config.threads = threads;
+        config.seed = 7;
+        config.variant = gstate::spades;
+
+        auto result = std::vector<Decision>{};
+        for (const auto& path : runSelfPlay(config).shards)
+        {
+            forEachRecord(path, [&](const RecordHead& head, const std::vector<float>&) {
+                result.emplace_back(head.legal, head.chosen, head.player, head.playIndex, head.scores);
+            });
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    };
+
+    const auto one = decisions(1);
+    EXPECT_EQ(one.size(), 12u * 52u);
+    EXPECT_EQ(decisions(4), one);
+
+    fs::remove_all(dir);
+}
+
+TEST(SelfPlay, rejects_bad_policy_count)
+{
+    auto config = SelfPlayConfig{};
+    config.policies = {gstate::policies::random(), gstate::policies::front()};
+    EXPECT_THROW(runSelfPlay(config), std::invalid_argument);
+}
+
+} // namespace pho::selfplay::tests
@@ -0,0 +1,143 @@
+#include "gtest/gtest.h"
+
+#include "cards/utils.hpp"
+#include "gstate/GState.hpp"
+#include "prim/range.hpp"
+#include "prim/tests/scratch.hpp"
+#include "selfplay/Shard.hpp"
+
+#include <cstring>
+#include <filesystem>
+
+namespace pho::selfplay::tests {
+
+using namespace pho::gstate;
+namespace fs = std::filesystem;
+using prim::tests::scratchDir;
+
+namespace {
+auto recordFor(const RecordLayout& layout, uint8_t i) -> std::vector<std::byte>
+{
+    auto plan = std::vector<ColumnPlan>(layout.width());
+    for (auto col : prim::range(layout.width()))
+        plan[col].ones = uint64_t{i} << col;
+    auto head = RecordHead{};
+    head.chosen = i;
+    auto record = std::vector<std::byte>(layout.recordSize());
+    layout.pack(head, plan.data(), record.data());
+    return record;
+}
+} // namespace
+
+TEST(RecordLayout, sizes)
+{
+    const auto layout = RecordLayout::of<min2022::Schema>();
+    EXPECT_EQ(layout.width(), 12u);
+    EXPECT_EQ(layout.scaledColumns(), 0b11110u);
+    EXPECT_EQ(layout.recordSize(), 32u + 12u * 8u + 4u * (8u + 16u));
+    EXPECT_EQ(layout.tensorFloats(), 12u * 52u);
+}
+
+TEST(RecordLayout, round_trip_is_bit_exact)
+{
+    using Schema = min2022::Schema;
+    const auto layout = RecordLayout::of<Schema>();
+    auto record = std::vector<std::byte>(layout.recordSize());
+
+    for (auto i : prim::range(20))
+    {
+        GState state{GState::Init{Deal::randomDealIndex(), PassOffset(i % 4)}};
+        if (state.passOffset() != 0)
+        {
+            for (auto p : prim::range(kNumPlayers))
+                state.setPassFor(p, chooseThreeAtRandom(state.playersHand(p)));
+        }
+        state.startGame();
+        while (!state.done())
+        {
+            auto expected = std::array<float, Schema::kFloats>{};
+            const auto plan = Schema::plan(state);
+            Schema::expand(plan, expected.data());
+
+            auto head = RecordHead{};
+            head.playIndex = uint8_t(state.playIndex());
+            layout.pack(head, plan.data(), record.data());
+
+            auto actual = std::array<float, Schema::kFloats>{};
+            auto unpacked = RecordHead{};
+            layout.unpack(record.data(), unpacked, actual.data());
+
+            EXPECT_EQ(unpacked.playIndex, state.playIndex());
+            ASSERT_EQ(0, std::memcmp(expected.data(), actual.data(), sizeof(expected)));
+
+            state.playCard(aCardAtRandom(state.legalPlays()));
+        }
+    }
+}
+
+TEST(ShardWriter, rolls_over_and_seals)
+{
+    const auto dir = scratchDir("rollover");
+    const auto layout = RecordLayout{3, 0b010};
+
+    auto paths = std::vector<std::string>{};
+    {
+        auto writer = ShardWriter{(dir / "t").string(), layout, 4};
+        for (auto i : prim::range(10))
+            writer.append(recordFor(layout, uint8_t(i)).data());
+        EXPECT_EQ(writer.recordsWritten(), 10u);
+        paths = writer.paths();
+    } // the destructor seals the last, partial shard
+
+    ASSERT_EQ(paths.size(), 3u);
+    EXPECT_EQ(paths[0], (dir / "t-000000.shard").string());
+
+    const auto counts = std::array<uint64_t, 3>{4, 4, 2};
+    for (auto i : prim::range(3))
+    {
+        const auto header = readShardHeader(paths[i], true);
+        EXPECT_EQ(header.count, counts[i]);
+        EXPECT_EQ(header.capacity, 4u);
+        EXPECT_EQ(header.layout(), layout);
+        EXPECT_EQ(fs::file_size(paths[i]), sizeof(ShardHeader) + counts[i] * layout.recordSize());
+    }
+
+    fs::remove_all(dir);
+}
+
+TEST(ShardWriter, detects_corruption)
+{
+    const auto dir = scratchDir("corruption");
+    const auto layout = RecordLayout{2, 0};
+
+    auto path = std::string{};
+    {
+        auto writer = ShardWriter{(dir / "t").string(), layout, 100};
+        for (auto i : prim::range(5))
+            writer.append(recordFor(layout, uint8_t(i)).data());
+        writer.close();
+        path = writer.paths().at(0);
+    }
+    EXPECT_NO_THROW(readShardHeader(path, true));
+
+    // Flip one byte in the last record
+    {
+        FILE* file = std::fopen(path.c_str(), "r+b");
+        ASSERT_NE(file, nullptr);
+        std::fseek(file, -1, SEEK_END);
+        const int c = std::fgetc(file);
+        std::fseek(file, -1, SEEK_END);
+        std::fputc(c ^ 0x40, file);
+        std::fclose(file);
+    }
+    EXPECT_NO_THROW(readShardHeader(path, false));
+    EXPECT_THROW(readShardHeader(path, true), std::runtime_error);
+
+    // Truncate the file
+    fs::resize_file(path, fs::file_size(path) - 1);
+    EXPECT_THROW(readShardHeader(path, false), std::runtime_error);
+
+    fs::remove_all(dir);
+}
+
+} // namespace pho::selfplay::tests
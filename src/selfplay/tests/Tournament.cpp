@@ -0,0 +1,221 @@
+#include "gtest/gtest.h"
+
+#include "selfplay/Tournament.hpp"
+
+#include "prim/tests/scratch.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fmt/format.h>
+
+namespace pho::selfplay::tests {
+
+namespace fs = std::filesystem;
+using prim::tests::scratchPath;
+using gstate::ScoreResult;
+
+namespace {
+auto smallConfig(ScoreResult::ScoreType mode) -> TournamentConfig
+{
+    auto config = TournamentConfig{};
+    config.agents = {"front", "random"};
+    config.deals = 48;
+    config.threads = 2;
+    config.seed = 17;
+    config.mode = mode;
+    config.batch = 16;
+    return config;
+}
+
+auto expectSameResults(const TournamentResult& a, const TournamentResult& b)
+{
+    ASSERT_EQ(a.pairings.size(), b.pairings.size());
+    EXPECT_EQ(a.deals, b.deals);
+    for (size_t i = 0; i < a.pairings.size(); ++i)
+    {
+        const auto x = a.pairings[i].score.totals();
+        const auto y = b.pairings[i].score.totals();
+        EXPECT_EQ(x.winPts, y.winPts);
+        EXPECT_EQ(x.zms, y.zms);
+        EXPECT_EQ(x.count, y.count);
+        EXPECT_EQ(a.pairings[i].duplicate.size(), b.pairings[i].duplicate.size());
+        EXPECT_EQ(a.pairings[i].duplicate.mean(), b.pairings[i].duplicate.mean());
+        EXPECT_EQ(a.pairings[i].duplicate.variance(), b.pairings[i].duplicate.variance());
+    }
+}
+} // namespace
+
+TEST(Tournament, plays_every_pairing_in_every_rotation)
+{
+    auto config = smallConfig(ScoreResult::eSolo);
+    config.agents = {"front", "back", "random"};
+    const auto solo = runTournament(config);
+    ASSERT_EQ(solo.pairings.size(), 6u);
+    for (const auto& pairing : solo.pairings)
+    {
+        EXPECT_NE(pairing.hero, pairing.opponent);
+        EXPECT_EQ(pairing.score.count(), 4 * config.deals);
+        EXPECT_EQ(pairing.duplicate.size(), config.deals);
+    }
+    EXPECT_EQ(solo.agentScore(0).count(), 2 * 4 * config.deals);
+
+    config.mode = ScoreResult::eTeam;
+    const auto team = runTournament(config);
+    ASSERT_EQ(team.pairings.size(), 3u);
+    for (const auto& pairing : team.pairings)
+    {
+        EXPECT_LT(pairing.hero, pairing.opponent);
+        EXPECT_EQ(pairing.score.count(), 2 * config.deals);
+    }
+}
+
+TEST(Tournament, duplicate_deals_cancel_the_cards)
+{
+    // An agent against a copy of itself plays the same games in every rotation, so its score is exactly average, up
+    // to the rounding of the single precision scores.
+    for (auto mode : {ScoreResult::eSolo, ScoreResult::eTeam})
+    {
+        auto config = smallConfig(mode);
+        config.agents = {"front", "front"};
+        const auto result = runTournament(config);
+        for (const auto& pairing : result.pairings)
+        {
+            EXPECT_NEAR(pairing.score.scoreDelta(), 0.0, 1e-6);
+            EXPECT_NEAR(pairing.duplicate.maximum(), 0.0, 1e-6);
+            EXPECT_NEAR(pairing.duplicate.minimum(), 0.0, 1e-6);
+        }
+    }
+}
+
+TEST(Tournament, does_not_depend_on_the_threads)
+{
+    auto config = smallConfig(ScoreResult::eSolo);
+    config.threads = 1;
+    const auto one = runTournament(config);
+    config.threads = 3;
+    config.batch = 5;
+    const auto three = runTournament(config);
+    expectSameResults(one, three);
+}
+
+TEST(Tournament, resumes_from_a_checkpoint)
+{
+    const auto path = scratchPath("resume");
+    auto config = smallConfig(ScoreResult::eSolo);
+    const auto fresh = runTournament(config);
+
+    config.checkpoint = path;
+    config.deals = 24;
+    const auto first = runTournament(config);
+    EXPECT_EQ(first.resumedFrom, 0u);
+    EXPECT_EQ(first.deals, 24u);
+
+    config.deals = 48;
+    const auto resumed = runTournament(config);
+    EXPECT_EQ(resumed.resumedFrom, 24u);
+    expectSameResults(fresh, resumed);
+
+    // Already done: nothing is played.
+    const auto again = runTournament(config);
+    EXPECT_EQ(again.resumedFrom, 48u);
+    expectSameResults(fresh, again);
+    fs::remove(path);
+}
+
+TEST(Tournament, rejects_a_foreign_or_damaged_checkpoint)
+{
+    const auto path = scratchPath("foreign");
+    auto config = smallConfig(ScoreResult::eSolo);
+    config.checkpoint = path;
+    config.deals = 16;
+    runTournament(config);
+
+    auto other = config;
+    other.seed = config.seed + 1;
+    EXPECT_THROW(runTournament(other), std::runtime_error);
+    other = config;
+    other.agents = {"front", "back"};
+    EXPECT_THROW(runTournament(other), std::runtime_error);
+
+    fs::resize_file(path, fs::file_size(path) - 1);
+    EXPECT_THROW(runTournament(config), std::runtime_error);
+
+    FILE* file = std::fopen(path.c_str(), "wb");
+    std::fputs("not a checkpoint", file);
+    std::fclose(file);
+    EXPECT_THROW(runTournament(config), std::runtime_error);
+    fs::remove(path);
+}
+
+TEST(Tournament, rejects_bad_configurations)
+{
+    auto config = smallConfig(ScoreResult::eSolo);
+    config.agents = {"front"};
+    EXPECT_THROW(runTournament(config), std::invalid_argument);
+    config.agents = {"front", "no-such-policy"};
+    EXPECT_THROW(runTournament(config), std::invalid_argument);
+    config = smallConfig(ScoreResult::eUnknown);
+    EXPECT_THROW(runTournament(config), std::invalid_argument);
+    config = smallConfig(ScoreResult::eSolo);
+    config.batch = 0;
+    EXPECT_THROW(runTournament(config), std::invalid_argument);
+}
+
+TEST(Tournament, stops_once_the_sprt_decides)
+{
+    const auto path = scratchPath("sprt");
+    auto config = smallConfig(ScoreResult::eSolo);
+    config.agents = {"back", "front"};
+    config.deals = 20000;
+    config.sprt = gstate::SprtConfig{0.0, 50.0, 0.05, 0.05};
+    const auto result = runTournament(config);
+    EXPECT_TRUE(result.stoppedEarly);
+    EXPECT_LT(result.deals, config.deals);
+    EXPECT_EQ(result.deals % config.batch, 0u);
+    ASSERT_EQ(result.pairings.size(), 2u);
+
+    // back beats front by far more than 50 Elo (see the summary of a fixed-length run).
+    const auto& backVsFront = result.pairings[0];
+    const auto& frontVsBack = result.pairings[1];
+    EXPECT_EQ(backVsFront.decision, gstate::Sprt::eAcceptH1);
+    EXPECT_EQ(frontVsBack.decision, gstate::Sprt::eAcceptH0);
+    EXPECT_EQ(std::max(backVsFront.decidedAt, frontVsBack.decidedAt), result.deals);
+    EXPECT_EQ(backVsFront.duplicateElo.size(), result.deals);
+    const auto [low, high] = backVsFront.eloInterval();
+    EXPECT_LT(low, backVsFront.score.eloDelta());
+    EXPECT_GT(high, backVsFront.score.eloDelta());
+
+    // A resumed run makes the same decisions, and a finished one plays nothing more.
+    config.checkpoint = path;
+    config.deals = result.deals / 2;
+    runTournament(config);
+    config.deals = 20000;
+    const auto resumed = runTournament(config);
+    EXPECT_TRUE(resumed.stoppedEarly);
+    expectSameResults(result, resumed);
+    EXPECT_EQ(resumed.pairings[0].decidedAt, backVsFront.decidedAt);
+    EXPECT_EQ(resumed.pairings[1].decidedAt, frontVsBack.decidedAt);
+    EXPECT_EQ(runTournament(config).resumedFrom, result.deals);
+
+    // The test is part of what the checkpoint belongs to.
+    config.sprt->elo1 = 40.0;
+    EXPECT_THROW(runTournament(config), std::runtime_error);
+    config.sprt->alpha = 0.0;
+    EXPECT_THROW(runTournament(config), std::invalid_argument);
+    fs::remove(path);
+
+    EXPECT_NE(formatSummary(result).find("stopped early"), std::string::npos);
+}
+
+TEST(Tournament, summarizes_the_results)
+{
+    auto config = smallConfig(ScoreResult::eSolo);
+    config.deals = 8;
+    const auto summary = formatSummary(runTournament(config));
+    EXPECT_NE(summary.find("front vs random"), std::string::npos);
+    EXPECT_NE(summary.find("random vs front"), std::string::npos);
+    EXPECT_NE(summary.find("elo"), std::string::npos);
+}
+
+} // namespace pho::selfplay::tests
@@ -0,0 +1,135 @@
+// tournament: play agents against each other on duplicate deals, on all cores, and print the results.
+//
+// Usage: tournament --agents=NAME,NAME[,NAME...] [--deals=N] [--threads=N] [--seed=N]
+//                   [--variant=standard|jack|spades] [--mode=solo|team] [--no-passing]
+//                   [--checkpoint=FILE] [--batch=N] [--summary=FILE] [--sprt=ELO0,ELO1 [--alpha=P] [--beta=P]]
+//
+// With --checkpoint the run saves its results after every batch of deals; running the same command again resumes an
+// interrupted run, and a larger --deals extends a finished one.
+//
+// With --sprt every pairing is tested for H0: its Elo delta is ELO0 against H1: it is ELO1, and the run stops as soon
+// as every pairing has a decision, so --deals becomes a limit.
+
+#include "gstate/Policy.hpp"
+#include "prim/split.hpp"
+#include "selfplay/Tournament.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <fmt/format.h>
+#include <stdexcept>
+#include <tuple>
+
+using namespace pho;
+
+namespace {
+
+auto parseMode(const std::string& name) -> gstate::ScoreResult::ScoreType
+{
+    if (name == "solo")
+        return gstate::ScoreResult::eSolo;
+    if (name == "team")
+        return gstate::ScoreResult::eTeam;
+    throw std::invalid_argument(fmt::format("Unrecognized mode: {}", name));
+}
+
+struct Args
+{
+    selfplay::TournamentConfig config;
+    std::string summaryPath;
+};
+
+auto parseHypotheses(const std::string& value) -> std::pair<double, double>
+{
+    const auto elos = split(value, ',');
+    if (elos.size() != 2)
+        throw std::invalid_argument(fmt::format("--sprt needs two Elo deltas, not {}", value));
+    return {std::stod(elos[0]), std::stod(elos[1])};
+}
+
+auto parseArgs(int argc, char* argv[]) -> Args
+{
+    auto args = Args{};
+    auto& config = args.config;
+    auto sprt = gstate::SprtConfig{};
+    auto sequential = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        const auto arg = std::string{argv[i]};
+        const auto eq = arg.find('=');
+        const auto key = arg.substr(0, eq);
+        const auto value = eq == std::string::npos ? std::string{} : arg.substr(eq + 1);
+
+        if (key == "--agents")
+            config.agents = split(value, ',');
+        else if (key == "--deals")
+            config.deals = std::stoull(value);
+        else if (key == "--threads")
+            config.threads = unsigned(std::stoul(value));
+        else if (key == "--seed")
+            config.seed = std::stoull(value);
+        else if (key == "--variant")
+            config.variant = gstate::namedVariant(value);
+        else if (key == "--mode")
+            config.mode = parseMode(value);
+        else if (key == "--no-passing")
+            config.passing = false;
+        else if (key == "--checkpoint")
+            config.checkpoint = value;
+        else if (key == "--batch")
+            config.batch = std::stoull(value);
+        else if (key == "--summary")
+            args.summaryPath = value;
+        else if (key == "--sprt")
+        {
+            std::tie(sprt.elo0, sprt.elo1) = parseHypotheses(value);
+            sequential = true;
+        }
+        else if (key == "--alpha")
+            sprt.alpha = std::stod(value);
+        else if (key == "--beta")
+            sprt.beta = std::stod(value);
+        else
+            throw std::invalid_argument(fmt::format("Unrecognized argument: {}", arg));
+    }
+    if (config.agents.empty())
+        throw std::invalid_argument("--agents=NAME,NAME is required");
+    if (sequential)
+        config.sprt = sprt;
+    return args;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        const auto args = parseArgs(argc, argv);
+
+        const auto start = std::chrono::steady_clock::now();
+        const auto result = selfplay::runTournament(args.config);
+        const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        const auto summary = selfplay::formatSummary(result);
+        fmt::print("{}\n", summary);
+        fmt::print("deals: {} (resumed from {}) seconds: {:.2f} deals/sec: {:.0f}\n", result.deals, result.resumedFrom,
+            seconds, (result.deals - result.resumedFrom) / seconds);
+
+        if (!args.summaryPath.empty())
+        {
+            FILE* file = std::fopen(args.summaryPath.c_str(), "w");
+            if (!file)
+                throw std::runtime_error(fmt::format("Cannot create {}", args.summaryPath));
+            const auto written = std::fwrite(summary.data(), 1, summary.size(), file);
+            if (std::fclose(file) != 0 || written != summary.size())
+                throw std::runtime_error(fmt::format("Write to {} failed", args.summaryPath));
+        }
+        return 0;
+    }
+    catch (const std::exception& e)
+    {
+        fmt::print(stderr, "tournament: {}\n", e.what());
+        return 1;
+    }
+}
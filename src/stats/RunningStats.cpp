@@ -19,6 +19,18 @@ RunningStats::RunningStats()
 , mMax{std::numeric_limits<double>::lowest()}
 { }
 
+RunningStats::RunningStats(const Moments& moments)
+: N{moments.n}
+, M1{moments.m1}
+, M2{moments.m2}
+, M3{moments.m3}
+, M4{moments.m4}
+, mMin{moments.min}
+, mMax{moments.max}
+{ }
+
+RunningStats::Moments RunningStats::moments() const { return Moments{N, M1, M2, M3, M4, mMin, mMax}; }
+
 void RunningStats::clear() { *this = RunningStats{}; }
 
 void RunningStats::accumulate(double x)
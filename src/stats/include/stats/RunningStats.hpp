@@ -20,6 +20,17 @@ public:
     RunningStats(RunningStats&&) = default;
     RunningStats& operator=(RunningStats&&) = default;
 
+    // The accumulated state, for saving a RunningStats (e.g. in a checkpoint) and restoring it exactly.
+    struct Moments
+    {
+        uint64_t n;
+        double m1, m2, m3, m4;
+        double min, max;
+    };
+
+    explicit RunningStats(const Moments& moments);
+    Moments moments() const;
+
     void clear();
     void accumulate(double x);
     void operator+=(double x) { accumulate(x); }